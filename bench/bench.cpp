@@ -0,0 +1,1228 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bench.h"
+#include "bench_report.h"
+
+#include "../src/application.h"
+#include "../src/brep_utils.h"
+#include "../src/caf_utils.h"
+#include "../src/document.h"
+#include "../src/gpx_brep_owner_index.h"
+#include "../src/gpx_xde_document_item.h"
+#include "../src/libtree.h"
+#include "../src/mesh_item.h"
+#include "../src/mesh_utils.h"
+#include "../src/options.h"
+#include "../src/xde_document_item.h"
+#include "../src/xde_part_index.h"
+#include "../src/fougtools/qttools/task/manager.h"
+#include "../src/fougtools/qttools/task/runner_current_thread.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QtDebug>
+
+#include <AIS_InteractiveContext.hxx>
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <OpenGl_GraphicDriver.hxx>
+#include <Poly_Triangulation.hxx>
+#include <StdSelect_BRepOwner.hxx>
+#include <TopoDS_Compound.hxx>
+#include <V3d_Viewer.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <XCAFPrs_AISObject.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#  include <unistd.h>
+#endif
+
+namespace Mayo {
+
+namespace Internal {
+
+// Input files are taken from the directory pointed to by environment variable
+// 'envVarDir'
+static QStringList benchFiles(const char* envVarDir, const QStringList& nameFilters)
+{
+    const QString dirPath = QString::fromLocal8Bit(qgetenv(envVarDir));
+    QStringList listFilePath;
+    if (!dirPath.isEmpty()) {
+        const QDir dir(dirPath);
+        for (const QString& fileName : dir.entryList(nameFilters, QDir::Files))
+            listFilePath.push_back(dir.absoluteFilePath(fileName));
+    }
+    return listFilePath;
+}
+
+static QStringList benchStepFiles()
+{
+    return benchFiles("MAYO_BENCH_STEP_DIR", { "*.step", "*.stp", "*.STEP", "*.STP" });
+}
+
+static QStringList benchStlFiles()
+{
+    return benchFiles("MAYO_BENCH_STL_DIR", { "*.stl", "*.STL" });
+}
+
+// Imports all files into a temporary document, 'threadCount' workers pick the
+// next file to be imported from a shared index
+static void importFiles(
+        const QStringList& listFilePath,
+        const Application::ImportOptions& options,
+        int threadCount)
+{
+    Application* app = Application::instance();
+    Document* doc = app->createDocument();
+    app->addDocument(doc);
+    std::atomic<int> fileIndex(0);
+    std::vector<std::thread> vecThread;
+    for (int i = 0; i < threadCount; ++i) {
+        vecThread.emplace_back([&]{
+            int id = fileIndex.fetch_add(1);
+            while (id < listFilePath.size()) {
+                const QString& filepath = listFilePath.at(id);
+                const Application::IoResult result =
+                        app->importInDocument(
+                            doc, Application::PartFormat::Step, filepath, options);
+                if (!result.ok)
+                    qWarning() << filepath << result.errorText;
+                id = fileIndex.fetch_add(1);
+            }
+        });
+    }
+    for (std::thread& thread : vecThread)
+        thread.join();
+    app->eraseDocument(doc);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+struct StlImportConfig {
+    const char* name;
+    Options::StlIoLibrary lib;
+    double weldTolerance;
+};
+
+static std::vector<StlImportConfig> stlImportConfigs()
+{
+    return {
+#ifdef HAVE_GMIO
+        { "gmio", Options::StlIoLibrary::Gmio, 0. },
+#endif
+        { "OpenCascade", Options::StlIoLibrary::OpenCascade, 0. },
+        { "native exact weld", Options::StlIoLibrary::Native, 0. },
+        { "native epsilon weld", Options::StlIoLibrary::Native, 1e-4 }
+    };
+}
+
+// UV sphere made of about 'triangleCount' triangles, outward oriented
+static Handle_Poly_Triangulation createSphereMesh(int triangleCount)
+{
+    const int segmentCount = std::max(3, qRound(std::sqrt(triangleCount / 2.)));
+    const int ringCount = segmentCount; // Rings of nodes between poles
+    const int nodeCount = 2 + ringCount * segmentCount;
+    const int facetCount = 2 * segmentCount * ringCount;
+    const double radius = 100.;
+    const double pi = std::acos(-1.);
+    Handle_Poly_Triangulation mesh =
+            new Poly_Triangulation(nodeCount, facetCount, Standard_False);
+    TColgp_Array1OfPnt& nodes = mesh->ChangeNodes();
+    Poly_Array1OfTriangle& triangles = mesh->ChangeTriangles();
+    const int northPole = 1;
+    const int southPole = nodeCount;
+    nodes.ChangeValue(northPole).SetCoord(0, 0, radius);
+    nodes.ChangeValue(southPole).SetCoord(0, 0, -radius);
+    auto fnNodeId = [=](int ring, int segment) {
+        return 2 + ring * segmentCount + (segment % segmentCount);
+    };
+    for (int r = 0; r < ringCount; ++r) {
+        const double theta = pi * (r + 1) / (ringCount + 1);
+        for (int s = 0; s < segmentCount; ++s) {
+            const double phi = 2 * pi * s / segmentCount;
+            nodes.ChangeValue(fnNodeId(r, s)).SetCoord(
+                        radius * std::sin(theta) * std::cos(phi),
+                        radius * std::sin(theta) * std::sin(phi),
+                        radius * std::cos(theta));
+        }
+    }
+
+    int triId = 1;
+    for (int s = 0; s < segmentCount; ++s) {
+        triangles.ChangeValue(triId++).Set(northPole, fnNodeId(0, s), fnNodeId(0, s + 1));
+        for (int r = 0; r + 1 < ringCount; ++r) {
+            triangles.ChangeValue(triId++).Set(
+                        fnNodeId(r, s), fnNodeId(r + 1, s), fnNodeId(r + 1, s + 1));
+            triangles.ChangeValue(triId++).Set(
+                        fnNodeId(r, s), fnNodeId(r + 1, s + 1), fnNodeId(r, s + 1));
+        }
+        triangles.ChangeValue(triId++).Set(
+                    southPole, fnNodeId(ringCount - 1, s + 1), fnNodeId(ringCount - 1, s));
+    }
+    return mesh;
+}
+
+// Compound of 'faceCount' distinct planar faces laid out on a grid, stands
+// for the root node of a large assembly
+static TopoDS_Shape createFaceGridShape(int faceCount)
+{
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    const int gridSize = static_cast<int>(std::ceil(std::sqrt(faceCount)));
+    for (int i = 0; i < faceCount; ++i) {
+        const gp_Pln plane(gp_Pnt(i % gridSize, i / gridSize, 0.), gp::DZ());
+        builder.Add(compound, BRepBuilderAPI_MakeFace(plane, 0., 1., 0., 1.).Face());
+    }
+    return compound;
+}
+
+// -- Synthetic workloads
+// Inputs are generated on first use in a temporary directory, they are the
+// same from one run to another so results can be compared across releases
+
+enum class WorkloadKind {
+    Sphere,  // Tessellated sphere, exported as STL
+    Assembly // Multi-instance XDE assembly, exported as STEP/IGES/BREP
+};
+
+struct SyntheticWorkload {
+    const char* name;
+    WorkloadKind kind;
+    int triangleCount; // Sphere only
+    int depth; // Assembly only, count of assembly levels
+    int childCount; // Assembly only, count of instances per level
+};
+
+static const std::vector<SyntheticWorkload>& syntheticWorkloads()
+{
+    static const std::vector<SyntheticWorkload> vecWorkload = {
+        { "sphere_10k", WorkloadKind::Sphere, 10000, 0, 0 },
+        { "sphere_100k", WorkloadKind::Sphere, 100000, 0, 0 },
+        { "sphere_1M", WorkloadKind::Sphere, 1000000, 0, 0 },
+        { "assembly_4x4", WorkloadKind::Assembly, 0, 4, 4 },
+        { "assembly_8x2", WorkloadKind::Assembly, 0, 8, 2 },
+        { "assembly_5x5", WorkloadKind::Assembly, 0, 5, 5 }
+    };
+    return vecWorkload;
+}
+
+struct WorkloadFormat {
+    const char* name;
+    Application::PartFormat partFormat;
+    bool isStlAscii;
+    const char* fileSuffix;
+};
+
+static const std::vector<WorkloadFormat>& workloadFormats()
+{
+    static const std::vector<WorkloadFormat> vecFormat = {
+        { "STEP", Application::PartFormat::Step, false, "step" },
+        { "IGES", Application::PartFormat::Iges, false, "igs" },
+        { "BREP", Application::PartFormat::OccBrep, false, "brep" },
+        { "STL binary", Application::PartFormat::Stl, false, "stl" },
+        { "STL ASCII", Application::PartFormat::Stl, true, "ascii.stl" }
+    };
+    return vecFormat;
+}
+
+static bool isFormatApplicable(const SyntheticWorkload& workload, const WorkloadFormat& format)
+{
+    const bool isStl = format.partFormat == Application::PartFormat::Stl;
+    return workload.kind == WorkloadKind::Sphere ? isStl : !isStl;
+}
+
+// Adds rows(workloadId, formatId) for all the applicable combinations
+static void addSyntheticWorkloadRows()
+{
+    QTest::addColumn<int>("workloadId");
+    QTest::addColumn<int>("formatId");
+    for (size_t i = 0; i < syntheticWorkloads().size(); ++i) {
+        const SyntheticWorkload& workload = syntheticWorkloads().at(i);
+        for (size_t j = 0; j < workloadFormats().size(); ++j) {
+            const WorkloadFormat& format = workloadFormats().at(j);
+            if (isFormatApplicable(workload, format)) {
+                const QString rowName = QString("%1, %2").arg(workload.name, format.name);
+                QTest::newRow(qPrintable(rowName))
+                        << static_cast<int>(i) << static_cast<int>(j);
+            }
+        }
+    }
+}
+
+static Application::ExportOptions workloadExportOptions(const WorkloadFormat& format)
+{
+    Application::ExportOptions options;
+#ifdef HAVE_GMIO
+    options.stlFormat =
+            format.isStlAscii ? GMIO_STL_FORMAT_ASCII : GMIO_STL_FORMAT_BINARY_LE;
+#else
+    options.stlFormat =
+            format.isStlAscii ?
+                Application::ExportOptions::StlFormat::Ascii :
+                Application::ExportOptions::StlFormat::Binary;
+#endif
+    return options;
+}
+
+// Assembly of 'depth' levels, each level made of 'childCount' instances of
+// the level below. Leaves are instances of one shape of size 10, so the count
+// of leaf instances is childCount^depth while the document holds depth+1 shapes
+static Handle_TDocStd_Document createAssemblyDocument(
+        int depth, int childCount, const TopoDS_Shape& leafShape)
+{
+    Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
+    const Handle_XCAFDoc_ShapeTool shapeTool =
+            XCAFDoc_DocumentTool::ShapeTool(cafDoc->Main());
+    TDF_Label labelChild = shapeTool->AddShape(leafShape, false);
+    double childSize = 10.;
+    for (int level = 0; level < depth; ++level) {
+        const TDF_Label labelAssembly = shapeTool->NewShape();
+        for (int i = 0; i < childCount; ++i) {
+            gp_Trsf trsf;
+            const double offset = i * 1.5 * childSize;
+            trsf.SetTranslation(level % 2 == 0 ? gp_Vec(offset, 0, 0) : gp_Vec(0, offset, 0));
+            shapeTool->AddComponent(labelAssembly, labelChild, TopLoc_Location(trsf));
+        }
+
+        labelChild = labelAssembly;
+        childSize *= 1.5 * childCount;
+    }
+
+    shapeTool->UpdateAssemblies();
+    return cafDoc;
+}
+
+static Handle_TDocStd_Document createAssemblyDocument(int depth, int childCount)
+{
+    return createAssemblyDocument(
+                depth, childCount, BRepPrimAPI_MakeBox(10., 10., 10.).Shape());
+}
+
+// Assembly of 'copyCount' components, each one referring to its own copy of
+// 'partShape' as done by files embedding the same part several times
+// Box with two bumps placed on opposite faces, point symmetric : its mirror
+// image has the same bounds, centroid, area and volume
+static TopoDS_Shape createChiralShape()
+{
+    TopoDS_Compound cmpd;
+    BRep_Builder builder;
+    builder.MakeCompound(cmpd);
+    builder.Add(cmpd, BRepPrimAPI_MakeBox(gp_Pnt(-10, -10, -10), 20, 20, 20).Shape());
+    builder.Add(cmpd, BRepPrimAPI_MakeBox(gp_Pnt(10, 2, -2), 2, 4, 4).Shape());
+    builder.Add(cmpd, BRepPrimAPI_MakeBox(gp_Pnt(-12, -6, -2), 2, 4, 4).Shape());
+    return cmpd;
+}
+
+static Handle_TDocStd_Document createPartCopiesDocument(
+        int copyCount, const TopoDS_Shape& partShape)
+{
+    Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
+    const Handle_XCAFDoc_ShapeTool shapeTool =
+            XCAFDoc_DocumentTool::ShapeTool(cafDoc->Main());
+    const TDF_Label labelAssembly = shapeTool->NewShape();
+    for (int i = 0; i < copyCount; ++i) {
+        const TopoDS_Shape copy = BRepBuilderAPI_Copy(partShape).Shape();
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(i * 15., 0, 0));
+        shapeTool->AddComponent(
+                    labelAssembly, shapeTool->AddShape(copy, false), TopLoc_Location(trsf));
+    }
+
+    shapeTool->UpdateAssemblies();
+    return cafDoc;
+}
+
+static std::unique_ptr<DocumentItem> createWorkloadItem(const SyntheticWorkload& workload)
+{
+    if (workload.kind == WorkloadKind::Sphere) {
+        auto meshItem = new MeshItem;
+        meshItem->setTriangulation(createSphereMesh(workload.triangleCount));
+        return std::unique_ptr<DocumentItem>(meshItem);
+    }
+
+    return std::unique_ptr<DocumentItem>(
+                new XdeDocumentItem(
+                    createAssemblyDocument(workload.depth, workload.childCount)));
+}
+
+static const QTemporaryDir& workloadDir()
+{
+    static const QTemporaryDir dir;
+    return dir;
+}
+
+// Path of the file of 'workload' in 'format', generated if not done yet.
+// Returns an empty string on error
+static QString syntheticWorkloadFile(
+        const SyntheticWorkload& workload, const WorkloadFormat& format)
+{
+    const QString filepath =
+            workloadDir().filePath(QString("%1.%2").arg(workload.name, format.fileSuffix));
+    if (!QFileInfo::exists(filepath)) {
+        const std::unique_ptr<DocumentItem> item = createWorkloadItem(workload);
+        const Application::IoResult result =
+                Application::instance()->exportDocumentItems(
+                    { item.get() },
+                    format.partFormat,
+                    workloadExportOptions(format),
+                    filepath);
+        if (!result.ok) {
+            qWarning() << filepath << result.errorText;
+            return QString();
+        }
+    }
+
+    return filepath;
+}
+
+// Former XdeDocumentItem::shapeAbsoluteLocation(), kept as reference : walks
+// up to the root node with one location lookup per level
+static TopLoc_Location shapeAbsoluteLocationWalkUp(
+        const XdeDocumentItem& xdeItem, XdeDocumentItem::AssemblyNodeId nodeId)
+{
+    TopLoc_Location absoluteLoc;
+    const Tree<TDF_Label>& asmTree = xdeItem.assemblyTree();
+    for (TreeNodeId it = nodeId; it != 0; it = asmTree.nodeParent(it))
+        absoluteLoc = xdeItem.shapeReferenceLocation(asmTree.nodeData(it)) * absoluteLoc;
+    return absoluteLoc;
+}
+
+static bool isTrsfEqual(const gp_Trsf& lhs, const gp_Trsf& rhs)
+{
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 4; ++col) {
+            if (std::abs(lhs.Value(row, col) - rhs.Value(row, col)) > 1e-9)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Former owner lookup of GuiDocument, kept as reference
+static Handle_SelectMgr_EntityOwner findBRepOwnerLinear(
+        const std::vector<Handle_SelectMgr_EntityOwner>& vecOwner,
+        const TopoDS_Face& face)
+{
+    auto itFound = std::find_if(
+                vecOwner.cbegin(),
+                vecOwner.cend(),
+                [=](const Handle_SelectMgr_EntityOwner& owner) {
+        auto brepOwner = Handle_StdSelect_BRepOwner::DownCast(owner);
+        return !brepOwner.IsNull() ? brepOwner->Shape() == face : false;
+    });
+    return itFound != vecOwner.cend() ? *itFound : Handle_SelectMgr_EntityOwner();
+}
+
+enum class TreeTraversal {
+    Recursive,
+    PreOrder,
+    PostOrder,
+    Parallel
+};
+
+// Tree of 1 111 111 nodes : depth 6 with 10 children per node, node data is
+// the depth
+static const Tree<int>& libTreeOneMillion()
+{
+    static Tree<int> tree;
+    if (tree.roots().empty()) {
+        tree.appendSubtree(0, 0, [](int depth) {
+            return depth < 6 ? std::vector<int>(10, depth + 1) : std::vector<int>();
+        });
+    }
+    return tree;
+}
+
+// Former recursive traversal of deepForeachTreeNode(), kept as reference
+template<typename FUNC>
+static void deepForeachTreeNodeRecursive(TreeNodeId node, const Tree<int>& tree, const FUNC& func)
+{
+    func(node);
+    for (TreeNodeId it = tree.nodeChildFirst(node); it != 0; it = tree.nodeSiblingNext(it))
+        deepForeachTreeNodeRecursive(it, tree, func);
+}
+
+// Resident memory of the process, only available on Linux(zero otherwise)
+static qint64 processResidentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/statm");
+    if (file.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = file.readAll().split(' ');
+        if (fields.size() > 1)
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+// Counts the notifications of property changes, each one recomputing the
+// presentation at most once
+class CountingGpxXdeDocumentItem : public GpxXdeDocumentItem {
+public:
+    CountingGpxXdeDocumentItem(XdeDocumentItem* item)
+        : GpxXdeDocumentItem(item)
+    {}
+
+    int notificationCount = 0;
+
+protected:
+    void onPropertiesChanged(const std::vector<Property*>& props) override {
+        ++this->notificationCount;
+        GpxXdeDocumentItem::onPropertiesChanged(props);
+    }
+};
+
+// Presentations are computed but never rendered, no display connection needed
+static Handle_AIS_InteractiveContext createOffscreenContext()
+{
+    Handle_Graphic3d_GraphicDriver gpxDriver =
+            new OpenGl_GraphicDriver(Handle_Aspect_DisplayConnection(), Standard_False);
+    return new AIS_InteractiveContext(new V3d_Viewer(gpxDriver));
+}
+
+} // namespace Internal
+
+void Bench::ApplicationImportStep_bench_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("concurrentImport");
+    const int idealThreadCount = QThread::idealThreadCount();
+    QTest::newRow("1 thread") << 1 << true;
+    QTest::newRow("4 threads") << 4 << true;
+    QTest::newRow(qPrintable(QString("%1 threads").arg(idealThreadCount)))
+            << idealThreadCount << true;
+    QTest::newRow(qPrintable(QString("%1 threads, serialized").arg(idealThreadCount)))
+            << idealThreadCount << false;
+}
+
+void Bench::ApplicationImportStep_bench()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, concurrentImport);
+    const QStringList listFilePath = Internal::benchStepFiles();
+    if (listFilePath.isEmpty())
+        QSKIP("No STEP files found, check environment variable MAYO_BENCH_STEP_DIR");
+
+    Application::ImportOptions importOpts = Application::importOptionsFromSettings();
+    importOpts.concurrentTranslation = concurrentImport;
+    importOpts.useCache = false; // Measure translation only
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        Internal::importFiles(listFilePath, importOpts, threadCount);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    qInfo() << listFilePath.size() << "files imported in" << secs << "s,"
+            << (secs > 0 ? listFilePath.size() / secs : 0.) << "files/s";
+    BenchReport::instance()->addResult(secs, 1, { { "fileCount", listFilePath.size() } });
+}
+
+void Bench::ApplicationImportStepProgress_bench_data()
+{
+    QTest::addColumn<bool>("withProgress");
+    QTest::newRow("no progress") << false;
+    QTest::newRow("progress") << true;
+}
+
+// Measures the overhead of progress reporting during STEP translation, and
+// the count of progress events published to the task manager
+void Bench::ApplicationImportStepProgress_bench()
+{
+    QFETCH(bool, withProgress);
+    const QStringList listFilePath = Internal::benchStepFiles();
+    if (listFilePath.isEmpty())
+        QSKIP("No STEP files found, check environment variable MAYO_BENCH_STEP_DIR");
+
+    Application::ImportOptions importOpts = Application::importOptionsFromSettings();
+    importOpts.useCache = false; // Measure translation only
+    Application* app = Application::instance();
+    qttask::Manager* taskMgr = qttask::Manager::globalInstance();
+    int eventCount = 0;
+    auto fnCountEvent = [&]{ ++eventCount; };
+    const QMetaObject::Connection connProgress =
+            QObject::connect(taskMgr, &qttask::Manager::progress, fnCountEvent);
+    const QMetaObject::Connection connProgressStep =
+            QObject::connect(taskMgr, &qttask::Manager::progressStep, fnCountEvent);
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        for (const QString& filepath : listFilePath) {
+            Document* doc = app->createDocument();
+            app->addDocument(doc);
+            if (withProgress) {
+                auto task = taskMgr->newTask<qttask::CurrentThread>();
+                task->run([=]{
+                    app->importInDocument(
+                                doc,
+                                Application::PartFormat::Step,
+                                filepath,
+                                importOpts,
+                                &task->progress());
+                });
+            }
+            else {
+                app->importInDocument(doc, Application::PartFormat::Step, filepath, importOpts);
+            }
+
+            app->eraseDocument(doc);
+        }
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QObject::disconnect(connProgress);
+    QObject::disconnect(connProgressStep);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    qInfo() << listFilePath.size() << "files imported in" << secs << "s,"
+            << eventCount << "progress events published";
+    BenchReport::instance()->addResult(
+                secs,
+                1,
+                { { "fileCount", listFilePath.size() },
+                  { "progressEventCount", eventCount } });
+}
+
+void Bench::ApplicationImportStl_bench_data()
+{
+    QTest::addColumn<QString>("filepath");
+    QTest::addColumn<int>("configId");
+    const std::vector<Internal::StlImportConfig> vecConfig =
+            Internal::stlImportConfigs();
+    for (const QString& filepath : Internal::benchStlFiles()) {
+        for (size_t i = 0; i < vecConfig.size(); ++i) {
+            const QString rowName =
+                    QString("%1, %2").arg(QFileInfo(filepath).fileName())
+                                     .arg(vecConfig.at(i).name);
+            QTest::newRow(qPrintable(rowName)) << filepath << static_cast<int>(i);
+        }
+    }
+}
+
+void Bench::ApplicationImportStl_bench()
+{
+    if (Internal::benchStlFiles().isEmpty())
+        QSKIP("No STL files found, check environment variable MAYO_BENCH_STL_DIR");
+
+    QFETCH(QString, filepath);
+    QFETCH(int, configId);
+    const Internal::StlImportConfig config =
+            Internal::stlImportConfigs().at(configId);
+    Application::ImportOptions importOpts = Application::importOptionsFromSettings();
+    importOpts.stlIoLibrary = config.lib;
+    importOpts.stlWeldTolerance = config.weldTolerance;
+    Application* app = Application::instance();
+    Document* doc = app->createDocument();
+    app->addDocument(doc);
+    Application::IoResult result = {};
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        result = app->importInDocument(doc, Application::PartFormat::Stl, filepath, importOpts);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    app->eraseDocument(doc);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QVERIFY2(result.ok, qPrintable(result.errorText));
+    const double fileGB = QFileInfo(filepath).size() / (1024. * 1024. * 1024.);
+    qInfo() << fileGB << "GB imported in" << secs << "s,"
+            << (secs > 0 ? fileGB / secs : 0.) << "GB/s";
+    BenchReport::instance()->addResult(
+                secs, 1, { { "fileSize", QFileInfo(filepath).size() } });
+}
+
+void Bench::MeshUtilsMassProperties_bench_data()
+{
+    QTest::addColumn<int>("triangleCount");
+    QTest::addColumn<bool>("singlePass");
+    for (int triangleCount : { 100000, 1000000, 10000000 }) {
+        const QString strCount = QString::number(triangleCount);
+        QTest::newRow(qPrintable(strCount + " triangles, separate area/volume"))
+                << triangleCount << false;
+        QTest::newRow(qPrintable(strCount + " triangles, single pass"))
+                << triangleCount << true;
+    }
+}
+
+void Bench::MeshUtilsMassProperties_bench()
+{
+    QFETCH(int, triangleCount);
+    QFETCH(bool, singlePass);
+    const Handle_Poly_Triangulation mesh = Internal::createSphereMesh(triangleCount);
+    double area = 0.;
+    double volume = 0.;
+    int iterationCount = 0;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK {
+        ++iterationCount;
+        if (singlePass) {
+            const occ::MeshUtils::MassProperties props =
+                    occ::MeshUtils::triangulationMassProperties(mesh);
+            area = props.area;
+            volume = props.volume;
+        }
+        else {
+            area = occ::MeshUtils::triangulationArea(mesh);
+            volume = occ::MeshUtils::triangulationVolume(mesh);
+        }
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QVERIFY(area > 0);
+    QVERIFY(std::abs(volume) > 0);
+    BenchReport::instance()->addResult(
+                secs / iterationCount,
+                iterationCount,
+                { { "triangleCount", mesh->NbTriangles() } });
+}
+
+void Bench::GpxBRepOwnerIndex_bench_data()
+{
+    QTest::addColumn<int>("faceCount");
+    QTest::addColumn<bool>("hashed");
+    // Linear scan is quadratic, with 50k faces it would take minutes
+    QTest::newRow("5000 faces, linear scan") << 5000 << false;
+    QTest::newRow("5000 faces, hashed index") << 5000 << true;
+    QTest::newRow("50000 faces, hashed index") << 50000 << true;
+}
+
+void Bench::GpxBRepOwnerIndex_bench()
+{
+    QFETCH(int, faceCount);
+    QFETCH(bool, hashed);
+    const TopoDS_Shape rootShape = Internal::createFaceGridShape(faceCount);
+    std::vector<Handle_SelectMgr_EntityOwner> vecOwner;
+    BRepUtils::forEachSubFace(rootShape, [&](const TopoDS_Face& face) {
+        vecOwner.emplace_back(new StdSelect_BRepOwner(face));
+    });
+    GpxBRepOwnerIndex ownerIndex;
+    if (hashed) {
+        for (const Handle_SelectMgr_EntityOwner& owner : vecOwner)
+            ownerIndex.add(owner);
+    }
+
+    // Same lookup as GuiDocument::toggleItemSelected() on the root node
+    int foundCount = 0;
+    int iterationCount = 0;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK {
+        ++iterationCount;
+        foundCount = 0;
+        BRepUtils::forEachSubFace(rootShape, [&](const TopoDS_Face& face) {
+            const Handle_SelectMgr_EntityOwner owner =
+                    hashed ?
+                        ownerIndex.findOwner(face) :
+                        Internal::findBRepOwnerLinear(vecOwner, face);
+            if (!owner.IsNull())
+                ++foundCount;
+        });
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QCOMPARE(foundCount, faceCount);
+    BenchReport::instance()->addResult(
+                secs / iterationCount, iterationCount, { { "faceCount", faceCount } });
+}
+
+void Bench::SyntheticImport_bench_data()
+{
+    Internal::addSyntheticWorkloadRows();
+}
+
+void Bench::SyntheticImport_bench()
+{
+    QFETCH(int, workloadId);
+    QFETCH(int, formatId);
+    const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(workloadId);
+    const Internal::WorkloadFormat& format = Internal::workloadFormats().at(formatId);
+    const QString filepath = Internal::syntheticWorkloadFile(workload, format);
+    QVERIFY2(!filepath.isEmpty(), "Failed to generate input file");
+
+    Application::ImportOptions importOpts = Application::importOptionsFromSettings();
+    importOpts.useCache = false; // Measure translation only
+    Application* app = Application::instance();
+    Document* doc = app->createDocument();
+    app->addDocument(doc);
+    Application::IoResult result = {};
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        result = app->importInDocument(doc, format.partFormat, filepath, importOpts);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    app->eraseDocument(doc);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QVERIFY2(result.ok, qPrintable(result.errorText));
+    BenchReport::instance()->addResult(
+                secs, 1, { { "fileSize", QFileInfo(filepath).size() } });
+}
+
+void Bench::SyntheticExport_bench_data()
+{
+    Internal::addSyntheticWorkloadRows();
+}
+
+void Bench::SyntheticExport_bench()
+{
+    QFETCH(int, workloadId);
+    QFETCH(int, formatId);
+    const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(workloadId);
+    const Internal::WorkloadFormat& format = Internal::workloadFormats().at(formatId);
+    const std::unique_ptr<DocumentItem> item = Internal::createWorkloadItem(workload);
+    const QString filepath =
+            Internal::workloadDir().filePath(
+                QString("export_%1.%2").arg(workload.name, format.fileSuffix));
+    Application::IoResult result = {};
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        result = Application::instance()->exportDocumentItems(
+                    { item.get() },
+                    format.partFormat,
+                    Internal::workloadExportOptions(format),
+                    filepath);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QVERIFY2(result.ok, qPrintable(result.errorText));
+    BenchReport::instance()->addResult(
+                secs, 1, { { "fileSize", QFileInfo(filepath).size() } });
+    QFile::remove(filepath);
+}
+
+void Bench::XdeAssemblyTree_bench_data()
+{
+    QTest::addColumn<int>("workloadId");
+    for (size_t i = 0; i < Internal::syntheticWorkloads().size(); ++i) {
+        const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(i);
+        if (workload.kind == Internal::WorkloadKind::Assembly)
+            QTest::newRow(workload.name) << static_cast<int>(i);
+    }
+}
+
+// Rebuilds the assembly tree then fetches all its nodes, same as a full
+// expansion of the assembly in the application tree
+void Bench::XdeAssemblyTree_bench()
+{
+    QFETCH(int, workloadId);
+    const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(workloadId);
+    XdeDocumentItem xdeItem(
+                Internal::createAssemblyDocument(workload.depth, workload.childCount));
+    int nodeCount = 0;
+    int iterationCount = 0;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK {
+        ++iterationCount;
+        xdeItem.rebuildAssemblyTree();
+        const Tree<TDF_Label>& asmTree = xdeItem.assemblyTree();
+        std::vector<TreeNodeId> vecNodeId = asmTree.roots();
+        nodeCount = 0;
+        while (!vecNodeId.empty()) {
+            const TreeNodeId nodeId = vecNodeId.back();
+            vecNodeId.pop_back();
+            ++nodeCount;
+            xdeItem.fetchAssemblyNodeChildren(nodeId);
+            for (TreeNodeId childId = asmTree.nodeChildFirst(nodeId);
+                 childId != 0;
+                 childId = asmTree.nodeSiblingNext(childId))
+            {
+                vecNodeId.push_back(childId);
+            }
+        }
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QVERIFY(nodeCount > 0);
+    BenchReport::instance()->addResult(
+                secs / iterationCount, iterationCount, { { "nodeCount", nodeCount } });
+}
+
+void Bench::LibTreeTraversal_bench_data()
+{
+    QTest::addColumn<int>("traversal");
+    QTest::newRow("recursive") << static_cast<int>(Internal::TreeTraversal::Recursive);
+    QTest::newRow("pre_order") << static_cast<int>(Internal::TreeTraversal::PreOrder);
+    QTest::newRow("post_order") << static_cast<int>(Internal::TreeTraversal::PostOrder);
+    QTest::newRow("parallel") << static_cast<int>(Internal::TreeTraversal::Parallel);
+}
+
+// Each node visit writes into its own slot, so all traversals do the same
+// work and the parallel one has no contention
+void Bench::LibTreeTraversal_bench()
+{
+    QFETCH(int, traversal);
+    const Tree<int>& tree = Internal::libTreeOneMillion();
+    const TreeNodeId rootId = tree.roots().front();
+    std::vector<int> vecNodeValue;
+    auto fnVisit = [&](TreeNodeId id) { vecNodeValue[id - 1] = tree.nodeData(id) + 1; };
+    int iterationCount = 0;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK {
+        ++iterationCount;
+        vecNodeValue.assign(1111111, 0);
+        switch (static_cast<Internal::TreeTraversal>(traversal)) {
+        case Internal::TreeTraversal::Recursive:
+            Internal::deepForeachTreeNodeRecursive(rootId, tree, fnVisit);
+            break;
+        case Internal::TreeTraversal::PreOrder:
+            deepForeachTreeNode(tree, fnVisit);
+            break;
+        case Internal::TreeTraversal::PostOrder:
+            for (TreeIteratorPostOrder<int> it(&tree); !it.atEnd(); it.next())
+                fnVisit(it.current());
+            break;
+        case Internal::TreeTraversal::Parallel:
+            parallelForeachTreeNode(0, tree, fnVisit);
+            break;
+        }
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    const auto visitedCount =
+            std::count_if(vecNodeValue.cbegin(), vecNodeValue.cend(), [](int v) { return v > 0; });
+    QCOMPARE(visitedCount, std::ptrdiff_t(1111111));
+    const double nodesPerSec = secs > 0. ? (visitedCount * iterationCount) / secs : 0.;
+    BenchReport::instance()->addResult(
+                secs / iterationCount,
+                iterationCount,
+                { { "nodeCount", static_cast<qlonglong>(visitedCount) },
+                  { "nodesPerSec", nodesPerSec } });
+}
+
+void Bench::XdeAssemblyNodeLocation_bench_data()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("childCount");
+    QTest::addColumn<bool>("isCached");
+    QTest::newRow("deep_walk_up") << 16 << 2 << false;
+    QTest::newRow("deep_cached") << 16 << 2 << true;
+    QTest::newRow("wide_walk_up") << 4 << 16 << false;
+    QTest::newRow("wide_cached") << 4 << 16 << true;
+}
+
+// Queries the absolute location of all nodes of a fully expanded assembly
+// tree, both paths are first checked to give the same transformations
+void Bench::XdeAssemblyNodeLocation_bench()
+{
+    QFETCH(int, depth);
+    QFETCH(int, childCount);
+    QFETCH(bool, isCached);
+    XdeDocumentItem xdeItem(Internal::createAssemblyDocument(depth, childCount));
+    std::vector<TreeNodeId> vecNodeId;
+    for (TreeIteratorPreOrder<TDF_Label> it(&xdeItem.assemblyTree()); !it.atEnd(); it.next()) {
+        xdeItem.fetchAssemblyNodeChildren(it.current());
+        vecNodeId.push_back(it.current());
+    }
+
+    for (TreeNodeId nodeId : vecNodeId) {
+        const gp_Trsf trsfCached = xdeItem.shapeAbsoluteLocation(nodeId).Transformation();
+        const gp_Trsf trsfWalkUp =
+                Internal::shapeAbsoluteLocationWalkUp(xdeItem, nodeId).Transformation();
+        QVERIFY(Internal::isTrsfEqual(trsfCached, trsfWalkUp));
+    }
+
+    double sumX = 0.;
+    int iterationCount = 0;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK {
+        ++iterationCount;
+        for (TreeNodeId nodeId : vecNodeId) {
+            const TopLoc_Location loc =
+                    isCached ?
+                        xdeItem.shapeAbsoluteLocation(nodeId) :
+                        Internal::shapeAbsoluteLocationWalkUp(xdeItem, nodeId);
+            sumX += loc.Transformation().TranslationPart().X();
+        }
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QVERIFY(sumX >= 0.);
+    BenchReport::instance()->addResult(
+                secs / iterationCount,
+                iterationCount,
+                { { "nodeCount", static_cast<qlonglong>(vecNodeId.size()) } });
+}
+
+void Bench::GpxXdeInstancedMemory_bench_data()
+{
+    QTest::addColumn<int>("workloadId");
+    for (size_t i = 0; i < Internal::syntheticWorkloads().size(); ++i) {
+        const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(i);
+        if (workload.kind == Internal::WorkloadKind::Assembly)
+            QTest::newRow(workload.name) << static_cast<int>(i);
+    }
+}
+
+// Memory of presentation arrays when each instance expands the tessellation
+// of its part, compared to the instanced display. Leaves are meshed spheres
+void Bench::GpxXdeInstancedMemory_bench()
+{
+    QFETCH(int, workloadId);
+    const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(workloadId);
+    const TopoDS_Shape leafShape = BRepPrimAPI_MakeSphere(5.).Shape();
+    BRepMesh_IncrementalMesh(leafShape, 0.01);
+    XdeDocumentItem xdeItem(
+                Internal::createAssemblyDocument(
+                    workload.depth, workload.childCount, leafShape));
+    GpxXdeDocumentItem::MemoryReport report = {};
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        report = GpxXdeDocumentItem::memoryReport(&xdeItem);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QVERIFY(report.instanceCount > 0);
+    QVERIFY(report.prototypeCount == 1);
+    QVERIFY(report.instancedBytes < report.expandedBytes);
+    qInfo().noquote()
+            << QString("%1 instances, %2 prototypes : expanded %3 KB, instanced %4 KB")
+               .arg(report.instanceCount)
+               .arg(report.prototypeCount)
+               .arg(report.expandedBytes / 1024)
+               .arg(report.instancedBytes / 1024);
+    BenchReport::instance()->addResult(
+                secs,
+                1,
+                { { "instanceCount", report.instanceCount },
+                  { "prototypeCount", report.prototypeCount },
+                  { "expandedBytes", static_cast<qulonglong>(report.expandedBytes) },
+                  { "instancedBytes", static_cast<qulonglong>(report.instancedBytes) } });
+}
+
+void Bench::GpxXdeSelectionModes_bench_data()
+{
+    QTest::addColumn<int>("workloadId");
+    QTest::addColumn<bool>("eager");
+    for (size_t i = 0; i < Internal::syntheticWorkloads().size(); ++i) {
+        const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(i);
+        if (workload.kind == Internal::WorkloadKind::Assembly) {
+            const QString rowName = workload.name;
+            QTest::newRow(qPrintable(rowName + ", eager at display"))
+                    << static_cast<int>(i) << true;
+            QTest::newRow(qPrintable(rowName + ", lazy at first click"))
+                    << static_cast<int>(i) << false;
+        }
+    }
+}
+
+// Sensitive entities computed for an XDE item : vertex, edge and face modes
+// as formerly done when the item was displayed, compared to the face mode
+// only computed by GuiDocument::activatePicking() at first click or selection.
+// Leaves are meshed spheres
+void Bench::GpxXdeSelectionModes_bench()
+{
+    QFETCH(int, workloadId);
+    QFETCH(bool, eager);
+    const Internal::SyntheticWorkload& workload = Internal::syntheticWorkloads().at(workloadId);
+    const TopoDS_Shape leafShape = BRepPrimAPI_MakeSphere(5.).Shape();
+    BRepMesh_IncrementalMesh(leafShape, 0.01);
+    XdeDocumentItem xdeItem(
+                Internal::createAssemblyDocument(
+                    workload.depth, workload.childCount, leafShape));
+    Handle_XCAFPrs_AISObject gpxObject =
+            new XCAFPrs_AISObject(xdeItem.topLevelFreeShapes().front());
+    std::vector<int> vecMode = { AIS_Shape::SelectionMode(TopAbs_FACE) };
+    if (eager) {
+        vecMode.push_back(AIS_Shape::SelectionMode(TopAbs_EDGE));
+        vecMode.push_back(AIS_Shape::SelectionMode(TopAbs_VERTEX));
+    }
+
+    const qint64 residentBytesBefore = Internal::processResidentBytes();
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        for (int mode : vecMode)
+            gpxObject->RecomputePrimitives(mode);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    const qint64 residentBytes = Internal::processResidentBytes() - residentBytesBefore;
+    for (int mode : vecMode)
+        QVERIFY(gpxObject->HasSelection(mode));
+    qInfo().noquote()
+            << QString("%1 selection modes : %2 ms, %3 KB resident")
+               .arg(vecMode.size())
+               .arg(chrono.elapsed())
+               .arg(residentBytes / 1024);
+    BenchReport::instance()->addResult(
+                secs,
+                1,
+                { { "modeCount", static_cast<int>(vecMode.size()) },
+                  { "residentBytes", residentBytes } });
+}
+
+void Bench::XdePartSharing_bench_data()
+{
+    QTest::addColumn<int>("copyCount");
+    QTest::newRow("16_copies") << 16;
+    QTest::newRow("256_copies") << 256;
+}
+
+// Two documents embedding 'copyCount' copies of a meshed sphere each : copies
+// are fingerprinted and referred by one label within the first document, then
+// shared with the published parts of the first document
+void Bench::XdePartSharing_bench()
+{
+    QFETCH(int, copyCount);
+    const TopoDS_Shape partShape = BRepPrimAPI_MakeSphere(5.).Shape();
+    XdeDocumentItem xdeItem1(Internal::createPartCopiesDocument(copyCount, partShape));
+    XdeDocumentItem xdeItem2(Internal::createPartCopiesDocument(copyCount, partShape));
+    XdePartIndex* partIndex = XdePartIndex::instance();
+    partIndex->clear();
+    std::vector<XdePartIndex::Part> vecPart2;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        partIndex->addParts(&xdeItem1);
+        BRepMesh_IncrementalMesh(
+                    xdeItem1.shape(xdeItem1.topLevelFreeShapes().front()), 0.01);
+        partIndex->publishParts(&xdeItem1);
+        vecPart2 = partIndex->addParts(&xdeItem2);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    const XdePartIndex::Statistics stats = partIndex->statistics();
+    QCOMPARE(stats.partCount, 1);
+    QCOMPARE(stats.duplicateCount, 2 * copyCount - 1);
+    QCOMPARE(vecPart2.size(), size_t(1));
+    QVERIFY(vecPart2.front().isSharedWithOtherItem);
+    QVERIFY(stats.savedBytes > 0);
+    for (const XdeDocumentItem* xdeItem : { &xdeItem1, &xdeItem2 }) {
+        const TDF_Label labelAssembly = xdeItem->topLevelFreeShapes().front();
+        std::unordered_set<TDF_Label> setReferred;
+        for (const TDF_Label& component : xdeItem->shapeComponents(labelAssembly))
+            setReferred.insert(xdeItem->shapeReferred(component));
+        QCOMPARE(setReferred.size(), size_t(1));
+    }
+
+    // Part is handed over to the second document, then dropped
+    partIndex->removeParts(&xdeItem1);
+    QCOMPARE(partIndex->statistics().duplicateCount, copyCount - 1);
+    partIndex->removeParts(&xdeItem2);
+    QCOMPARE(partIndex->statistics().partCount, 0);
+    qInfo().noquote()
+            << QString("%1 distinct parts, %2 shared copies, %3 KB saved")
+               .arg(stats.partCount)
+               .arg(stats.duplicateCount)
+               .arg(stats.savedBytes / 1024);
+    BenchReport::instance()->addResult(
+                secs,
+                1,
+                { { "partCount", stats.partCount },
+                  { "duplicateCount", stats.duplicateCount },
+                  { "savedBytes", stats.savedBytes } });
+}
+
+// Document alternating 'copyCount' copies of a part and of its mirror image,
+// which have the same fingerprint : only copies of the part are shared
+void Bench::XdePartSharingMirrored_bench()
+{
+    const int copyCount = 64;
+    const TopoDS_Shape partShape = Internal::createChiralShape();
+    gp_Trsf trsfMirror;
+    trsfMirror.SetMirror(gp_Ax2(gp_Pnt(0, 0, 0), gp_Dir(1, 0, 0)));
+    const TopoDS_Shape mirroredShape =
+            BRepBuilderAPI_Transform(partShape, trsfMirror, Standard_True).Shape();
+    QVERIFY(ShapeFingerprint::compute(partShape) == ShapeFingerprint::compute(mirroredShape));
+
+    Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
+    const Handle_XCAFDoc_ShapeTool shapeTool =
+            XCAFDoc_DocumentTool::ShapeTool(cafDoc->Main());
+    const TDF_Label labelAssembly = shapeTool->NewShape();
+    for (int i = 0; i < copyCount; ++i) {
+        const TopoDS_Shape& shape = i % 2 == 0 ? partShape : mirroredShape;
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(i * 30., 0, 0));
+        shapeTool->AddComponent(
+                    labelAssembly,
+                    shapeTool->AddShape(BRepBuilderAPI_Copy(shape).Shape(), false),
+                    TopLoc_Location(trsf));
+    }
+
+    shapeTool->UpdateAssemblies();
+    XdeDocumentItem xdeItem(cafDoc);
+    XdePartIndex* partIndex = XdePartIndex::instance();
+    partIndex->clear();
+    std::vector<XdePartIndex::Part> vecPart;
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        vecPart = partIndex->addParts(&xdeItem);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    partIndex->publishParts(&xdeItem);
+    const XdePartIndex::Statistics stats = partIndex->statistics();
+    partIndex->removeParts(&xdeItem);
+    QCOMPARE(stats.partCount, 1);
+    QCOMPARE(stats.duplicateCount, copyCount / 2 - 1);
+    QCOMPARE(vecPart.size(), size_t(copyCount / 2 + 1));
+    qInfo().noquote()
+            << QString("%1 parts, %2 shared copies : %3 ms")
+               .arg(copyCount)
+               .arg(stats.duplicateCount)
+               .arg(chrono.elapsed());
+    BenchReport::instance()->addResult(
+                secs,
+                1,
+                { { "partCount", copyCount },
+                  { "duplicateCount", stats.duplicateCount } });
+}
+
+void Bench::GpxPropertyTransaction_bench_data()
+{
+    QTest::addColumn<bool>("inTransaction");
+    QTest::newRow("separate changes") << false;
+    QTest::newRow("one transaction") << true;
+}
+
+// Color, material and face boundaries of a displayed XDE item are changed
+// together : within a transaction they are notified at once, so the
+// presentation is recomputed a single time
+void Bench::GpxPropertyTransaction_bench()
+{
+    QFETCH(bool, inTransaction);
+    const TopoDS_Shape partShape = BRepPrimAPI_MakeSphere(5.).Shape();
+    XdeDocumentItem xdeItem(Internal::createPartCopiesDocument(64, partShape));
+    BRepMesh_IncrementalMesh(xdeItem.shape(xdeItem.topLevelFreeShapes().front()), 0.01);
+    Internal::CountingGpxXdeDocumentItem gpxItem(&xdeItem);
+    const Handle_AIS_InteractiveContext context = Internal::createOffscreenContext();
+    context->Display(gpxItem.handleGpxObject(), Standard_False);
+    const bool showFaceBoundary = !gpxItem.propertyShowFaceBoundary.value();
+    QElapsedTimer chrono;
+    chrono.start();
+    QBENCHMARK_ONCE {
+        PropertyTransaction transaction(inTransaction ? &gpxItem : nullptr);
+        gpxItem.propertyColor.setValue(Quantity_Color(Quantity_NOC_RED));
+        gpxItem.propertyMaterial.setValue(Graphic3d_NOM_SILVER);
+        gpxItem.propertyShowFaceBoundary.setValue(showFaceBoundary);
+    }
+    const double secs = chrono.elapsed() / 1000.;
+    QCOMPARE(gpxItem.notificationCount, inTransaction ? 1 : 3);
+    qInfo().noquote()
+            << QString("%1 notifications : %2 ms")
+               .arg(gpxItem.notificationCount)
+               .arg(chrono.elapsed());
+    BenchReport::instance()->addResult(
+                secs,
+                1,
+                { { "notificationCount", gpxItem.notificationCount } });
+}
+
+} // namespace Mayo
@@ -0,0 +1,62 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+namespace Mayo {
+
+class Bench : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ApplicationImportStep_bench_data();
+    void ApplicationImportStep_bench();
+
+    void ApplicationImportStepProgress_bench_data();
+    void ApplicationImportStepProgress_bench();
+
+    void ApplicationImportStl_bench_data();
+    void ApplicationImportStl_bench();
+
+    void MeshUtilsMassProperties_bench_data();
+    void MeshUtilsMassProperties_bench();
+
+    void GpxBRepOwnerIndex_bench_data();
+    void GpxBRepOwnerIndex_bench();
+
+    void SyntheticImport_bench_data();
+    void SyntheticImport_bench();
+
+    void SyntheticExport_bench_data();
+    void SyntheticExport_bench();
+
+    void XdeAssemblyTree_bench_data();
+    void XdeAssemblyTree_bench();
+
+    void XdeAssemblyNodeLocation_bench_data();
+    void XdeAssemblyNodeLocation_bench();
+
+    void GpxXdeInstancedMemory_bench_data();
+    void GpxXdeInstancedMemory_bench();
+
+    void GpxXdeSelectionModes_bench_data();
+    void GpxXdeSelectionModes_bench();
+
+    void GpxPropertyTransaction_bench_data();
+    void GpxPropertyTransaction_bench();
+
+    void XdePartSharing_bench_data();
+    void XdePartSharing_bench();
+    void XdePartSharingMirrored_bench();
+
+    void LibTreeTraversal_bench_data();
+    void LibTreeTraversal_bench();
+};
+
+} // namespace Mayo
@@ -0,0 +1,63 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bench_report.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSysInfo>
+#include <QtCore/QThread>
+#include <QtTest/QtTest>
+
+#include <Standard_Version.hxx>
+
+namespace Mayo {
+
+BenchReport* BenchReport::instance()
+{
+    static BenchReport report;
+    return &report;
+}
+
+void BenchReport::addResult(
+        double seconds, int iterationCount, const QVariantMap& metrics)
+{
+    QJsonObject jsonResult;
+    jsonResult.insert("function", QString(QTest::currentTestFunction()));
+    jsonResult.insert("dataTag", QString(QTest::currentDataTag()));
+    jsonResult.insert("seconds", seconds);
+    jsonResult.insert("iterationCount", iterationCount);
+    if (!metrics.isEmpty())
+        jsonResult.insert("metrics", QJsonObject::fromVariantMap(metrics));
+    m_results.append(jsonResult);
+}
+
+bool BenchReport::writeJson(const QString& filepath) const
+{
+    QJsonObject jsonRoot;
+    jsonRoot.insert("date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    jsonRoot.insert("os", QSysInfo::prettyProductName());
+    jsonRoot.insert("cpuArchitecture", QSysInfo::currentCpuArchitecture());
+    jsonRoot.insert("idealThreadCount", QThread::idealThreadCount());
+    jsonRoot.insert("qtVersion", QString(qVersion()));
+    jsonRoot.insert("occtVersion", QString(OCC_VERSION_COMPLETE));
+#ifdef HAVE_GMIO
+    jsonRoot.insert("gmio", true);
+#else
+    jsonRoot.insert("gmio", false);
+#endif
+    jsonRoot.insert("results", m_results);
+
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    return file.write(QJsonDocument(jsonRoot).toJson()) != -1;
+}
+
+} // namespace Mayo
@@ -0,0 +1,36 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+namespace Mayo {
+
+//! Collects the results of the benches, written as one JSON file so they can
+//! be compared release over release
+//!
+//! Each result is bound to the current QtTest function and data row
+class BenchReport {
+public:
+    static BenchReport* instance();
+
+    // 'seconds' is the time taken by one iteration, 'metrics' holds
+    // bench-specific values(eg. triangle count, file size, ...)
+    void addResult(
+            double seconds,
+            int iterationCount = 1,
+            const QVariantMap& metrics = QVariantMap());
+
+    bool writeJson(const QString& filepath) const;
+
+private:
+    QJsonArray m_results;
+};
+
+} // namespace Mayo
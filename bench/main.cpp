@@ -0,0 +1,38 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bench.h"
+#include "bench_report.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QStringList>
+#include <QtCore/QtDebug>
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    // Own settings scope, so benches never alter the Options of the Mayo
+    // application
+    QCoreApplication::setOrganizationName("Fougue");
+    QCoreApplication::setOrganizationDomain("www.fougue.pro");
+    QCoreApplication::setApplicationName("mayo_bench");
+
+    // Option "-json <file>" is handled here, other options are forwarded to
+    // QtTest
+    QStringList args = app.arguments();
+    QString jsonFilePath;
+    const int jsonOptIndex = args.indexOf("-json");
+    if (jsonOptIndex != -1 && jsonOptIndex + 1 < args.size()) {
+        jsonFilePath = args.at(jsonOptIndex + 1);
+        args.erase(args.begin() + jsonOptIndex, args.begin() + jsonOptIndex + 2);
+    }
+
+    Mayo::Bench bench;
+    const int result = QTest::qExec(&bench, args);
+    if (!jsonFilePath.isEmpty() && !Mayo::BenchReport::instance()->writeJson(jsonFilePath))
+        qWarning() << "Failed to write JSON report" << jsonFilePath;
+    return result;
+}
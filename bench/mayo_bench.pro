@@ -0,0 +1,104 @@
+TARGET = mayo_bench
+TEMPLATE = app
+
+CONFIG += console no_batch
+
+QT += core gui testlib
+
+HEADERS += \
+    bench.h \
+    bench_report.h \
+    ../src/application.h \
+    ../src/brep_utils.h \
+    ../src/caf_utils.h \
+    ../src/document.h \
+    ../src/document_item.h \
+    ../src/fougtools/occtools/qt_utils.h \
+    ../src/gpx_brep_owner_index.h \
+    ../src/gpx_document_item.h \
+    ../src/gpx_xde_document_item.h \
+    ../src/import_cache.h \
+    ../src/mesh_item.h \
+    ../src/mesh_utils.h \
+    ../src/options.h \
+    ../src/property.h \
+    ../src/property_builtins.h \
+    ../src/property_enumeration.h \
+    ../src/quantity.h \
+    ../src/shape_fingerprint.h \
+    ../src/stl_reader.h \
+    ../src/string_utils.h \
+    ../src/trace.h \
+    ../src/unit.h \
+    ../src/unit_system.h \
+    ../src/view_redraw_scheduler.h \
+    ../src/xde_document_item.h \
+    ../src/xde_part_index.h
+
+SOURCES += \
+    bench.cpp \
+    bench_report.cpp \
+    main.cpp \
+    ../src/application.cpp \
+    ../src/caf_utils.cpp \
+    ../src/document.cpp \
+    ../src/document_item.cpp \
+    ../src/fougtools/occtools/qt_utils.cpp \
+    ../src/gpx_brep_owner_index.cpp \
+    ../src/gpx_document_item.cpp \
+    ../src/gpx_xde_document_item.cpp \
+    ../src/import_cache.cpp \
+    ../src/mesh_item.cpp \
+    ../src/mesh_utils.cpp \
+    ../src/options.cpp \
+    ../src/property.cpp \
+    ../src/property_enumeration.cpp \
+    ../src/quantity.cpp \
+    ../src/shape_fingerprint.cpp \
+    ../src/stl_reader.cpp \
+    ../src/string_utils.cpp \
+    ../src/trace.cpp \
+    ../src/unit.cpp \
+    ../src/unit_system.cpp \
+    ../src/view_redraw_scheduler.cpp \
+    ../src/xde_document_item.cpp \
+    ../src/xde_part_index.cpp
+
+include(../src/fougtools/qttools/task/qttools_task.pri)
+
+# Scoped tracing in Chrome trace-event format, see src/trace.h
+mayo_trace:DEFINES += HAVE_MAYO_TRACE
+
+# gmio
+isEmpty(GMIO_ROOT) {
+    warning(gmio is disabled)
+} else {
+    CONFIG(debug, debug|release) {
+        GMIO_BIN_SUFFIX = d
+    } else {
+        GMIO_BIN_SUFFIX =
+    }
+    INCLUDEPATH += $$GMIO_ROOT/include
+    LIBS += -L$$GMIO_ROOT/lib -lgmio_static$$GMIO_BIN_SUFFIX
+    SOURCES += \
+        $$GMIO_ROOT/src/gmio_support/stl_occ_brep.cpp \
+        $$GMIO_ROOT/src/gmio_support/stl_occ_polytri.cpp \
+        $$GMIO_ROOT/src/gmio_support/stream_qt.cpp
+    DEFINES += HAVE_GMIO
+}
+
+# OpenCascade
+isEmpty(CASCADE_ROOT):error(Variable CASCADE_ROOT is empty)
+include(../occ.pri)
+LIBS += -lTKernel -lTKMath -lTKTopAlgo -lTKV3d -lTKOpenGl -lTKService
+LIBS += -lTKG2d
+LIBS += -lTKBRep -lTKSTL -lTKMesh -lTKPrim
+LIBS += -lTKXSBase -lTKIGES -lTKSTEP -lTKXDESTEP -lTKXDEIGES
+LIBS += -lTKLCAF -lTKXCAF -lTKCAF -lTKCDF
+LIBS += -lTKBin -lTKBinL -lTKBinXCAF
+LIBS += -lTKG3d
+LIBS += -lTKGeomBase
+
+OCCT_DEFINES = $$(CSF_DEFINES)
+DEFINES += $$split(OCCT_DEFINES, ;)
+DEFINES += OCCT_HANDLE_NOCAST
@@ -0,0 +1,410 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+// Headless batch converter : imports each input file in its own document
+// and exports it to the requested format. No display nor OpenGL context is
+// needed, only Application and the qttask runners are involved
+
+#include "../src/application.h"
+#include "../src/document.h"
+#include "../src/options.h"
+#include "../src/trace.h"
+#include "../src/fougtools/qttools/task/manager.h"
+#include "../src/fougtools/qttools/task/runner_qthreadpool.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QTextStream>
+#include <QtCore/QThreadPool>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+struct Conversion {
+    QString inputFilePath;
+    QString outputFilePath;
+    Document* doc = nullptr;
+    bool ok = false;
+    QString errorText;
+    qint64 importTime = 0; // Milliseconds
+    qint64 exportTime = 0; // Milliseconds
+};
+
+static QTextStream& stdOut()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream& stdErr()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Writes 'text' and a newline then flushes, QTextStream's endl manipulator is
+// deprecated
+static void printLine(QTextStream& stream, const QString& text)
+{
+    stream << text << '\n';
+    stream.flush();
+}
+
+// Absolute path used to compare file paths
+static QString comparablePath(const QString& filepath)
+{
+    const QString path = QDir::cleanPath(QFileInfo(filepath).absoluteFilePath());
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+    return path.toLower(); // Case insensitive file systems
+#else
+    return path;
+#endif
+}
+
+// Returns messages about output files that would overwrite an input file or
+// the output of another input file
+static QStringList findOutputCollisions(const std::vector<Conversion>& vecConversion)
+{
+    QStringList listMessage;
+    QHash<QString, const Conversion*> mapInput;
+    for (const Conversion& conv : vecConversion)
+        mapInput.insert(comparablePath(conv.inputFilePath), &conv);
+
+    QHash<QString, const Conversion*> mapOutput;
+    for (const Conversion& conv : vecConversion) {
+        const QString outputPath = comparablePath(conv.outputFilePath);
+        const Conversion* inputConv = mapInput.value(outputPath, nullptr);
+        if (inputConv != nullptr) {
+            listMessage.push_back(
+                        QString("Output file %1 of %2 would overwrite input file %3")
+                        .arg(conv.outputFilePath, conv.inputFilePath, inputConv->inputFilePath));
+            continue;
+        }
+
+        const Conversion* outputConv = mapOutput.value(outputPath, nullptr);
+        if (outputConv != nullptr) {
+            listMessage.push_back(
+                        QString("Output file %1 is the same for %2 and %3")
+                        .arg(conv.outputFilePath, outputConv->inputFilePath, conv.inputFilePath));
+        }
+        else {
+            mapOutput.insert(outputPath, &conv);
+        }
+    }
+
+    return listMessage;
+}
+
+static Application::PartFormat partFormatFromName(const QString& name)
+{
+    const QString lowerName = name.toLower();
+    if (lowerName == "iges" || lowerName == "igs")
+        return Application::PartFormat::Iges;
+    if (lowerName == "step" || lowerName == "stp")
+        return Application::PartFormat::Step;
+    if (lowerName == "brep" || lowerName == "occ")
+        return Application::PartFormat::OccBrep;
+    if (lowerName == "stl")
+        return Application::PartFormat::Stl;
+    return Application::PartFormat::Unknown;
+}
+
+static QString partFormatSuffix(Application::PartFormat format)
+{
+    switch (format) {
+    case Application::PartFormat::Iges: return "igs";
+    case Application::PartFormat::Step: return "step";
+    case Application::PartFormat::OccBrep: return "brep";
+    case Application::PartFormat::Stl: return "stl";
+    case Application::PartFormat::Unknown: break;
+    }
+    return QString();
+}
+
+// Expands wildcards of the file name part, ie "dir/*.step"
+static QStringList expandInput(const QString& input)
+{
+    const QFileInfo fileInfo(input);
+    const QString fileName = fileInfo.fileName();
+    if (!fileName.contains('*') && !fileName.contains('?') && !fileName.contains('['))
+        return QStringList(input);
+
+    QStringList listFilePath;
+    const QDir dir = fileInfo.dir();
+    const QStringList listEntry =
+            dir.entryList(QStringList(fileName), QDir::Files, QDir::Name);
+    for (const QString& entry : listEntry)
+        listFilePath.push_back(dir.filePath(entry));
+    return listFilePath;
+}
+
+// One file path per line, empty lines and lines starting with '#' are skipped
+static QStringList readFileList(const QString& listFilePath, bool* ok)
+{
+    QStringList listFilePath;
+    QFile file(listFilePath);
+    *ok = file.open(QIODevice::ReadOnly | QIODevice::Text);
+    if (*ok) {
+        QTextStream stream(&file);
+        while (!stream.atEnd()) {
+            const QString line = stream.readLine().trimmed();
+            if (!line.isEmpty() && !line.startsWith('#'))
+                listFilePath += expandInput(line);
+        }
+    }
+    return listFilePath;
+}
+
+static Application::ExportOptions exportOptions(bool isStlAscii)
+{
+    Application::ExportOptions options;
+    options.stlIoLibrary = Options::instance()->stlIoLibrary();
+#ifdef HAVE_GMIO
+    options.stlFormat = isStlAscii ? GMIO_STL_FORMAT_ASCII : GMIO_STL_FORMAT_BINARY_LE;
+#else
+    options.stlFormat =
+            isStlAscii ?
+                Application::ExportOptions::StlFormat::Ascii :
+                Application::ExportOptions::StlFormat::Binary;
+#endif
+    return options;
+}
+
+} // namespace Internal
+
+} // namespace Mayo
+
+int main(int argc, char** argv)
+{
+    using namespace Mayo;
+    QCoreApplication app(argc, argv);
+    // Same settings scope as the Mayo application, so Options are shared
+    QCoreApplication::setOrganizationName("Fougue");
+    QCoreApplication::setOrganizationDomain("www.fougue.pro");
+    QCoreApplication::setApplicationName("Mayo");
+    QCoreApplication::setApplicationVersion("0.1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                QCoreApplication::translate(
+                    "Mayo", "Converts CAD files without any graphics display"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption optFormat(
+                QStringList() << "f" << "format",
+                QCoreApplication::translate("Mayo", "Output format : step, iges, brep or stl"),
+                "format");
+    const QCommandLineOption optOutputDir(
+                QStringList() << "o" << "output-dir",
+                QCoreApplication::translate(
+                    "Mayo", "Directory of output files, default is the input file directory"),
+                "dir");
+    const QCommandLineOption optFileList(
+                QStringList() << "l" << "list",
+                QCoreApplication::translate("Mayo", "File containing input paths, one per line"),
+                "file");
+    const QCommandLineOption optJobs(
+                QStringList() << "j" << "jobs",
+                QCoreApplication::translate(
+                    "Mayo", "Count of concurrent conversions, default is the count of cores"),
+                "count");
+    const QCommandLineOption optStlAscii(
+                "stl-ascii",
+                QCoreApplication::translate("Mayo", "Write STL files in ASCII format"));
+    parser.addOption(optFormat);
+    parser.addOption(optOutputDir);
+    parser.addOption(optFileList);
+    parser.addOption(optJobs);
+    parser.addOption(optStlAscii);
+    parser.addPositionalArgument(
+                "files",
+                QCoreApplication::translate(
+                    "Mayo", "Input files, wildcards are allowed in file names"),
+                "[files...]");
+    parser.process(app);
+
+    const Application::PartFormat outputFormat =
+            Internal::partFormatFromName(parser.value(optFormat));
+    if (outputFormat == Application::PartFormat::Unknown) {
+        Internal::printLine(Internal::stdErr(), "Missing or unknown output format");
+        return 1;
+    }
+
+    QStringList listInput;
+    for (const QString& arg : parser.positionalArguments())
+        listInput += Internal::expandInput(arg);
+    if (parser.isSet(optFileList)) {
+        bool ok;
+        listInput += Internal::readFileList(parser.value(optFileList), &ok);
+        if (!ok) {
+            Internal::printLine(
+                        Internal::stdErr(), "Can't read file list " + parser.value(optFileList));
+            return 1;
+        }
+    }
+
+    if (listInput.isEmpty()) {
+        Internal::printLine(Internal::stdErr(), "No input file");
+        return 1;
+    }
+
+    if (parser.isSet(optJobs)) {
+        const int jobCount = parser.value(optJobs).toInt();
+        if (jobCount > 0)
+            QThreadPool::globalInstance()->setMaxThreadCount(jobCount);
+    }
+
+    const QString outputDir = parser.value(optOutputDir);
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        Internal::printLine(Internal::stdErr(), "Can't create directory " + outputDir);
+        return 1;
+    }
+
+    std::vector<Internal::Conversion> vecConversion(listInput.size());
+    for (int i = 0; i < listInput.size(); ++i) {
+        Internal::Conversion& conv = vecConversion.at(i);
+        const QFileInfo inputInfo(listInput.at(i));
+        const QDir dir = outputDir.isEmpty() ? inputInfo.dir() : QDir(outputDir);
+        conv.inputFilePath = listInput.at(i);
+        conv.outputFilePath =
+                dir.filePath(inputInfo.completeBaseName()
+                             + "." + Internal::partFormatSuffix(outputFormat));
+    }
+
+    // Checked before any conversion starts, so no file is overwritten
+    const QStringList listCollision = Internal::findOutputCollisions(vecConversion);
+    if (!listCollision.isEmpty()) {
+        for (const QString& message : listCollision)
+            Internal::printLine(Internal::stdErr(), message);
+        return 1;
+    }
+
+    // Documents are created here, in the thread of Application
+    Application* mayoApp = Application::instance();
+    for (Internal::Conversion& conv : vecConversion) {
+        conv.doc = mayoApp->createDocument(QFileInfo(conv.inputFilePath).fileName());
+        mayoApp->addDocument(conv.doc);
+    }
+
+    // Each conversion is a task run by the global thread pool, results are
+    // reported when tasks end, in the main thread
+    const Application::ImportOptions importOpts = Application::importOptionsFromSettings();
+    const Application::ExportOptions exportOpts =
+            Internal::exportOptions(parser.isSet(optStlAscii));
+    qttask::Manager* taskMgr = qttask::Manager::globalInstance();
+    std::unordered_map<quint64, size_t> mapTaskConversion;
+    size_t endedCount = 0;
+    int failedCount = 0;
+    qint64 inputSize = 0;
+    QElapsedTimer chrono;
+    chrono.start();
+    QObject::connect(taskMgr, &qttask::Manager::ended, &app, [&](quint64 taskId) {
+        const auto itConv = mapTaskConversion.find(taskId);
+        if (itConv == mapTaskConversion.end())
+            return;
+
+        Internal::Conversion& conv = vecConversion.at(itConv->second);
+        if (conv.ok) {
+            inputSize += QFileInfo(conv.inputFilePath).size();
+            Internal::printLine(
+                        Internal::stdOut(),
+                        QString("[%1/%2] %3 -> %4 : import %5ms, export %6ms")
+                        .arg(++endedCount)
+                        .arg(vecConversion.size())
+                        .arg(conv.inputFilePath, conv.outputFilePath)
+                        .arg(conv.importTime)
+                        .arg(conv.exportTime));
+        }
+        else {
+            ++failedCount;
+            Internal::printLine(
+                        Internal::stdOut(),
+                        QString("[%1/%2] %3 FAILED : %4")
+                        .arg(++endedCount)
+                        .arg(vecConversion.size())
+                        .arg(conv.inputFilePath, conv.errorText));
+        }
+
+        mayoApp->eraseDocument(conv.doc);
+        conv.doc = nullptr;
+        if (endedCount == vecConversion.size())
+            QCoreApplication::exit(failedCount > 0 ? 2 : 0);
+    });
+
+    for (size_t i = 0; i < vecConversion.size(); ++i) {
+        Internal::Conversion* conv = &vecConversion.at(i);
+        auto task = taskMgr->newTask<QThreadPool>();
+        task->setTaskTitle(QFileInfo(conv->inputFilePath).fileName());
+        mapTaskConversion.emplace(task->taskId(), i);
+        task->run([=]{
+            const Application::PartFormat inputFormat =
+                    Application::findPartFormat(conv->inputFilePath);
+            if (inputFormat == Application::PartFormat::Unknown) {
+                conv->errorText = QCoreApplication::translate("Mayo", "Unknown input format");
+                return;
+            }
+
+            QElapsedTimer chronoFile;
+            chronoFile.start();
+            Application::IoResult result =
+                    mayoApp->importInDocument(
+                        conv->doc,
+                        inputFormat,
+                        conv->inputFilePath,
+                        importOpts,
+                        &task->progress());
+            conv->importTime = chronoFile.restart();
+            if (result) {
+                result = mayoApp->exportDocumentItems(
+                            conv->doc->rootItems(),
+                            outputFormat,
+                            exportOpts,
+                            conv->outputFilePath,
+                            &task->progress());
+                conv->exportTime = chronoFile.elapsed();
+            }
+
+            conv->ok = result.ok;
+            conv->errorText = result.errorText;
+        });
+    }
+
+    const int exitCode = app.exec();
+    const double elapsedSecs = chrono.elapsed() / 1000.;
+    const int convertedCount = static_cast<int>(vecConversion.size()) - failedCount;
+    Internal::printLine(
+                Internal::stdOut(),
+                QString("%1 file(s) converted, %2 failed, in %3s with %4 thread(s)")
+                .arg(convertedCount)
+                .arg(failedCount)
+                .arg(elapsedSecs, 0, 'f', 2)
+                .arg(QThreadPool::globalInstance()->maxThreadCount()));
+    if (elapsedSecs > 0.) {
+        Internal::printLine(
+                    Internal::stdOut(),
+                    QString("Throughput : %1 file(s)/s, %2 MB/s of input")
+                    .arg(convertedCount / elapsedSecs, 0, 'f', 2)
+                    .arg(inputSize / (1024. * 1024. * elapsedSecs), 0, 'f', 2));
+    }
+
+#ifdef HAVE_MAYO_TRACE
+    const QString traceFilePath =
+            qEnvironmentVariableIsSet("MAYO_TRACE_FILE") ?
+                QString::fromLocal8Bit(qgetenv("MAYO_TRACE_FILE")) :
+                QStringLiteral("mayo_trace.json");
+    Mayo::Trace::writeChromeJson(traceFilePath);
+#endif
+    return exitCode;
+}
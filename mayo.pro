@@ -9,7 +9,11 @@ QT += core gui widgets
 
 CONFIG += console
 
+# Scoped tracing in Chrome trace-event format, see src/trace.h
+mayo_trace:DEFINES += HAVE_MAYO_TRACE
+
 HEADERS += \
+    src/ais_triangulation.h \
     src/application.h \
     src/bnd_utils.h \
     src/button_flat.h \
@@ -30,11 +34,13 @@ HEADERS += \
     src/fougtools/qttools/gui/item_view_utils.h \
     src/fougtools/qttools/gui/proxy_styled_item_delegate.h \
     src/fougtools/qttools/gui/qwidget_utils.h \
+    src/gpx_brep_owner_index.h \
     src/gpx_document_item.h \
     src/gpx_mesh_item.h \
     src/gpx_xde_document_item.h \
     src/gui_application.h \
     src/gui_document.h \
+    src/import_cache.h \
     src/mainwindow.h \
     src/mesh_item.h \
     src/mesh_utils.h \
@@ -52,6 +58,7 @@ HEADERS += \
     src/widget_message_indicator.h \
     src/widget_occ_view.h \
     src/xde_document_item.h \
+    src/xde_part_index.h \
     src/theme.h \
     src/gpx_utils.h \
     src/math_utils.h \
@@ -62,11 +69,17 @@ HEADERS += \
     src/widget_file_system.h \
     src/document_list_model.h \
     src/application_item.h \
+    src/application_tree_model.h \
     src/brep_utils.h \
     src/libtree.h \
-    src/application_item_selection_model.h
+    src/application_item_selection_model.h \
+    src/shape_fingerprint.h \
+    src/stl_reader.h \
+    src/trace.h \
+    src/view_redraw_scheduler.h
 
 SOURCES += \
+    src/ais_triangulation.cpp \
     src/application.cpp \
     src/bnd_utils.cpp \
     src/button_flat.cpp \
@@ -84,11 +97,13 @@ SOURCES += \
     src/fougtools/qttools/gui/item_view_utils.cpp \
     src/fougtools/qttools/gui/proxy_styled_item_delegate.cpp \
     src/fougtools/qttools/gui/qwidget_utils.cpp \
+    src/gpx_brep_owner_index.cpp \
     src/gpx_document_item.cpp \
     src/gpx_mesh_item.cpp \
     src/gpx_xde_document_item.cpp \
     src/gui_application.cpp \
     src/gui_document.cpp \
+    src/import_cache.cpp \
     src/main.cpp \
     src/mainwindow.cpp \
     src/mesh_item.cpp \
@@ -105,6 +120,7 @@ SOURCES += \
     src/widget_message_indicator.cpp \
     src/widget_occ_view.cpp \
     src/xde_document_item.cpp \
+    src/xde_part_index.cpp \
     src/theme.cpp \
     src/gpx_utils.cpp \
     src/math_utils.cpp \
@@ -115,8 +131,13 @@ SOURCES += \
     src/widget_file_system.cpp \
     src/document_list_model.cpp \
     src/application_item.cpp \
+    src/application_tree_model.cpp \
     src/brep_utils.cpp \
-    src/application_item_selection_model.cpp
+    src/application_item_selection_model.cpp \
+    src/shape_fingerprint.cpp \
+    src/stl_reader.cpp \
+    src/trace.cpp \
+    src/view_redraw_scheduler.cpp
 
 include(src/fougtools/qttools/task/qttools_task.pri)
 include(src/qt-solutions/qtpropertybrowser/src/qtpropertybrowser.pri)
@@ -158,10 +179,11 @@ isEmpty(CASCADE_ROOT):error(Variable CASCADE_ROOT is empty)
 include(occ.pri)
 LIBS += -lTKernel -lTKMath -lTKTopAlgo -lTKV3d -lTKOpenGl -lTKService
 LIBS += -lTKG2d
-LIBS += -lTKBRep -lTKSTL
+LIBS += -lTKBRep -lTKSTL -lTKMesh
 LIBS += -lTKXSBase -lTKIGES -lTKSTEP -lTKXDESTEP -lTKXDEIGES
 LIBS += -lTKMeshVS -lTKXSDRAW
-LIBS += -lTKLCAF -lTKXCAF -lTKCAF
+LIBS += -lTKLCAF -lTKXCAF -lTKCAF -lTKCDF
+LIBS += -lTKBin -lTKBinL -lTKBinXCAF
 LIBS += -lTKG3d
 LIBS += -lTKGeomBase
 
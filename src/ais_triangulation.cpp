@@ -0,0 +1,279 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "ais_triangulation.h"
+
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_AspectMarker3d.hxx>
+#include <Graphic3d_Group.hxx>
+#include <gp.hxx>
+#include <OSD_Parallel.hxx>
+#include <Prs3d_Root.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <Select3D_SensitiveTriangulation.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_Selection.hxx>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+IMPLEMENT_STANDARD_RTTIEXT(Mayo::AisTriangulation, AIS_InteractiveObject)
+
+namespace Mayo {
+
+namespace Internal {
+
+// Ratio applied to triangles around their centroid in Shrink mode, same
+// default as MeshVS
+static const double shrinkCoeff = 0.8;
+
+static gp_XYZ triangleNormal(
+        const TColgp_Array1OfPnt& vecNode, const Poly_Triangle& triangle)
+{
+    int n1, n2, n3;
+    triangle.Get(n1, n2, n3);
+    const gp_XYZ& p1 = vecNode.Value(n1).XYZ();
+    const gp_XYZ v12 = vecNode.Value(n2).XYZ() - p1;
+    const gp_XYZ v13 = vecNode.Value(n3).XYZ() - p1;
+    return v12.Crossed(v13); // Magnitude is twice the triangle area
+}
+
+// Area-weighted normals at nodes, indexed from zero
+// Triangles incident to each node are stored as compressed rows, so nodes
+// can then be processed independently across all the available cores
+static std::vector<gp_Dir> computeNodeNormals(const Handle_Poly_Triangulation& mesh)
+{
+    const TColgp_Array1OfPnt& vecNode = mesh->Nodes();
+    const Poly_Array1OfTriangle& vecTriangle = mesh->Triangles();
+    const int nodeCount = mesh->NbNodes();
+    const int triangleCount = mesh->NbTriangles();
+
+    // vecNodeRowEnd[i] : end of the triangle row of node i (one-based)
+    std::vector<int> vecNodeRowEnd(nodeCount + 1, 0);
+    for (int t = 1; t <= triangleCount; ++t) {
+        int n1, n2, n3;
+        vecTriangle.Value(t).Get(n1, n2, n3);
+        ++vecNodeRowEnd[n1];
+        ++vecNodeRowEnd[n2];
+        ++vecNodeRowEnd[n3];
+    }
+
+    for (int i = 1; i <= nodeCount; ++i)
+        vecNodeRowEnd[i] += vecNodeRowEnd[i - 1];
+
+    std::vector<int> vecRowCursor(vecNodeRowEnd.begin(), vecNodeRowEnd.end() - 1);
+    std::vector<int> vecNodeTriangle(3 * size_t(triangleCount));
+    for (int t = 1; t <= triangleCount; ++t) {
+        int n1, n2, n3;
+        vecTriangle.Value(t).Get(n1, n2, n3);
+        vecNodeTriangle[vecRowCursor[n1 - 1]++] = t;
+        vecNodeTriangle[vecRowCursor[n2 - 1]++] = t;
+        vecNodeTriangle[vecRowCursor[n3 - 1]++] = t;
+    }
+
+    std::vector<gp_Dir> vecNormal(nodeCount);
+    const int threadCount = std::max(OSD_Parallel::NbLogicalProcessors(), 1);
+    const int chunkCount = std::max(std::min(4 * threadCount, nodeCount), 1);
+    OSD_Parallel::For(0, chunkCount, [&](int chunk) {
+        const int nodeBegin = static_cast<int>((int64_t(nodeCount) * chunk) / chunkCount);
+        const int nodeEnd = static_cast<int>((int64_t(nodeCount) * (chunk + 1)) / chunkCount);
+        for (int i = nodeBegin; i < nodeEnd; ++i) {
+            gp_XYZ normal;
+            for (int k = vecNodeRowEnd[i]; k < vecNodeRowEnd[i + 1]; ++k)
+                normal += triangleNormal(vecNode, vecTriangle.Value(vecNodeTriangle[k]));
+            if (normal.Modulus() > gp::Resolution())
+                vecNormal[i] = gp_Dir(normal);
+        }
+    });
+    return vecNormal;
+}
+
+static Handle_Graphic3d_ArrayOfTriangles createShrinkTriangles(
+        const Handle_Poly_Triangulation& mesh)
+{
+    const TColgp_Array1OfPnt& vecNode = mesh->Nodes();
+    const Poly_Array1OfTriangle& vecTriangle = mesh->Triangles();
+    Handle_Graphic3d_ArrayOfTriangles array =
+            new Graphic3d_ArrayOfTriangles(3 * mesh->NbTriangles(), 0, true);
+    for (int t = 1; t <= mesh->NbTriangles(); ++t) {
+        int n[3];
+        vecTriangle.Value(t).Get(n[0], n[1], n[2]);
+        const gp_XYZ centroid =
+                (vecNode.Value(n[0]).XYZ()
+                 + vecNode.Value(n[1]).XYZ()
+                 + vecNode.Value(n[2]).XYZ()) / 3.;
+        const gp_XYZ normal = triangleNormal(vecNode, vecTriangle.Value(t));
+        const gp_Dir dir =
+                normal.Modulus() > gp::Resolution() ? gp_Dir(normal) : gp::DZ();
+        for (int i = 0; i < 3; ++i) {
+            const gp_XYZ pnt =
+                    centroid + (vecNode.Value(n[i]).XYZ() - centroid) * shrinkCoeff;
+            array->AddVertex(gp_Pnt(pnt), dir);
+        }
+    }
+
+    return array;
+}
+
+} // namespace Internal
+
+AisTriangulation::AisTriangulation(const Handle_Poly_Triangulation& triangulation)
+    : m_triangulation(triangulation)
+{
+    myDrawer->SetShadingAspect(new Prs3d_ShadingAspect);
+    this->SetDisplayMode(AisTriangulation::Shaded);
+}
+
+const Handle_Poly_Triangulation& AisTriangulation::triangulation() const
+{
+    return m_triangulation;
+}
+
+bool AisTriangulation::isEdgesShown() const
+{
+    return m_isEdgesShown;
+}
+
+void AisTriangulation::setEdgesShown(bool on)
+{
+    m_isEdgesShown = on;
+}
+
+bool AisTriangulation::isNodesShown() const
+{
+    return m_isNodesShown;
+}
+
+void AisTriangulation::setNodesShown(bool on)
+{
+    m_isNodesShown = on;
+}
+
+void AisTriangulation::computePrimitiveArrays()
+{
+    if (!m_triangulation.IsNull() && m_triangulation->NbTriangles() > 0)
+        this->arrayOfTriangles();
+}
+
+void AisTriangulation::SetColor(const Quantity_Color& color)
+{
+    AIS_InteractiveObject::SetColor(color);
+    myDrawer->ShadingAspect()->SetColor(color);
+}
+
+void AisTriangulation::SetMaterial(const Graphic3d_MaterialAspect& material)
+{
+    AIS_InteractiveObject::SetMaterial(material);
+    myDrawer->ShadingAspect()->SetMaterial(material);
+}
+
+Standard_Boolean AisTriangulation::AcceptDisplayMode(const Standard_Integer mode) const
+{
+    return mode == AisTriangulation::Wireframe
+            || mode == AisTriangulation::Shaded
+            || mode == AisTriangulation::Shrink;
+}
+
+void AisTriangulation::Compute(
+        const Handle_PrsMgr_PresentationManager3d& /*prsMgr*/,
+        const Handle_Prs3d_Presentation& prs,
+        const Standard_Integer mode)
+{
+    if (m_triangulation.IsNull() || m_triangulation->NbTriangles() <= 0)
+        return;
+
+    const Handle_Graphic3d_AspectFillArea3d& shadingAspect =
+            myDrawer->ShadingAspect()->Aspect();
+    Handle_Graphic3d_AspectFillArea3d aspect =
+            new Graphic3d_AspectFillArea3d(*shadingAspect);
+    Handle_Graphic3d_ArrayOfTriangles arrayTriangles;
+    if (mode == AisTriangulation::Wireframe) {
+        aspect->SetInteriorStyle(Aspect_IS_EMPTY);
+        aspect->SetEdgeOn();
+        aspect->SetEdgeColor(shadingAspect->InteriorColor());
+        arrayTriangles = this->arrayOfTriangles();
+    }
+    else {
+        if (m_isEdgesShown) {
+            aspect->SetEdgeOn();
+            aspect->SetEdgeColor(Quantity_NOC_BLACK);
+        }
+        else {
+            aspect->SetEdgeOff();
+        }
+
+        if (mode == AisTriangulation::Shaded)
+            arrayTriangles = this->arrayOfTriangles();
+        else if (mode == AisTriangulation::Shrink)
+            arrayTriangles = Internal::createShrinkTriangles(m_triangulation);
+    }
+
+    if (arrayTriangles.IsNull())
+        return;
+
+    Handle_Graphic3d_Group groupTriangles = Prs3d_Root::CurrentGroup(prs);
+    groupTriangles->SetGroupPrimitivesAspect(aspect);
+    groupTriangles->AddPrimitiveArray(arrayTriangles);
+    if (m_isNodesShown) {
+        Handle_Graphic3d_Group groupNodes = Prs3d_Root::NewGroup(prs);
+        groupNodes->SetGroupPrimitivesAspect(
+                    new Graphic3d_AspectMarker3d(
+                        Aspect_TOM_POINT, Quantity_NOC_YELLOW, 1.));
+        groupNodes->AddPrimitiveArray(this->arrayOfNodes());
+    }
+}
+
+void AisTriangulation::ComputeSelection(
+        const Handle_SelectMgr_Selection& sel, const Standard_Integer mode)
+{
+    if (mode != 0 || m_triangulation.IsNull())
+        return;
+
+    Handle_SelectMgr_EntityOwner owner = new SelectMgr_EntityOwner(this);
+    sel->Add(new Select3D_SensitiveTriangulation(
+                 owner, m_triangulation, TopLoc_Location(), Standard_True));
+}
+
+const Handle_Graphic3d_ArrayOfTriangles& AisTriangulation::arrayOfTriangles()
+{
+    if (m_arrayTriangles.IsNull()) {
+        const TColgp_Array1OfPnt& vecNode = m_triangulation->Nodes();
+        const Poly_Array1OfTriangle& vecTriangle = m_triangulation->Triangles();
+        const std::vector<gp_Dir> vecNormal =
+                Internal::computeNodeNormals(m_triangulation);
+        m_arrayTriangles =
+                new Graphic3d_ArrayOfTriangles(
+                    m_triangulation->NbNodes(),
+                    3 * m_triangulation->NbTriangles(),
+                    true);
+        for (int i = 1; i <= m_triangulation->NbNodes(); ++i)
+            m_arrayTriangles->AddVertex(vecNode.Value(i), vecNormal[i - 1]);
+        for (int t = 1; t <= m_triangulation->NbTriangles(); ++t) {
+            int n1, n2, n3;
+            vecTriangle.Value(t).Get(n1, n2, n3);
+            m_arrayTriangles->AddEdge(n1);
+            m_arrayTriangles->AddEdge(n2);
+            m_arrayTriangles->AddEdge(n3);
+        }
+    }
+
+    return m_arrayTriangles;
+}
+
+const Handle_Graphic3d_ArrayOfPoints& AisTriangulation::arrayOfNodes()
+{
+    if (m_arrayNodes.IsNull()) {
+        const TColgp_Array1OfPnt& vecNode = m_triangulation->Nodes();
+        m_arrayNodes = new Graphic3d_ArrayOfPoints(m_triangulation->NbNodes());
+        for (int i = 1; i <= m_triangulation->NbNodes(); ++i)
+            m_arrayNodes->AddVertex(vecNode.Value(i));
+    }
+
+    return m_arrayNodes;
+}
+
+} // namespace Mayo
@@ -0,0 +1,74 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Poly_Triangulation.hxx>
+
+namespace Mayo {
+
+//! Presentation of a Poly_Triangulation built straight from its node and
+//! triangle arrays, without the intermediate element maps of MeshVS
+//!
+//! Primitive arrays are computed once on first display and then shared by
+//! all display modes. Picking relies on Select3D_SensitiveTriangulation,
+//! which is backed by a BVH tree
+class AisTriangulation : public AIS_InteractiveObject {
+public:
+    //! Same values as the matching MeshVS_DisplayModeFlags
+    enum DisplayMode {
+        Wireframe = 1,
+        Shaded = 2,
+        Shrink = 3
+    };
+
+    AisTriangulation(const Handle_Poly_Triangulation& triangulation);
+
+    const Handle_Poly_Triangulation& triangulation() const;
+
+    bool isEdgesShown() const;
+    void setEdgesShown(bool on);
+
+    bool isNodesShown() const;
+    void setNodesShown(bool on);
+
+    // Builds ahead of display the primitive array shared by the Shaded and
+    // Wireframe modes. Can be called from a worker thread as long as the
+    // object is not displayed yet
+    void computePrimitiveArrays();
+
+    void SetColor(const Quantity_Color& color) override;
+    void SetMaterial(const Graphic3d_MaterialAspect& material) override;
+    Standard_Boolean AcceptDisplayMode(const Standard_Integer mode) const override;
+
+    DEFINE_STANDARD_RTTIEXT(AisTriangulation, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle_PrsMgr_PresentationManager3d& prsMgr,
+            const Handle_Prs3d_Presentation& prs,
+            const Standard_Integer mode) override;
+    void ComputeSelection(
+            const Handle_SelectMgr_Selection& sel,
+            const Standard_Integer mode) override;
+
+private:
+    const Handle_Graphic3d_ArrayOfTriangles& arrayOfTriangles();
+    const Handle_Graphic3d_ArrayOfPoints& arrayOfNodes();
+
+    Handle_Poly_Triangulation m_triangulation;
+    Handle_Graphic3d_ArrayOfTriangles m_arrayTriangles;
+    Handle_Graphic3d_ArrayOfPoints m_arrayNodes;
+    bool m_isEdgesShown = false;
+    bool m_isNodesShown = false;
+};
+
+DEFINE_STANDARD_HANDLE(AisTriangulation, AIS_InteractiveObject)
+
+} // namespace Mayo
@@ -9,25 +9,38 @@
 #include "document.h"
 #include "document_item.h"
 #include "caf_utils.h"
+#include "import_cache.h"
 #include "xde_document_item.h"
+#include "xde_part_index.h"
 #include "mesh_item.h"
 #include "options.h"
 #include "mesh_utils.h"
+#include "stl_reader.h"
 #include "string_utils.h"
+#include "trace.h"
 #include "fougtools/qttools/task/progress.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 
+#include <BRepBndLib.hxx>
 #include <BRepGProp.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Bnd_Box.hxx>
 #include <GProp_GProps.hxx>
 #include <BRep_Builder.hxx>
 #include <BRepTools.hxx>
 #include <IGESControl_Controller.hxx>
 #include <Interface_Static.hxx>
 #include <Message_ProgressIndicator.hxx>
+#include <OSD_Parallel.hxx>
 #include <OSD_Path.hxx>
+#include <Precision.hxx>
+#include <Prs3d_Drawer.hxx>
 #include <RWStl.hxx>
+#include <STEPCAFControl_Controller.hxx>
+#include <StdPrs_ToolTriangulatedShape.hxx>
 #include <StlAPI_Writer.hxx>
 #include <Transfer_FinderProcess.hxx>
 #include <Transfer_TransientProcess.hxx>
@@ -38,8 +51,11 @@
 #include <IGESCAFControl_Writer.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
+#include <XCAFDoc_Area.hxx>
+#include <XCAFDoc_Centroid.hxx>
 #include <XCAFDoc_DocumentTool.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
+#include <XCAFDoc_Volume.hxx>
 
 #ifdef HAVE_GMIO
 #  include <gmio_core/error.h>
@@ -55,8 +71,10 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <cmath>
 #include <fstream>
 #include <mutex>
+#include <unordered_map>
 
 namespace Mayo {
 
@@ -64,6 +82,28 @@ namespace Internal {
 
 static std::mutex globalMutex;
 
+// File parsers of OpenCascade(StepFile_Read(), IGESFile_Read()) rely on static
+// C data, only one file at a time can be parsed
+static std::mutex fileParserMutex;
+
+// Registration of the XSControl controllers(and of their Interface_Static
+// parameters) isn't reentrant, it has to be done before any reader or writer
+// is created. Readers/writers call Init() again, which then is a no-op
+static void initXSControllers()
+{
+    IGESControl_Controller::Init();
+    STEPCAFControl_Controller::Init();
+}
+
+// In concurrent mode each reader works on its own XSControl_WorkSession,
+// so the whole read+transfer is no longer serialized
+static std::unique_lock<std::mutex> lockTranslation(bool concurrentTranslation)
+{
+    if (concurrentTranslation)
+        return std::unique_lock<std::mutex>();
+    return std::unique_lock<std::mutex>(globalMutex);
+}
+
 #ifdef HAVE_GMIO
 static bool gmio_qttask_is_stop_requested(void* cookie)
 {
@@ -77,9 +117,7 @@ static void gmio_qttask_handle_progress(
     auto progress = static_cast<qttask::Progress*>(cookie);
     if (progress != nullptr && maxValue > 0) {
         const auto pctNorm = value / static_cast<double>(maxValue);
-        const auto pct = qRound(pctNorm * 100);
-        if (pct >= (progress->value() + 5))
-            progress->setValue(pct);
+        progress->setValue(qRound(pctNorm * 100));
     }
 }
 
@@ -142,17 +180,37 @@ public:
         this->SetScale(0., 100., 1.);
     }
 
+#ifdef HAVE_MAYO_TRACE
+    ~OccProgress()
+    {
+        this->traceScope(Trace::now());
+    }
+#endif
+
     Standard_Boolean Show(const Standard_Boolean /*force*/) override
     {
-        const Handle_TCollection_HAsciiString name = this->GetScope(1).GetName();
-        if (!name.IsNull() && m_progress != nullptr)
-            m_progress->setStep(QString(name->ToCString()));
+        // Show() is called for each translated entity, the scope name is
+        // converted only when the scope changes
+        const Handle_TCollection_HAsciiString& name = this->GetScope(1).GetName();
+        if (name != m_scopeName) {
+#ifdef HAVE_MAYO_TRACE
+            const int64_t time = Trace::now();
+            this->traceScope(time);
+            m_scopeBeginTime = time;
+#endif
+            m_scopeName = name;
+            if (!name.IsNull() && m_progress != nullptr)
+                m_progress->setStep(QString(name->ToCString()));
+        }
+
+        if (m_progress == nullptr)
+            return Standard_True;
+
         const Standard_Real pc = this->GetPosition(); // Always within [0,1]
         const int minVal = 0;
         const int maxVal = 100;
         const int val = minVal + pc * (maxVal - minVal);
-        if (m_progress != nullptr)
-            m_progress->setValue(val);
+        m_progress->setValue(val);
         return Standard_True;
     }
 
@@ -162,36 +220,58 @@ public:
     }
 
 private:
+#ifdef HAVE_MAYO_TRACE
+    // Records the current OCCT progress scope as a trace event
+    void traceScope(int64_t endTime) const
+    {
+        if (!m_scopeName.IsNull())
+            Trace::addEvent(QString(m_scopeName->ToCString()), m_scopeBeginTime, endTime);
+    }
+
+    int64_t m_scopeBeginTime = 0;
+#endif
+
     qttask::Progress* m_progress = nullptr;
+    Handle_TCollection_HAsciiString m_scopeName;
 };
 
 template<typename READER> // Either IGESControl_Reader or STEPControl_Reader
 TopoDS_Shape loadShapeFromFile(
         const QString& filepath,
+        bool concurrentTranslation,
         IFSelect_ReturnStatus* error,
         qttask::Progress* progress)
 {
-    std::lock_guard<std::mutex> lock(globalMutex); Q_UNUSED(lock);
+    const std::unique_lock<std::mutex> lock =
+            lockTranslation(concurrentTranslation); Q_UNUSED(lock);
     Handle_Message_ProgressIndicator indicator = new OccProgress(progress);
     TopoDS_Shape result;
 
     if (!indicator.IsNull())
         indicator->NewScope(30, "Loading file");
-    READER reader;
-    *error = reader.ReadFile(filepath.toLocal8Bit().constData());
+    const Handle_XSControl_WorkSession ws = new XSControl_WorkSession;
+    READER reader(ws);
+    {
+        std::lock_guard<std::mutex> lockParser(fileParserMutex); Q_UNUSED(lockParser);
+        Mayo_TraceScope("ReadFile");
+        *error = reader.ReadFile(filepath.toLocal8Bit().constData());
+    }
     if (!indicator.IsNull())
         indicator->EndScope();
     if (*error == IFSelect_RetDone) {
         if (!indicator.IsNull()) {
-            reader.WS()->MapReader()->SetProgress(indicator);
+            ws->MapReader()->SetProgress(indicator);
             indicator->NewScope(70, "Translating file");
         }
-        reader.NbRootsForTransfer();
-        reader.TransferRoots();
-        result = reader.OneShape();
+        {
+            Mayo_TraceScope("Transfer");
+            reader.NbRootsForTransfer();
+            reader.TransferRoots();
+            result = reader.OneShape();
+        }
         if (!indicator.IsNull()) {
             indicator->EndScope();
-            reader.WS()->MapReader()->SetProgress(nullptr);
+            ws->MapReader()->SetProgress(nullptr);
         }
     }
     return result;
@@ -201,17 +281,11 @@ template<typename CAF_READER> struct CafReaderTraits {};
 
 template<> struct CafReaderTraits<IGESCAFControl_Reader> {
     using ReaderType = IGESCAFControl_Reader;
-    static Handle_XSControl_WorkSession workSession(const ReaderType& reader) {
-        return reader.WS();
-    }
     static void setPropsMode(ReaderType*, bool) { /* N/A */ }
 };
 
 template<> struct CafReaderTraits<STEPCAFControl_Reader> {
     using ReaderType = STEPCAFControl_Reader;
-    static Handle_XSControl_WorkSession workSession(const ReaderType& reader) {
-        return reader.Reader().WS();
-    }
     static void setPropsMode(ReaderType* reader, bool on) {
         reader->SetPropsMode(on);
     }
@@ -220,32 +294,40 @@ template<> struct CafReaderTraits<STEPCAFControl_Reader> {
 template<typename CAF_READER> // Either IGESCAFControl_Reader or STEPCAFControl_Reader
 void loadCafDocumentFromFile(
         const QString& filepath,
+        bool concurrentTranslation,
         Handle_TDocStd_Document& doc,
         IFSelect_ReturnStatus* error,
         qttask::Progress* progress)
 {
-    std::lock_guard<std::mutex> lock(globalMutex); Q_UNUSED(lock);
+    const std::unique_lock<std::mutex> lock =
+            lockTranslation(concurrentTranslation); Q_UNUSED(lock);
     Handle_Message_ProgressIndicator indicator = new OccProgress(progress);
 
     if (!indicator.IsNull())
         indicator->NewScope(30, "Loading file");
-    CAF_READER reader;
+    const Handle_XSControl_WorkSession ws = new XSControl_WorkSession;
+    CAF_READER reader(ws);
     reader.SetColorMode(true);
     reader.SetNameMode(true);
     reader.SetLayerMode(true);
     CafReaderTraits<CAF_READER>::setPropsMode(&reader, true);
-    *error = reader.ReadFile(filepath.toLocal8Bit().constData());
+    {
+        std::lock_guard<std::mutex> lockParser(fileParserMutex); Q_UNUSED(lockParser);
+        Mayo_TraceScope("ReadFile");
+        *error = reader.ReadFile(filepath.toLocal8Bit().constData());
+    }
     if (!indicator.IsNull())
         indicator->EndScope();
     if (*error == IFSelect_RetDone) {
-        Handle_XSControl_WorkSession ws =
-                CafReaderTraits<CAF_READER>::workSession(reader);
         if (!indicator.IsNull()) {
             ws->MapReader()->SetProgress(indicator);
             indicator->NewScope(70, "Translating file");
         }
-        if (reader.Transfer(doc) == Standard_False)
-            *error = IFSelect_RetFail;
+        {
+            Mayo_TraceScope("Transfer");
+            if (reader.Transfer(doc) == Standard_False)
+                *error = IFSelect_RetFail;
+        }
         if (!indicator.IsNull()) {
             indicator->EndScope();
             ws->MapReader()->SetProgress(nullptr);
@@ -274,22 +356,237 @@ static TopoDS_Shape xdeDocumentWholeShape(const XdeDocumentItem* xdeDocItem)
 static MeshItem* createMeshItem(
         const QString& filepath, const Handle_Poly_Triangulation& mesh)
 {
+    Mayo_TraceScope("createMeshItem");
     auto partItem = new MeshItem;
+    Mayo_PropertyTransaction(partItem);
     partItem->propertyLabel.setValue(QFileInfo(filepath).baseName());
     partItem->propertyNodeCount.setValue(mesh->NbNodes());
     partItem->propertyTriangleCount.setValue(mesh->NbTriangles());
-    partItem->propertyVolume.setQuantity(
-                occ::MeshUtils::triangulationVolume(mesh) * Quantity_CubicMillimeter);
-    partItem->propertyArea.setQuantity(
-                occ::MeshUtils::triangulationArea(mesh) * Quantity_SquaredMillimeter);
+    partItem->setMassProperties(occ::MeshUtils::triangulationMassProperties(mesh));
     partItem->setTriangulation(mesh);
     return partItem;
 }
 
+struct XdeMassProperties {
+    double volume = 0.;
+    double area = 0.;
+    gp_XYZ volumeMoment; // volume * centroid
+    gp_XYZ areaMoment; // area * centroid
+
+    // Centroid of volume, or of surface for shapes without volume
+    gp_Pnt centroid() const {
+        if (std::abs(this->volume) > Precision::Confusion())
+            return gp_Pnt(this->volumeMoment / this->volume);
+        if (std::abs(this->area) > Precision::Confusion())
+            return gp_Pnt(this->areaMoment / this->area);
+        return gp_Pnt();
+    }
+
+    // Adds an instance of 'other' placed with 'trsf'
+    void addInstance(const XdeMassProperties& other, const gp_Trsf& trsf) {
+        auto fnTransformMoment = [&](const gp_XYZ& moment, double weight) {
+            if (std::abs(weight) <= Precision::Confusion())
+                return gp_XYZ();
+            gp_XYZ coords = moment / weight;
+            trsf.Transforms(coords);
+            return coords * weight;
+        };
+        this->volumeMoment += fnTransformMoment(other.volumeMoment, other.volume);
+        this->areaMoment += fnTransformMoment(other.areaMoment, other.area);
+        this->volume += other.volume;
+        this->area += other.area;
+    }
+};
+
+using MapXdeMassProperties = std::unordered_map<TDF_Label, XdeMassProperties>;
+
+// Collects the shapes referred by assemblies(prototypes), each one only once
+static void deepCollectXdePrototypes(
+        const XdeDocumentItem* xdeDocItem,
+        const TDF_Label& label,
+        std::vector<TDF_Label>* ptrVecPrototype,
+        MapXdeMassProperties* ptrMapProps)
+{
+    if (ptrMapProps->find(label) != ptrMapProps->cend())
+        return;
+    if (xdeDocItem->isShapeAssembly(label)) {
+        for (const TDF_Label& component : xdeDocItem->shapeComponents(label)) {
+            deepCollectXdePrototypes(
+                        xdeDocItem,
+                        xdeDocItem->shapeReferred(component),
+                        ptrVecPrototype,
+                        ptrMapProps);
+        }
+    }
+    else {
+        ptrMapProps->emplace(label, XdeMassProperties());
+        ptrVecPrototype->push_back(label);
+    }
+}
+
+// Properties of an assembly are the sum over its component instances, so
+// prototypes shared by several instances are only computed once
+static const XdeMassProperties& deepXdeAssemblyMassProperties(
+        const XdeDocumentItem* xdeDocItem,
+        const TDF_Label& label,
+        MapXdeMassProperties* ptrMapProps)
+{
+    auto itProps = ptrMapProps->find(label);
+    if (itProps != ptrMapProps->end())
+        return itProps->second;
+
+    XdeMassProperties props;
+    for (const TDF_Label& component : xdeDocItem->shapeComponents(label)) {
+        const XdeMassProperties& componentProps =
+                deepXdeAssemblyMassProperties(
+                    xdeDocItem, xdeDocItem->shapeReferred(component), ptrMapProps);
+        props.addInstance(
+                    componentProps,
+                    xdeDocItem->shapeReferenceLocation(component).Transformation());
+    }
+    return ptrMapProps->emplace(label, props).first->second;
+}
+
+// Computes mass properties of each prototype in parallel, then of assemblies
+// Prototypes found in 'vecPart' aren't computed again, their properties were
+// obtained by fingerprinting
+// Results are stored as XDE validation attributes(when not already provided
+// by the imported file), totals of the free shapes are returned
+static XdeMassProperties computeXdeMassProperties(
+        XdeDocumentItem* xdeDocItem, const std::vector<XdePartIndex::Part>& vecPart)
+{
+    Mayo_TraceScope("computeXdeMassProperties");
+    MapXdeMassProperties mapProps;
+    for (const XdePartIndex::Part& part : vecPart) {
+        // Part properties ignore the own location of the shape
+        XdeMassProperties partProps;
+        partProps.volume = std::abs(part.massProps.volume);
+        partProps.volumeMoment = part.massProps.volumeCentroid.XYZ() * partProps.volume;
+        partProps.area = std::abs(part.massProps.area);
+        partProps.areaMoment = part.massProps.areaCentroid.XYZ() * partProps.area;
+        const TopLoc_Location shapeLoc = xdeDocItem->shape(part.label).Location();
+        mapProps[part.label].addInstance(partProps, shapeLoc.Transformation());
+    }
+
+    std::vector<TDF_Label> vecPrototype;
+    const std::vector<TDF_Label> vecFreeShape = xdeDocItem->topLevelFreeShapes();
+    for (const TDF_Label& label : vecFreeShape)
+        deepCollectXdePrototypes(xdeDocItem, label, &vecPrototype, &mapProps);
+
+    // OCAF data is only read by the main loop, workers deal with shapes
+    std::vector<TopoDS_Shape> vecPrototypeShape;
+    vecPrototypeShape.reserve(vecPrototype.size());
+    for (const TDF_Label& label : vecPrototype)
+        vecPrototypeShape.push_back(xdeDocItem->shape(label));
+
+    std::vector<XdeMassProperties> vecPrototypeProps(vecPrototype.size());
+    OSD_Parallel::For(0, static_cast<int>(vecPrototype.size()), [&](int i) {
+        const TopoDS_Shape& shape = vecPrototypeShape.at(i);
+        XdeMassProperties& props = vecPrototypeProps.at(i);
+        // Solids with reversed orientation give negative mass, magnitude is
+        // kept so they don't cancel out other parts of the assembly
+        GProp_GProps system;
+        BRepGProp::VolumeProperties(shape, system);
+        props.volume = std::abs(system.Mass());
+        props.volumeMoment = system.CentreOfMass().XYZ() * props.volume;
+        system = GProp_GProps();
+        BRepGProp::SurfaceProperties(shape, system);
+        props.area = std::abs(system.Mass());
+        props.areaMoment = system.CentreOfMass().XYZ() * props.area;
+    });
+    for (size_t i = 0; i < vecPrototype.size(); ++i)
+        mapProps[vecPrototype.at(i)] = vecPrototypeProps.at(i);
+
+    XdeMassProperties totalProps;
+    for (const TDF_Label& label : vecFreeShape) {
+        totalProps.addInstance(
+                    deepXdeAssemblyMassProperties(xdeDocItem, label, &mapProps),
+                    gp_Trsf());
+    }
+
+    for (const auto& labelProps : mapProps) {
+        const TDF_Label& label = labelProps.first;
+        const XdeMassProperties& props = labelProps.second;
+        const XdeDocumentItem::ValidationProperties validationProps =
+                xdeDocItem->validationProperties(label);
+        if (!validationProps.hasVolume)
+            XCAFDoc_Volume::Set(label, props.volume);
+        if (!validationProps.hasArea)
+            XCAFDoc_Area::Set(label, props.area);
+        if (!validationProps.hasCentroid)
+            XCAFDoc_Centroid::Set(label, props.centroid());
+    }
+
+    return totalProps;
+}
+
+// Meshing stage : BRep faces are triangulated by the import thread, so display
+// only has to build presentations from existing triangulations
+// Deflection and angle are the ones AIS computes for the presentation of the
+// whole shape, with the deviation coefficient 'deflectionCoeff'(see
+// GpxDocumentItem::initForGpxBRepShape()). So AIS considers the shape as
+// tessellated and doesn't mesh it again in the GUI thread
+// Parts shared with other items are already meshed and may be displayed, they
+// are excluded
+static void meshXdeDocumentItem(
+        const XdeDocumentItem* xdeDocItem,
+        const std::vector<XdePartIndex::Part>& vecPart,
+        double deflectionCoeff,
+        qttask::Progress* progress)
+{
+    const TopoDS_Shape shape = xdeDocumentWholeShape(xdeDocItem);
+    if (deflectionCoeff <= 0 || shape.IsNull())
+        return;
+
+    Bnd_Box bndBox;
+    BRepBndLib::Add(shape, bndBox);
+    if (bndBox.IsVoid())
+        return;
+
+    const Handle_Prs3d_Drawer drawer = new Prs3d_Drawer;
+    drawer->SetTypeOfDeflection(Aspect_TOD_RELATIVE);
+    drawer->SetDeviationCoefficient(deflectionCoeff);
+    const double deflection = StdPrs_ToolTriangulatedShape::GetDeflection(shape, drawer);
+    const bool hasPartOfOtherItem =
+            std::any_of(vecPart.cbegin(), vecPart.cend(), [](const XdePartIndex::Part& part) {
+        return part.isSharedWithOtherItem;
+    });
+    TopoDS_Shape shapeToMesh = shape;
+    if (hasPartOfOtherItem) {
+        TopoDS_Compound cmpd;
+        BRep_Builder builder;
+        builder.MakeCompound(cmpd);
+        for (const XdePartIndex::Part& part : vecPart) {
+            if (!part.isSharedWithOtherItem)
+                builder.Add(cmpd, xdeDocItem->shape(part.label));
+        }
+        shapeToMesh = cmpd;
+    }
+
+    if (progress != nullptr)
+        progress->setStep(Application::tr("Meshing"));
+    Mayo_TraceScope("BRepMesh_IncrementalMesh");
+    BRepMesh_IncrementalMesh mesher(
+                shapeToMesh,
+                deflection,
+                Standard_False, // Absolute deflection
+                drawer->DeviationAngle(),
+                Standard_True); // Faces are meshed in parallel
+}
+
+// Volume and area are taken from 'cacheEntry' when not null, otherwise they
+// are computed. BRep shapes are meshed, once copies of parts are shared when
+// ImportOptions::partSharing is on
 static XdeDocumentItem* createXdeDocumentItem(
-        const QString& filepath, const Handle_TDocStd_Document& cafDoc)
+        const QString& filepath,
+        const Handle_TDocStd_Document& cafDoc,
+        const Application::ImportOptions& options,
+        qttask::Progress* progress,
+        const ImportCache::Entry* cacheEntry = nullptr)
 {
+    Mayo_TraceScope("createXdeDocumentItem");
     auto xdeDocItem = new XdeDocumentItem(cafDoc);
+    Mayo_PropertyTransaction(xdeDocItem);
     xdeDocItem->propertyLabel.setValue(QFileInfo(filepath).baseName());
 
     const Handle_XCAFDoc_ShapeTool& shapeTool = xdeDocItem->shapeTool();
@@ -302,18 +599,79 @@ static XdeDocumentItem* createXdeDocumentItem(
         xdeDocItem->rebuildAssemblyTree();
     }
 
-    const TopoDS_Shape shape = xdeDocumentWholeShape(xdeDocItem);
-    GProp_GProps system;
-    BRepGProp::VolumeProperties(shape, system);
-    xdeDocItem->propertyVolume.setQuantity(
-                std::max(system.Mass(), 0.) * Quantity_CubicMillimeter);
-    BRepGProp::SurfaceProperties(shape, system);
-    xdeDocItem->propertyArea.setQuantity(
-                std::max(system.Mass(), 0.) * Quantity_SquaredMillimeter);
+    XdePartIndex* partIndex = XdePartIndex::instance();
+    const bool isPartSharingOn = options.partSharing;
+    std::vector<XdePartIndex::Part> vecPart;
+    if (isPartSharingOn)
+        vecPart = partIndex->addParts(xdeDocItem);
+
+    if (cacheEntry != nullptr) {
+        xdeDocItem->propertyVolume.setQuantity(
+                    cacheEntry->volume * Quantity_CubicMillimeter);
+        xdeDocItem->propertyArea.setQuantity(
+                    cacheEntry->area * Quantity_SquaredMillimeter);
+    }
+    else {
+        const XdeMassProperties massProps = computeXdeMassProperties(xdeDocItem, vecPart);
+        xdeDocItem->propertyVolume.setQuantity(
+                    massProps.volume * Quantity_CubicMillimeter);
+        xdeDocItem->propertyArea.setQuantity(
+                    massProps.area * Quantity_SquaredMillimeter);
+    }
+
+    meshXdeDocumentItem(xdeDocItem, vecPart, options.meshingDeflection, progress);
+    if (isPartSharingOn)
+        partIndex->publishParts(xdeDocItem);
 
     return xdeDocItem;
 }
 
+// Imports IGES/STEP file into 'doc', translation is skipped when the file is
+// found in the import cache
+template<typename CAF_READER> // Either IGESCAFControl_Reader or STEPCAFControl_Reader
+Application::IoResult importCafFile(
+        Document* doc,
+        const QString& filepath,
+        const Application::ImportOptions& options,
+        qttask::Progress* progress)
+{
+    ImportCache* cache = ImportCache::instance();
+    const ImportCache::Key cacheKey =
+            options.useCache ? ImportCache::fileKey(filepath) : ImportCache::Key();
+    ImportCache::Entry cacheEntry;
+    if (cacheKey.isValid() && cache->find(options.cacheDirPath, cacheKey, &cacheEntry)) {
+        XdeDocumentItem* xdeDocItem =
+                createXdeDocumentItem(
+                    filepath, cacheEntry.cafDoc, options, progress, &cacheEntry);
+        doc->addRootItem(xdeDocItem);
+        return { true, QString() };
+    }
+
+    QElapsedTimer chrono;
+    chrono.start();
+    Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
+    IFSelect_ReturnStatus err;
+    loadCafDocumentFromFile<CAF_READER>(
+                filepath, options.concurrentTranslation, cafDoc, &err, progress);
+    if (err == IFSelect_RetDone) {
+        XdeDocumentItem* xdeDocItem =
+                createXdeDocumentItem(filepath, cafDoc, options, progress);
+        if (cacheKey.isValid()) {
+            cacheEntry.cafDoc = cafDoc;
+            cacheEntry.volume = xdeDocItem->propertyVolume.quantity().value();
+            cacheEntry.area = xdeDocItem->propertyArea.quantity().value();
+            cache->insert(
+                        options.cacheDirPath,
+                        options.cacheMaxSize,
+                        cacheKey,
+                        cacheEntry,
+                        chrono.elapsed());
+        }
+        doc->addRootItem(xdeDocItem);
+    }
+    return { err == IFSelect_RetDone, StringUtils::rawText(err) };
+}
+
 template<size_t N>
 bool matchToken(const char* buffer, const char (&token)[N])
 {
@@ -413,9 +771,11 @@ Application::PartFormat findPartFormatFromContents(
 
 } // namespace Internal
 
+// Application is created by the GUI thread, before any import/export task
 Application::Application(QObject *parent)
     : QObject(parent)
 {
+    Internal::initXSControllers();
 }
 
 Application *Application::instance()
@@ -455,6 +815,9 @@ Document *Application::createDocument(const QString &label)
     QObject::connect(
                 doc, &Document::itemAdded,
                 this, &Application::documentItemAdded);
+    QObject::connect(
+                doc, &Document::itemsAdded,
+                this, &Application::documentItemsAdded);
     QObject::connect(
                 doc, &Document::itemPropertyChanged,
                 this, &Application::documentItemPropertyChanged);
@@ -475,6 +838,14 @@ bool Application::eraseDocument(Document *doc)
     auto itFound = std::find(m_documents.cbegin(), m_documents.cend(), doc);
     if (itFound != m_documents.cend()) {
         m_documents.erase(itFound);
+        // Indexed parts keep their topology alive
+        for (const DocumentItem* item : doc->rootItems()) {
+            if (sameType<XdeDocumentItem>(item)) {
+                auto xdeDocItem = static_cast<const XdeDocumentItem*>(item);
+                XdePartIndex::instance()->removeParts(xdeDocItem);
+            }
+        }
+
         doc->deleteLater();
         emit documentErased(doc);
         return true;
@@ -495,18 +866,36 @@ Application::findDocumentByLocation(const QFileInfo& loc) const
     return itDocFound;
 }
 
+Application::ImportOptions Application::importOptionsFromSettings()
+{
+    const Options* opts = Options::instance();
+    ImportOptions options;
+    options.concurrentTranslation = opts->isConcurrentImportOn();
+    options.useCache = opts->isImportCacheOn();
+    options.cacheDirPath = opts->importCacheDir();
+    options.cacheMaxSize = static_cast<qint64>(opts->importCacheMaxSize()) * 1024 * 1024;
+    options.meshingDeflection = opts->importMeshingDeflection();
+    options.partSharing = opts->isImportPartSharingOn();
+    options.stlIoLibrary = opts->stlIoLibrary();
+    options.stlWeldTolerance = opts->stlWeldTolerance();
+    return options;
+}
+
 Application::IoResult Application::importInDocument(
         Document* doc,
         PartFormat format,
         const QString &filepath,
+        const ImportOptions& options,
         qttask::Progress* progress)
 {
-    progress->setStep(QFileInfo(filepath).fileName());
+    Mayo_TraceScope("Application::importInDocument");
+    if (progress != nullptr)
+        progress->setStep(QFileInfo(filepath).fileName());
     switch (format) {
-    case PartFormat::Iges: return this->importIges(doc, filepath, progress);
-    case PartFormat::Step: return this->importStep(doc, filepath, progress);
-    case PartFormat::OccBrep: return this->importOccBRep(doc, filepath, progress);
-    case PartFormat::Stl: return this->importStl(doc, filepath, progress);
+    case PartFormat::Iges: return this->importIges(doc, filepath, options, progress);
+    case PartFormat::Step: return this->importStep(doc, filepath, options, progress);
+    case PartFormat::OccBrep: return this->importOccBRep(doc, filepath, options, progress);
+    case PartFormat::Stl: return this->importStl(doc, filepath, options, progress);
     case PartFormat::Unknown: break;
     }
     return { false, tr("Unknown error") };
@@ -519,7 +908,9 @@ Application::IoResult Application::exportDocumentItems(
         const QString &filepath,
         qttask::Progress *progress)
 {
-    progress->setStep(QFileInfo(filepath).fileName());
+    Mayo_TraceScope("Application::exportDocumentItems");
+    if (progress != nullptr)
+        progress->setStep(QFileInfo(filepath).fileName());
     switch (format) {
     case PartFormat::Iges:
         return this->exportIges(docItems, options, filepath, progress);
@@ -593,83 +984,115 @@ Application::PartFormat Application::findPartFormat(const QString &filepath)
 }
 
 Application::IoResult Application::importIges(
-        Document* doc, const QString &filepath, qttask::Progress* progress)
+        Document* doc,
+        const QString &filepath,
+        const ImportOptions& options,
+        qttask::Progress* progress)
 {
-    IGESControl_Controller::Init();
-    Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
-    IFSelect_ReturnStatus err;
-    Internal::loadCafDocumentFromFile<IGESCAFControl_Reader>(
-                filepath, cafDoc, &err, progress);
-    if (err == IFSelect_RetDone)
-        doc->addRootItem(Internal::createXdeDocumentItem(filepath, cafDoc));
-    return { err == IFSelect_RetDone, StringUtils::rawText(err) };
+    return Internal::importCafFile<IGESCAFControl_Reader>(doc, filepath, options, progress);
 }
 
 Application::IoResult Application::importStep(
-        Document* doc, const QString &filepath, qttask::Progress* progress)
+        Document* doc,
+        const QString &filepath,
+        const ImportOptions& options,
+        qttask::Progress* progress)
 {
-    Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
-    IFSelect_ReturnStatus err;
-    Internal::loadCafDocumentFromFile<STEPCAFControl_Reader>(
-                filepath, cafDoc, &err, progress);
-    if (err == IFSelect_RetDone)
-        doc->addRootItem(Internal::createXdeDocumentItem(filepath, cafDoc));
-    return { err == IFSelect_RetDone, StringUtils::rawText(err) };
+    return Internal::importCafFile<STEPCAFControl_Reader>(doc, filepath, options, progress);
 }
 
 Application::IoResult Application::importOccBRep(
-        Document* doc, const QString &filepath, qttask::Progress* progress)
+        Document* doc,
+        const QString &filepath,
+        const ImportOptions& options,
+        qttask::Progress* progress)
 {
     TopoDS_Shape shape;
     BRep_Builder brepBuilder;
     Handle_Message_ProgressIndicator indicator = new Internal::OccProgress(progress);
-    const bool ok = BRepTools::Read(
-            shape, filepath.toLocal8Bit().constData(), brepBuilder, indicator);
+    bool ok = false;
+    {
+        Mayo_TraceScope("BRepTools::Read");
+        ok = BRepTools::Read(
+                    shape, filepath.toLocal8Bit().constData(), brepBuilder, indicator);
+    }
     if (ok) {
         Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
         Handle_XCAFDoc_ShapeTool shapeTool =
                 XCAFDoc_DocumentTool::ShapeTool(cafDoc->Main());
         const TDF_Label labelShape = shapeTool->NewShape();
         shapeTool->SetShape(labelShape, shape);
-        doc->addRootItem(Internal::createXdeDocumentItem(filepath, cafDoc));
+        XdeDocumentItem* xdeDocItem =
+                Internal::createXdeDocumentItem(filepath, cafDoc, options, progress);
+        doc->addRootItem(xdeDocItem);
     }
     return { ok, ok ? QString() : tr("Unknown Error") };
 }
 
 Application::IoResult Application::importStl(
-        Document* doc, const QString &filepath, qttask::Progress* progress)
+        Document* doc,
+        const QString &filepath,
+        const ImportOptions& options,
+        qttask::Progress* progress)
 {
     Application::IoResult result = { false, QString() };
-    const Options::StlIoLibrary lib =
-            Options::instance()->stlIoLibrary();
+    const Options::StlIoLibrary lib = options.stlIoLibrary;
     if (lib == Options::StlIoLibrary::Gmio) {
 #ifdef HAVE_GMIO
         QFile file(filepath);
         if (file.open(QIODevice::ReadOnly)) {
             gmio_stream stream = gmio_stream_qiodevice(&file);
-            gmio_stl_read_options options = {};
-            options.func_stla_get_streamsize = &gmio_stla_infos_probe_streamsize;
-            options.task_iface = Internal::gmio_qttask_create_task_iface(progress);
+            gmio_stl_read_options gmioOptions = {};
+            gmioOptions.func_stla_get_streamsize = &gmio_stla_infos_probe_streamsize;
+            gmioOptions.task_iface = Internal::gmio_qttask_create_task_iface(progress);
             int err = GMIO_ERROR_OK;
+            std::vector<DocumentItem*> vecItem;
             while (gmio_no_error(err) && !file.atEnd()) {
                 gmio_stl_mesh_creator_occpolytri meshcreator;
-                err = gmio_stl_read(&stream, &meshcreator, &options);
+                {
+                    Mayo_TraceScope("gmio_stl_read");
+                    err = gmio_stl_read(&stream, &meshcreator, &gmioOptions);
+                }
                 if (gmio_no_error(err)) {
                     const Handle_Poly_Triangulation& mesh = meshcreator.polytri();
-                    doc->addRootItem(Internal::createMeshItem(filepath, mesh));
+                    vecItem.push_back(Internal::createMeshItem(filepath, mesh));
                 }
             }
+            doc->addRootItems(vecItem);
             result.ok = (err == GMIO_ERROR_OK);
             if (!result.ok)
                 result.errorText = Internal::gmioErrorToQString(err);
         }
 #endif // HAVE_GMIO
     }
+    else if (lib == Options::StlIoLibrary::Native) {
+        StlReader::Parameters params;
+        const double weldTolerance = options.stlWeldTolerance;
+        if (weldTolerance > 0) {
+            params.vertexWeld = StlReader::VertexWeld::Epsilon;
+            params.weldEpsilon = weldTolerance;
+        }
+
+        StlReader::Result readResult;
+        {
+            Mayo_TraceScope("StlReader::read");
+            readResult = StlReader::read(filepath, params, progress);
+        }
+        std::vector<DocumentItem*> vecItem;
+        for (const StlReader::Solid& solid : readResult.solids)
+            vecItem.push_back(Internal::createMeshItem(filepath, solid.mesh));
+        doc->addRootItems(vecItem);
+        result.ok = readResult.ok;
+        result.errorText = readResult.errorText;
+    }
     else if (lib == Options::StlIoLibrary::OpenCascade) {
         Handle_Message_ProgressIndicator indicator =
                     new Internal::OccProgress(progress);
-        const Handle_Poly_Triangulation mesh = RWStl::ReadFile(
-                    OSD_Path(filepath.toLocal8Bit().constData()), indicator);
+        Handle_Poly_Triangulation mesh;
+        {
+            Mayo_TraceScope("RWStl::ReadFile");
+            mesh = RWStl::ReadFile(OSD_Path(filepath.toLocal8Bit().constData()), indicator);
+        }
         if (!mesh.IsNull())
             doc->addRootItem(Internal::createMeshItem(filepath, mesh));
         result.ok = !mesh.IsNull();
@@ -685,10 +1108,11 @@ Application::IoResult Application::exportIges(
         const QString &filepath,
         qttask::Progress *progress)
 {
+    // Writers aren't known to be safe for concurrent use, unlike readers in
+    // concurrent translation mode, so exports are serialized whatever the
+    // option. Controllers were registered at startup
     std::lock_guard<std::mutex> lock(Internal::globalMutex); Q_UNUSED(lock);
     Handle_Message_ProgressIndicator indicator = new Internal::OccProgress(progress);
-
-    IGESControl_Controller::Init();
     IGESCAFControl_Writer writer;
     writer.SetColorMode(Standard_True);
     writer.SetNameMode(Standard_True);
@@ -713,6 +1137,7 @@ Application::IoResult Application::exportStep(
         const QString &filepath,
         qttask::Progress *progress)
 {
+    // Serialized, see exportIges()
     std::lock_guard<std::mutex> lock(Internal::globalMutex); Q_UNUSED(lock);
     Handle_Message_ProgressIndicator indicator = new Internal::OccProgress(progress);
     STEPCAFControl_Writer writer;
@@ -772,11 +1197,14 @@ Application::IoResult Application::exportStl(
         const QString &filepath,
         qttask::Progress *progress)
 {
-    const Options::StlIoLibrary lib = Options::instance()->stlIoLibrary();
+    const Options::StlIoLibrary lib = options.stlIoLibrary;
     if (lib == Options::StlIoLibrary::Gmio)
         return this->exportStl_gmio(docItems, options, filepath, progress);
-    else if (lib == Options::StlIoLibrary::OpenCascade)
+    else if (lib == Options::StlIoLibrary::OpenCascade
+             || lib == Options::StlIoLibrary::Native)
+    {
         return this->exportStl_OCC(docItems, options, filepath, progress);
+    }
     return { false, tr("Unknown Error") };
 }
 
@@ -10,6 +10,7 @@
 #  include <gmio_core/text_format.h>
 #  include <gmio_stl/stl_format.h>
 #endif
+#include "options.h"
 #include <QtCore/QObject>
 #include <string>
 #include <vector>
@@ -41,14 +42,28 @@ public:
         operator bool() const { return ok; }
     };
 
+    // Settings of import tasks, see importOptionsFromSettings()
+    struct ImportOptions {
+        bool concurrentTranslation = true;
+        bool useCache = false;
+        QString cacheDirPath;
+        qint64 cacheMaxSize = 0; // Bytes
+        double meshingDeflection = 0.; // Relative to the size of the shape
+        bool partSharing = false;
+        Options::StlIoLibrary stlIoLibrary = Options::StlIoLibrary::OpenCascade;
+        double stlWeldTolerance = 0.;
+    };
+
     struct ExportOptions {
 #ifdef HAVE_GMIO
+        Options::StlIoLibrary stlIoLibrary = Options::StlIoLibrary::Gmio;
         gmio_stl_format stlFormat = GMIO_STL_FORMAT_UNKNOWN;
         std::string stlaSolidName;
         gmio_float_text_format stlaFloat32Format =
                 GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE;
         uint8_t stlaFloat32Precision = 9;
 #else
+        Options::StlIoLibrary stlIoLibrary = Options::StlIoLibrary::OpenCascade;
         enum class StlFormat {
             Ascii,
             Binary
@@ -78,10 +93,15 @@ public:
     static QStringList partFormatFilters();
     static PartFormat findPartFormat(const QString& filepath);
 
+    // Reads Options, so it must be called by the GUI thread, import tasks
+    // then get a copy of the result
+    static ImportOptions importOptionsFromSettings();
+
     IoResult importInDocument(
             Document* doc,
             PartFormat format,
             const QString& filepath,
+            const ImportOptions& options,
             qttask::Progress* progress = nullptr);
     IoResult exportDocumentItems(
             const std::vector<DocumentItem*>& docItems,
@@ -95,6 +115,7 @@ signals:
     void documentAdded(Document* doc);
     void documentErased(const Document* doc);
     void documentItemAdded(DocumentItem* docItem);
+    void documentItemsAdded(const std::vector<DocumentItem*>& docItems);
     void documentItemPropertyChanged(
             const DocumentItem* docItem, const Property* prop);
 
@@ -103,13 +124,25 @@ private:
     Application(QObject* parent = nullptr);
 
     IoResult importIges(
-            Document* doc, const QString& filepath, qttask::Progress* progress);
+            Document* doc,
+            const QString& filepath,
+            const ImportOptions& options,
+            qttask::Progress* progress);
     IoResult importStep(
-            Document* doc, const QString& filepath, qttask::Progress* progress);
+            Document* doc,
+            const QString& filepath,
+            const ImportOptions& options,
+            qttask::Progress* progress);
     IoResult importOccBRep(
-            Document* doc, const QString& filepath, qttask::Progress* progress);
+            Document* doc,
+            const QString& filepath,
+            const ImportOptions& options,
+            qttask::Progress* progress);
     IoResult importStl(
-            Document* doc, const QString& filepath, qttask::Progress* progress);
+            Document* doc,
+            const QString& filepath,
+            const ImportOptions& options,
+            qttask::Progress* progress);
 
     IoResult exportIges(
             const std::vector<DocumentItem*>& docItems,
@@ -0,0 +1,403 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "application_tree_model.h"
+
+#include "application.h"
+#include "document.h"
+#include "document_item.h"
+#include "mesh_item.h"
+#include "xde_document_item.h"
+
+#include <QtGui/QIcon>
+
+#include <algorithm>
+
+namespace Mayo {
+
+struct ApplicationTreeModel::Node {
+    Node* parent = nullptr;
+    int row = 0;
+    ApplicationItem item;
+    // Assembly node providing the children and the icon. It differs from the
+    // assembly node of 'item' when a reference is merged with its referred shape
+    XdeDocumentItem::AssemblyNodeId asmNodeId = 0;
+    bool isFetched = true;
+    std::vector<std::unique_ptr<Node>> children;
+};
+
+namespace Internal {
+
+static QIcon documentItemIcon(const DocumentItem* docItem)
+{
+    if (sameType<XdeDocumentItem>(docItem))
+        return QIcon(":/images/xde_document_16.png");
+    else if (sameType<MeshItem>(docItem))
+        return QIcon(":/images/mesh_16.png");
+    return QIcon();
+}
+
+static QIcon xdeShapeIcon(const XdeDocumentItem* docItem, const TDF_Label& label)
+{
+    if (docItem->isShapeAssembly(label))
+        return QIcon(":/images/xde_assembly_16.png");
+    else if (docItem->isShapeReference(label))
+        return QIcon(":/images/xde_reference_16.png");
+    else if (docItem->isShapeSimple(label))
+        return QIcon(":/images/xde_simple_shape_16.png");
+    return QIcon();
+}
+
+static QString documentItemLabel(const DocumentItem* docItem)
+{
+    const QString docItemLabel = docItem->propertyLabel.value();
+    return !docItemLabel.isEmpty() ?
+                docItemLabel :
+                ApplicationTreeModel::tr("<unnamed>");
+}
+
+static XdeDocumentItem* xdeDocumentItem(const ApplicationItem& item)
+{
+    DocumentItem* docItem = item.documentItem();
+    return sameType<XdeDocumentItem>(docItem) ?
+                static_cast<XdeDocumentItem*>(docItem) : nullptr;
+}
+
+} // namespace Internal
+
+ApplicationTreeModel::ApplicationTreeModel(Application* app, QObject* parent)
+    : QAbstractItemModel(parent),
+      m_rootNode(new Node),
+      m_refItemTextTemplate(QString::fromUtf8("%instance"))
+{
+    for (Document* doc : app->documents()) {
+        this->onDocumentAdded(doc);
+        for (DocumentItem* docItem : doc->rootItems())
+            this->onDocumentItemAdded(docItem);
+    }
+
+    QObject::connect(
+                app, &Application::documentAdded,
+                this, &ApplicationTreeModel::onDocumentAdded);
+    QObject::connect(
+                app, &Application::documentErased,
+                this, &ApplicationTreeModel::onDocumentErased);
+    QObject::connect(
+                app, &Application::documentItemAdded,
+                this, &ApplicationTreeModel::onDocumentItemAdded);
+    QObject::connect(
+                app, &Application::documentItemsAdded,
+                this, &ApplicationTreeModel::onDocumentItemsAdded);
+    QObject::connect(
+                app, &Application::documentItemPropertyChanged,
+                this, &ApplicationTreeModel::onDocumentItemPropertyChanged);
+}
+
+ApplicationTreeModel::~ApplicationTreeModel()
+{
+}
+
+ApplicationItem ApplicationTreeModel::applicationItem(const QModelIndex& index) const
+{
+    const Node* node = this->nodeFromIndex(index);
+    return node != m_rootNode.get() ? node->item : ApplicationItem();
+}
+
+QModelIndex ApplicationTreeModel::indexOf(const Document* doc) const
+{
+    for (const std::unique_ptr<Node>& docNode : m_rootNode->children) {
+        if (docNode->item.document() == doc)
+            return this->indexFromNode(docNode.get());
+    }
+    return QModelIndex();
+}
+
+QModelIndex ApplicationTreeModel::indexOf(const DocumentItem* docItem) const
+{
+    const Node* docNode = this->nodeFromIndex(this->indexOf(docItem->document()));
+    if (docNode != m_rootNode.get()) {
+        for (const std::unique_ptr<Node>& docItemNode : docNode->children) {
+            if (docItemNode->item.documentItem() == docItem)
+                return this->indexFromNode(docItemNode.get());
+        }
+    }
+    return QModelIndex();
+}
+
+bool ApplicationTreeModel::isMergeXdeReferredShapeOn() const
+{
+    return m_isMergeXdeReferredShapeOn;
+}
+
+void ApplicationTreeModel::setMergeXdeReferredShape(bool on)
+{
+    m_isMergeXdeReferredShapeOn = on;
+    // TODO : reload XDE documents
+}
+
+const QString& ApplicationTreeModel::referenceItemTextTemplate() const
+{
+    return m_refItemTextTemplate;
+}
+
+void ApplicationTreeModel::setReferenceItemTextTemplate(const QString& textTemplate)
+{
+    m_refItemTextTemplate = textTemplate;
+    // Texts are computed on demand in data(), just notify fetched nodes
+    std::vector<const Node*> vecNode = { m_rootNode.get() };
+    while (!vecNode.empty()) {
+        const Node* node = vecNode.back();
+        vecNode.pop_back();
+        for (const std::unique_ptr<Node>& child : node->children) {
+            if (child->item.isXdeAssemblyNode()) {
+                const QModelIndex index = this->indexFromNode(child.get());
+                emit dataChanged(index, index, { Qt::DisplayRole });
+            }
+            vecNode.push_back(child.get());
+        }
+    }
+}
+
+QModelIndex ApplicationTreeModel::index(
+        int row, int column, const QModelIndex& parent) const
+{
+    const Node* parentNode = this->nodeFromIndex(parent);
+    if (column == 0
+            && row >= 0
+            && row < static_cast<int>(parentNode->children.size()))
+    {
+        return this->createIndex(row, column, parentNode->children.at(row).get());
+    }
+    return QModelIndex();
+}
+
+QModelIndex ApplicationTreeModel::parent(const QModelIndex& index) const
+{
+    const Node* node = this->nodeFromIndex(index);
+    return node != m_rootNode.get() ?
+                this->indexFromNode(node->parent) : QModelIndex();
+}
+
+int ApplicationTreeModel::rowCount(const QModelIndex& parent) const
+{
+    return static_cast<int>(this->nodeFromIndex(parent)->children.size());
+}
+
+int ApplicationTreeModel::columnCount(const QModelIndex& /*parent*/) const
+{
+    return 1;
+}
+
+QVariant ApplicationTreeModel::data(const QModelIndex& index, int role) const
+{
+    const Node* node = this->nodeFromIndex(index);
+    if (node == m_rootNode.get())
+        return QVariant();
+
+    const ApplicationItem& item = node->item;
+    if (item.isDocument()) {
+        const Document* doc = item.document();
+        if (role == Qt::DisplayRole)
+            return !doc->label().isEmpty() ? doc->label() : tr("<unnamed>");
+        else if (role == Qt::DecorationRole)
+            return QIcon(":/images/file_16.png");
+        else if (role == Qt::ToolTipRole)
+            return doc->filePath();
+    }
+    else if (item.isXdeAssemblyNode()) {
+        // Assembly node names are formatted only for the rows actually shown
+        const XdeDocumentItem* xdeDocItem = item.xdeAssemblyNode().ownerDocItem;
+        const Tree<TDF_Label>& asmTree = xdeDocItem->assemblyTree();
+        const TDF_Label& nodeLabel = asmTree.nodeData(node->asmNodeId);
+        if (role == Qt::DisplayRole) {
+            if (node->asmNodeId != item.xdeAssemblyNode().nodeId) {
+                const TDF_Label& refLabel = item.xdeAssemblyNode().label();
+                return this->referenceItemText(xdeDocItem, refLabel, nodeLabel);
+            }
+            return xdeDocItem->findLabelName(nodeLabel);
+        }
+        else if (role == Qt::DecorationRole) {
+            const QIcon icon = Internal::xdeShapeIcon(xdeDocItem, nodeLabel);
+            return !icon.isNull() ? QVariant(icon) : QVariant();
+        }
+    }
+    else if (item.isDocumentItem()) {
+        const DocumentItem* docItem = item.documentItem();
+        if (role == Qt::DisplayRole) {
+            return Internal::documentItemLabel(docItem);
+        }
+        else if (role == Qt::DecorationRole) {
+            const QIcon icon = Internal::documentItemIcon(docItem);
+            return !icon.isNull() ? QVariant(icon) : QVariant();
+        }
+    }
+    return QVariant();
+}
+
+bool ApplicationTreeModel::hasChildren(const QModelIndex& parent) const
+{
+    const Node* node = this->nodeFromIndex(parent);
+    if (node->isFetched)
+        return !node->children.empty();
+
+    const XdeDocumentItem* xdeDocItem = Internal::xdeDocumentItem(node->item);
+    if (node->item.isXdeAssemblyNode())
+        return xdeDocItem->hasAssemblyNodeChildren(node->asmNodeId);
+    return !xdeDocItem->assemblyTree().roots().empty();
+}
+
+bool ApplicationTreeModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !this->nodeFromIndex(parent)->isFetched;
+}
+
+void ApplicationTreeModel::fetchMore(const QModelIndex& parent)
+{
+    Node* node = this->nodeFromIndex(parent);
+    if (node->isFetched)
+        return;
+
+    node->isFetched = true;
+    XdeDocumentItem* xdeDocItem = Internal::xdeDocumentItem(node->item);
+    const Tree<TDF_Label>& asmTree = xdeDocItem->assemblyTree();
+    std::vector<XdeDocumentItem::AssemblyNodeId> vecChildId;
+    if (node->item.isXdeAssemblyNode()) {
+        xdeDocItem->fetchAssemblyNodeChildren(node->asmNodeId);
+        for (auto it = asmTree.nodeChildFirst(node->asmNodeId);
+             it != 0;
+             it = asmTree.nodeSiblingNext(it))
+        {
+            vecChildId.push_back(it);
+        }
+    }
+    else {
+        vecChildId = asmTree.roots();
+    }
+
+    if (vecChildId.empty())
+        return;
+
+    this->beginInsertRows(parent, 0, static_cast<int>(vecChildId.size()) - 1);
+    for (XdeDocumentItem::AssemblyNodeId childId : vecChildId) {
+        Node* childNode = this->appendNode(node, XdeAssemblyNode(xdeDocItem, childId));
+        childNode->asmNodeId = childId;
+        childNode->isFetched = false;
+        if (m_isMergeXdeReferredShapeOn
+                && xdeDocItem->isShapeReference(asmTree.nodeData(childId)))
+        {
+            // The reference node is hidden, its referred shape takes its place
+            xdeDocItem->fetchAssemblyNodeChildren(childId);
+            const auto referredId = asmTree.nodeChildFirst(childId);
+            if (referredId != 0)
+                childNode->asmNodeId = referredId;
+        }
+    }
+    this->endInsertRows();
+}
+
+void ApplicationTreeModel::onDocumentAdded(Document* doc)
+{
+    const int row = static_cast<int>(m_rootNode->children.size());
+    this->beginInsertRows(QModelIndex(), row, row);
+    this->appendNode(m_rootNode.get(), ApplicationItem(doc));
+    this->endInsertRows();
+}
+
+void ApplicationTreeModel::onDocumentErased(const Document* doc)
+{
+    const QModelIndex index = this->indexOf(doc);
+    if (index.isValid())
+        this->removeNode(this->nodeFromIndex(index));
+}
+
+void ApplicationTreeModel::onDocumentItemAdded(DocumentItem* docItem)
+{
+    this->onDocumentItemsAdded({ docItem });
+}
+
+void ApplicationTreeModel::onDocumentItemsAdded(
+        const std::vector<DocumentItem*>& docItems)
+{
+    if (docItems.empty())
+        return;
+
+    // Items of a batch all belong to the same document
+    const QModelIndex indexDoc = this->indexOf(docItems.front()->document());
+    if (!indexDoc.isValid())
+        return;
+
+    Node* docNode = this->nodeFromIndex(indexDoc);
+    const int row = static_cast<int>(docNode->children.size());
+    const int rowCount = static_cast<int>(docItems.size());
+    this->beginInsertRows(indexDoc, row, row + rowCount - 1);
+    for (DocumentItem* docItem : docItems) {
+        Node* docItemNode = this->appendNode(docNode, ApplicationItem(docItem));
+        docItemNode->isFetched = !sameType<XdeDocumentItem>(docItem);
+    }
+    this->endInsertRows();
+}
+
+void ApplicationTreeModel::onDocumentItemPropertyChanged(
+        const DocumentItem* docItem, const Property* prop)
+{
+    if (prop == &docItem->propertyLabel) {
+        const QModelIndex index = this->indexOf(docItem);
+        if (index.isValid())
+            emit dataChanged(index, index, { Qt::DisplayRole });
+    }
+}
+
+ApplicationTreeModel::Node* ApplicationTreeModel::nodeFromIndex(
+        const QModelIndex& index) const
+{
+    return index.isValid() ?
+                static_cast<Node*>(index.internalPointer()) :
+                m_rootNode.get();
+}
+
+QModelIndex ApplicationTreeModel::indexFromNode(const Node* node) const
+{
+    return node != nullptr && node != m_rootNode.get() ?
+                this->createIndex(node->row, 0, const_cast<Node*>(node)) :
+                QModelIndex();
+}
+
+ApplicationTreeModel::Node* ApplicationTreeModel::appendNode(
+        Node* parent, const ApplicationItem& item)
+{
+    auto node = new Node;
+    node->parent = parent;
+    node->row = static_cast<int>(parent->children.size());
+    node->item = item;
+    parent->children.emplace_back(node);
+    return node;
+}
+
+void ApplicationTreeModel::removeNode(Node* node)
+{
+    Node* parent = node->parent;
+    const int row = node->row;
+    this->beginRemoveRows(this->indexFromNode(parent), row, row);
+    parent->children.erase(parent->children.begin() + row);
+    for (auto it = parent->children.begin() + row; it != parent->children.end(); ++it)
+        --((*it)->row);
+    this->endRemoveRows();
+}
+
+QString ApplicationTreeModel::referenceItemText(
+        const XdeDocumentItem* xdeDocItem,
+        const TDF_Label& refLabel,
+        const TDF_Label& referredLabel) const
+{
+    const QString refName = xdeDocItem->findLabelName(refLabel).trimmed();
+    const QString referredName = xdeDocItem->findLabelName(referredLabel).trimmed();
+    QString itemText = m_refItemTextTemplate;
+    itemText.replace("%instance", refName)
+            .replace("%referred", referredName);
+    return itemText;
+}
+
+} // namespace Mayo
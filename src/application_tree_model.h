@@ -0,0 +1,75 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "application_item.h"
+#include <QtCore/QAbstractItemModel>
+#include <memory>
+#include <vector>
+
+namespace Mayo {
+
+class Application;
+class Property;
+
+//! Item model of the application's documents, document items and XDE
+//! assembly nodes
+//! XDE assembly nodes are materialized level by level : children of a node
+//! are only fetched when the view requests them (typically on expand)
+class ApplicationTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+public:
+    ApplicationTreeModel(Application* app, QObject* parent = nullptr);
+    ~ApplicationTreeModel();
+
+    ApplicationItem applicationItem(const QModelIndex& index) const;
+    QModelIndex indexOf(const Document* doc) const;
+    QModelIndex indexOf(const DocumentItem* docItem) const;
+
+    bool isMergeXdeReferredShapeOn() const;
+    void setMergeXdeReferredShape(bool on);
+
+    const QString& referenceItemTextTemplate() const;
+    void setReferenceItemTextTemplate(const QString& textTemplate);
+
+    QModelIndex index(
+            int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+private:
+    struct Node;
+
+    void onDocumentAdded(Document* doc);
+    void onDocumentErased(const Document* doc);
+    void onDocumentItemAdded(DocumentItem* docItem);
+    void onDocumentItemsAdded(const std::vector<DocumentItem*>& docItems);
+    void onDocumentItemPropertyChanged(
+            const DocumentItem* docItem, const Property* prop);
+
+    Node* nodeFromIndex(const QModelIndex& index) const;
+    QModelIndex indexFromNode(const Node* node) const;
+    Node* appendNode(Node* parent, const ApplicationItem& item);
+    void removeNode(Node* node);
+
+    QString referenceItemText(
+            const XdeDocumentItem* xdeDocItem,
+            const TDF_Label& refLabel,
+            const TDF_Label& referredLabel) const;
+
+    std::unique_ptr<Node> m_rootNode;
+    bool m_isMergeXdeReferredShapeOn = true;
+    QString m_refItemTextTemplate;
+};
+
+} // namespace Mayo
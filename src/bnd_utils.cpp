@@ -32,9 +32,7 @@ BndBoxCoords BndBoxCoords::get(const Bnd_Box &box)
 
 void BndUtils::add(Bnd_Box *box, const Bnd_Box &other)
 {
-    const auto bbc = BndBoxCoords::get(other);
-    for (const gp_Pnt& pnt : bbc.vertices())
-        box->Add(pnt);
+    box->Add(other);
 }
 
 Bnd_Box BndUtils::get(const Handle_AIS_InteractiveObject &obj)
@@ -56,4 +54,69 @@ Bnd_Box BndUtils::get(const Handle_AIS_InteractiveObject &obj)
     return box;
 }
 
+bool BndUtils::isEqual(const Bnd_Box& lhs, const Bnd_Box& rhs)
+{
+    if (lhs.IsVoid() || rhs.IsVoid())
+        return lhs.IsVoid() == rhs.IsVoid();
+
+    const auto lhsCoords = BndBoxCoords::get(lhs);
+    const auto rhsCoords = BndBoxCoords::get(rhs);
+    return lhsCoords.xmin == rhsCoords.xmin
+            && lhsCoords.ymin == rhsCoords.ymin
+            && lhsCoords.zmin == rhsCoords.zmin
+            && lhsCoords.xmax == rhsCoords.xmax
+            && lhsCoords.ymax == rhsCoords.ymax
+            && lhsCoords.zmax == rhsCoords.zmax;
+}
+
+void BndBoxAggregate::add(const Bnd_Box& box)
+{
+    if (box.IsVoid())
+        return;
+
+    const auto bbc = BndBoxCoords::get(box);
+    const double coords[] = { bbc.xmin, bbc.ymin, bbc.zmin, bbc.xmax, bbc.ymax, bbc.zmax };
+    for (int i = 0; i < 6; ++i)
+        m_bounds[i].insert(coords[i]);
+}
+
+void BndBoxAggregate::remove(const Bnd_Box& box)
+{
+    if (box.IsVoid())
+        return;
+
+    const auto bbc = BndBoxCoords::get(box);
+    const double coords[] = { bbc.xmin, bbc.ymin, bbc.zmin, bbc.xmax, bbc.ymax, bbc.zmax };
+    for (int i = 0; i < 6; ++i) {
+        auto itFound = m_bounds[i].find(coords[i]);
+        if (itFound != m_bounds[i].end())
+            m_bounds[i].erase(itFound);
+    }
+}
+
+void BndBoxAggregate::clear()
+{
+    for (std::multiset<double>& bounds : m_bounds)
+        bounds.clear();
+}
+
+bool BndBoxAggregate::isEmpty() const
+{
+    return m_bounds[0].empty();
+}
+
+Bnd_Box BndBoxAggregate::box() const
+{
+    Bnd_Box box;
+    if (!this->isEmpty()) {
+        box.Update(*m_bounds[0].cbegin(),
+                   *m_bounds[1].cbegin(),
+                   *m_bounds[2].cbegin(),
+                   *m_bounds[3].crbegin(),
+                   *m_bounds[4].crbegin(),
+                   *m_bounds[5].crbegin());
+    }
+    return box;
+}
+
 } // namespace Mayo
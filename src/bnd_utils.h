@@ -10,12 +10,14 @@
 #include <AIS_InteractiveObject.hxx>
 #include <Bnd_Box.hxx>
 #include <gp_Pnt.hxx>
+#include <set>
 
 namespace Mayo {
 
 struct BndUtils {
     static void add(Bnd_Box* box, const Bnd_Box& other);
     static Bnd_Box get(const Handle_AIS_InteractiveObject& obj);
+    static bool isEqual(const Bnd_Box& lhs, const Bnd_Box& rhs);
 };
 
 struct BndBoxCoords {
@@ -30,4 +32,21 @@ struct BndBoxCoords {
     static BndBoxCoords get(const Bnd_Box& box);
 };
 
+//! Union of a dynamic set of boxes
+//! Bounds are kept sorted per axis so add() and remove() are O(log n), void
+//! boxes are ignored
+class BndBoxAggregate {
+public:
+    void add(const Bnd_Box& box);
+    void remove(const Bnd_Box& box);
+    void clear();
+
+    bool isEmpty() const;
+    Bnd_Box box() const;
+
+private:
+    // Lower bounds at [0, 2], upper bounds at [3, 5]
+    std::multiset<double> m_bounds[6];
+};
+
 } // namespace Mayo
@@ -6,10 +6,73 @@
 
 #include "brep_utils.h"
 
+#include <BRep_Tool.hxx>
+#include <utility>
+
 namespace Mayo {
 
 bool BRepUtils::moreComplex(TopAbs_ShapeEnum lhs, TopAbs_ShapeEnum rhs) {
     return lhs < rhs;
 }
 
+std::vector<BRepUtils::FaceTriangulation> BRepUtils::faceTriangulations(
+        const TopoDS_Shape& shape)
+{
+    std::vector<FaceTriangulation> vecFaceMesh;
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& faceMesh = BRep_Tool::Triangulation(face, loc);
+        if (!faceMesh.IsNull())
+            vecFaceMesh.push_back({ faceMesh, loc, face.Orientation() == TopAbs_REVERSED });
+    });
+    return vecFaceMesh;
+}
+
+Handle_Poly_Triangulation BRepUtils::mergedTriangulation(const TopoDS_Shape& shape)
+{
+    return BRepUtils::mergedTriangulation(BRepUtils::faceTriangulations(shape));
+}
+
+Handle_Poly_Triangulation BRepUtils::mergedTriangulation(
+        const std::vector<FaceTriangulation>& vecFaceMesh)
+{
+    int nodeCount = 0;
+    int triangleCount = 0;
+    for (const FaceTriangulation& faceMesh : vecFaceMesh) {
+        nodeCount += faceMesh.mesh->NbNodes();
+        triangleCount += faceMesh.mesh->NbTriangles();
+    }
+
+    if (triangleCount == 0)
+        return Handle_Poly_Triangulation();
+
+    Handle_Poly_Triangulation mesh =
+            new Poly_Triangulation(nodeCount, triangleCount, Standard_False);
+    int nodeOffset = 0;
+    int triangleId = 1;
+    for (const FaceTriangulation& faceMesh : vecFaceMesh) {
+        const gp_Trsf& trsf = faceMesh.location.Transformation();
+        const TColgp_Array1OfPnt& vecFaceNode = faceMesh.mesh->Nodes();
+        for (int i = 1; i <= faceMesh.mesh->NbNodes(); ++i) {
+            mesh->ChangeNodes().SetValue(
+                        nodeOffset + i, vecFaceNode.Value(i).Transformed(trsf));
+        }
+
+        const Poly_Array1OfTriangle& vecFaceTriangle = faceMesh.mesh->Triangles();
+        for (int i = 1; i <= faceMesh.mesh->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            vecFaceTriangle.Value(i).Get(n1, n2, n3);
+            if (faceMesh.isReversed)
+                std::swap(n2, n3);
+            mesh->ChangeTriangles().SetValue(
+                        triangleId++,
+                        Poly_Triangle(nodeOffset + n1, nodeOffset + n2, nodeOffset + n3));
+        }
+
+        nodeOffset += faceMesh.mesh->NbNodes();
+    }
+
+    return mesh;
+}
+
 } // namespace Mayo
@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include <Poly_Triangulation.hxx>
 #include <TopoDS_Face.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <vector>
 
 namespace Mayo {
 
@@ -24,6 +26,23 @@ struct BRepUtils {
     static void forEachSubFace(const TopoDS_Shape& shape, FUNC fn);
 
     static bool moreComplex(TopAbs_ShapeEnum lhs, TopAbs_ShapeEnum rhs);
+
+    //! Triangulation of a face along with the placement of the face
+    struct FaceTriangulation {
+        Handle_Poly_Triangulation mesh;
+        TopLoc_Location location;
+        bool isReversed;
+    };
+
+    //! Triangulations of all faces, faces without triangulation are skipped
+    static std::vector<FaceTriangulation> faceTriangulations(const TopoDS_Shape& shape);
+
+    //! Triangulations of all faces merged into a single one, with face
+    //! locations and orientations applied. Faces without triangulation are
+    //! skipped
+    static Handle_Poly_Triangulation mergedTriangulation(const TopoDS_Shape& shape);
+    static Handle_Poly_Triangulation mergedTriangulation(
+            const std::vector<FaceTriangulation>& vecFaceMesh);
 };
 
 
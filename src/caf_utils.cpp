@@ -6,6 +6,8 @@
 
 #include "caf_utils.h"
 
+#include <BinXCAFDrivers_DocumentRetrievalDriver.hxx>
+#include <BinXCAFDrivers_DocumentStorageDriver.hxx>
 #include <TDataStd_Name.hxx>
 #include <TDF_Tool.hxx>
 #include <XCAFApp_Application.hxx>
@@ -17,7 +19,10 @@
 namespace occ {
 
 namespace Internal {
+
 static std::mutex mutex_XCAFApplication;
+static const char binXcafFormat[] = "BinXCAF";
+
 } // namespace Internal
 
 QLatin1String CafUtils::labelTag(const TDF_Label& label)
@@ -43,4 +48,32 @@ Handle_TDocStd_Document CafUtils::createXdeDocument(const char *format)
     return doc;
 }
 
+// Drivers are created at each call, not taken from XCAFApp_Application which
+// shares them
+bool CafUtils::saveXdeDocumentBinary(
+        const Handle_TDocStd_Document& doc, const QString& filepath)
+{
+    const Handle_BinXCAFDrivers_DocumentStorageDriver writer =
+            new BinXCAFDrivers_DocumentStorageDriver;
+    writer->Write(doc, QtUtils::toOccExtendedString(filepath));
+    return writer->GetStoreStatus() == PCDM_SS_OK;
+}
+
+Handle_TDocStd_Document CafUtils::openXdeDocumentBinary(const QString& filepath)
+{
+    Handle_XCAFApp_Application app;
+    {
+        std::lock_guard<std::mutex> lock(Internal::mutex_XCAFApplication);
+        app = XCAFApp_Application::GetApplication();
+    }
+
+    const Handle_BinXCAFDrivers_DocumentRetrievalDriver reader =
+            new BinXCAFDrivers_DocumentRetrievalDriver;
+    Handle_TDocStd_Document doc = new TDocStd_Document(Internal::binXcafFormat);
+    reader->Read(QtUtils::toOccExtendedString(filepath), doc, app);
+    if (reader->GetStatus() != PCDM_RS_OK)
+        return Handle_TDocStd_Document();
+    return doc;
+}
+
 } // namespace occ
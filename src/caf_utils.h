@@ -18,6 +18,13 @@ struct CafUtils {
     static QString labelAttrStdName(const TDF_Label& label);
 
     static Handle_TDocStd_Document createXdeDocument(const char* format = "XmlXCAF");
+
+    // Store/retrieve XDE document with the BinXCAF format, documents are not
+    // registered in the session of the XCAF application
+    // Can be called concurrently, each call having its own drivers
+    static bool saveXdeDocumentBinary(
+            const Handle_TDocStd_Document& doc, const QString& filepath);
+    static Handle_TDocStd_Document openXdeDocumentBinary(const QString& filepath);
 };
 
 } // namespace occ
@@ -143,6 +143,7 @@ Application::ExportOptions DialogExportOptions::currentExportOptions() const
 {
     const Options::StlIoLibrary lib = Options::instance()->stlIoLibrary();
     Application::ExportOptions options;
+    options.stlIoLibrary = lib;
     options.stlFormat = static_cast<gmio_stl_format>(
                 m_ui->comboBox_StlFormat->currentData().toInt());
     if (lib == Options::StlIoLibrary::Gmio) {
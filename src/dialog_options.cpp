@@ -6,14 +6,18 @@
 
 #include "dialog_options.h"
 
+#include "import_cache.h"
 #include "options.h"
 #include "property_enumeration.h"
+#include "xde_part_index.h"
 #include "ui_dialog_options.h"
 #include "fougtools/qttools/gui/qwidget_utils.h"
 #include "fougtools/occtools/qt_utils.h"
 
+#include <QtCore/QDir>
 #include <QtWidgets/QButtonGroup>
 #include <QtWidgets/QColorDialog>
+#include <QtWidgets/QFileDialog>
 
 namespace Mayo {
 
@@ -26,6 +30,26 @@ static QPixmap colorPixmap(const QColor& color)
     return pix;
 }
 
+static QString importCacheStatsText()
+{
+    const QString cacheDirPath = Options::instance()->importCacheDir();
+    const ImportCache* cache = ImportCache::instance();
+    const ImportCache::Statistics stats = cache->statistics(cacheDirPath);
+    return DialogOptions::tr("%1 MB used, hit rate %2%, %3s saved")
+            .arg(cache->size(cacheDirPath) / (1024. * 1024.), 0, 'f', 1)
+            .arg(stats.hitRate() * 100, 0, 'f', 0)
+            .arg(stats.savedTime / 1000.);
+}
+
+static QString importPartSharingStatsText()
+{
+    const XdePartIndex::Statistics stats = XdePartIndex::instance()->statistics();
+    return DialogOptions::tr("%1 distinct parts, %2 shared copies, %3 MB saved")
+            .arg(stats.partCount)
+            .arg(stats.duplicateCount)
+            .arg(stats.savedBytes / (1024. * 1024.), 0, 'f', 1);
+}
+
 } // namespace Internal
 
 DialogOptions::DialogOptions(QWidget *parent)
@@ -42,10 +66,43 @@ DialogOptions::DialogOptions(QWidget *parent)
     auto btnGrp_stlIoLib = new QButtonGroup(this);
     btnGrp_stlIoLib->addButton(m_ui->radioBtn_UseGmio);
     btnGrp_stlIoLib->addButton(m_ui->radioBtn_UseOcc);
+    btnGrp_stlIoLib->addButton(m_ui->radioBtn_UseNative);
 
     const Options::StlIoLibrary lib = opts->stlIoLibrary();
     m_ui->radioBtn_UseGmio->setChecked(lib == Options::StlIoLibrary::Gmio);
     m_ui->radioBtn_UseOcc->setChecked(lib == Options::StlIoLibrary::OpenCascade);
+    m_ui->radioBtn_UseNative->setChecked(lib == Options::StlIoLibrary::Native);
+    m_ui->spinBox_StlWeldTolerance->setValue(opts->stlWeldTolerance());
+    m_ui->spinBox_StlWeldTolerance->setEnabled(lib == Options::StlIoLibrary::Native);
+    QObject::connect(
+                m_ui->radioBtn_UseNative, &QAbstractButton::toggled,
+                m_ui->spinBox_StlWeldTolerance, &QWidget::setEnabled);
+
+    // Import
+    m_ui->checkBox_ConcurrentImport->setChecked(opts->isConcurrentImportOn());
+    m_ui->checkBox_ImportCache->setChecked(opts->isImportCacheOn());
+    m_ui->lineEdit_ImportCacheDir->setText(
+                QDir::toNativeSeparators(opts->importCacheDir()));
+    m_ui->spinBox_ImportCacheMaxSize->setValue(opts->importCacheMaxSize());
+    m_ui->label_ImportCacheStats->setText(Internal::importCacheStatsText());
+    m_ui->spinBox_ImportMeshingDeflection->setValue(opts->importMeshingDeflection());
+    m_ui->checkBox_ImportPartSharing->setChecked(opts->isImportPartSharingOn());
+    m_ui->label_ImportPartSharingStats->setText(Internal::importPartSharingStatsText());
+    QObject::connect(
+                m_ui->toolBtn_ImportCacheDir, &QAbstractButton::clicked,
+                [=] {
+        const QString dirPath =
+                QFileDialog::getExistingDirectory(
+                    this, tr("Cache directory"), m_ui->lineEdit_ImportCacheDir->text());
+        if (!dirPath.isEmpty())
+            m_ui->lineEdit_ImportCacheDir->setText(QDir::toNativeSeparators(dirPath));
+    } );
+    QObject::connect(
+                m_ui->pushBtn_ClearImportCache, &QAbstractButton::clicked,
+                [=] {
+        ImportCache::instance()->clear(Options::instance()->importCacheDir());
+        m_ui->label_ImportCacheStats->setText(Internal::importCacheStatsText());
+    } );
 
     // BRep shape defaults
     m_ui->toolBtn_BRepShapeDefaultColor->setIcon(
@@ -63,6 +120,8 @@ DialogOptions::DialogOptions(QWidget *parent)
     m_ui->comboBox_BRepShapeDefaultMaterial->setCurrentIndex(
                 m_ui->comboBox_BRepShapeDefaultMaterial->findData(
                     static_cast<int>(opts->brepShapeDefaultMaterial())));
+    m_ui->checkBox_BRepShapeInstancedDisplay->setChecked(
+                opts->isBrepShapeInstancedDisplayOn());
 
     // Mesh defaults
     m_ui->toolBtn_MeshDefaultColor->setIcon(
@@ -82,6 +141,18 @@ DialogOptions::DialogOptions(QWidget *parent)
                     static_cast<int>(opts->meshDefaultMaterial())));
     m_ui->checkBox_MeshShowEdges->setChecked(opts->meshDefaultShowEdges());
     m_ui->checkBox_MeshShowNodes->setChecked(opts->meshDefaultShowNodes());
+    m_ui->comboBox_MeshPresentation->addItem(
+                tr("Triangulation"),
+                static_cast<int>(Options::MeshPresentation::Triangulation));
+    m_ui->comboBox_MeshPresentation->addItem(
+                tr("MeshVS"),
+                static_cast<int>(Options::MeshPresentation::MeshVS));
+    m_ui->comboBox_MeshPresentation->setCurrentIndex(
+                m_ui->comboBox_MeshPresentation->findData(
+                    static_cast<int>(opts->meshPresentation())));
+
+    // View
+    m_ui->spinBox_ViewLodFrameTimeTarget->setValue(opts->viewLodFrameTimeTarget());
 
     // Clip planes
     m_ui->checkBox_Capping->setChecked(opts->isClipPlaneCappingOn());
@@ -118,12 +189,26 @@ void DialogOptions::accept()
         opts->setStlIoLibrary(Options::StlIoLibrary::Gmio);
     else if (m_ui->radioBtn_UseOcc->isChecked())
         opts->setStlIoLibrary(Options::StlIoLibrary::OpenCascade);
+    else if (m_ui->radioBtn_UseNative->isChecked())
+        opts->setStlIoLibrary(Options::StlIoLibrary::Native);
+    opts->setStlWeldTolerance(m_ui->spinBox_StlWeldTolerance->value());
+
+    // Import
+    opts->setConcurrentImport(m_ui->checkBox_ConcurrentImport->isChecked());
+    opts->setImportCache(m_ui->checkBox_ImportCache->isChecked());
+    opts->setImportCacheDir(
+                QDir::fromNativeSeparators(m_ui->lineEdit_ImportCacheDir->text()));
+    opts->setImportCacheMaxSize(m_ui->spinBox_ImportCacheMaxSize->value());
+    opts->setImportMeshingDeflection(m_ui->spinBox_ImportMeshingDeflection->value());
+    opts->setImportPartSharing(m_ui->checkBox_ImportPartSharing->isChecked());
 
     // BRep shape defaults
     opts->setBrepShapeDefaultColor(m_brepShapeDefaultColor);
     opts->setBrepShapeDefaultMaterial(
                 static_cast<Graphic3d_NameOfMaterial>(
                     m_ui->comboBox_BRepShapeDefaultMaterial->currentData().toInt()));
+    opts->setBrepShapeInstancedDisplay(
+                m_ui->checkBox_BRepShapeInstancedDisplay->isChecked());
 
     // Mesh defaults
     opts->setMeshDefaultColor(m_meshDefaultColor);
@@ -132,6 +217,12 @@ void DialogOptions::accept()
                     m_ui->comboBox_MeshDefaultMaterial->currentData().toInt()));
     opts->setMeshDefaultShowEdges(m_ui->checkBox_MeshShowEdges->isChecked());
     opts->setMeshDefaultShowNodes(m_ui->checkBox_MeshShowNodes->isChecked());
+    opts->setMeshPresentation(
+                static_cast<Options::MeshPresentation>(
+                    m_ui->comboBox_MeshPresentation->currentData().toInt()));
+
+    // View
+    opts->setViewLodFrameTimeTarget(m_ui->spinBox_ViewLodFrameTimeTarget->value());
 
     // Clip planes
     opts->setClipPlaneCapping(m_ui->checkBox_Capping->isChecked());
@@ -8,6 +8,8 @@
 
 #include "application.h"
 #include "document_item.h"
+#include "xde_document_item.h"
+#include "xde_part_index.h"
 
 #include <cassert>
 
@@ -57,9 +59,15 @@ void Document::setFilePath(const QString &filepath)
 
 bool Document::eraseRootItem(DocumentItem *docItem)
 {
+    std::unique_lock<std::mutex> lock(m_mutexRootItems);
     auto itFound = std::find(m_rootItems.cbegin(), m_rootItems.cend(), docItem);
     if (itFound != m_rootItems.cend()) {
         m_rootItems.erase(itFound);
+        lock.unlock();
+        // Indexed parts keep their topology alive
+        if (sameType<XdeDocumentItem>(docItem))
+            XdePartIndex::instance()->removeParts(static_cast<XdeDocumentItem*>(docItem));
+
         delete docItem;
         emit itemErased(docItem);
         return true;
@@ -67,21 +75,40 @@ bool Document::eraseRootItem(DocumentItem *docItem)
     return false;
 }
 
-const std::vector<DocumentItem*>& Document::rootItems() const
+std::vector<DocumentItem*> Document::rootItems() const
 {
+    std::lock_guard<std::mutex> lock(m_mutexRootItems); Q_UNUSED(lock);
     return m_rootItems;
 }
 
 bool Document::isEmpty() const
 {
+    std::lock_guard<std::mutex> lock(m_mutexRootItems); Q_UNUSED(lock);
     return m_rootItems.empty();
 }
 
 void Document::addRootItem(DocumentItem* item)
 {
     item->setDocument(this);
-    m_rootItems.push_back(item);
+    {
+        std::lock_guard<std::mutex> lock(m_mutexRootItems); Q_UNUSED(lock);
+        m_rootItems.push_back(item);
+    }
     emit itemAdded(item);
 }
 
+void Document::addRootItems(Span<DocumentItem* const> items)
+{
+    if (items.empty())
+        return;
+
+    for (DocumentItem* item : items)
+        item->setDocument(this);
+    {
+        std::lock_guard<std::mutex> lock(m_mutexRootItems); Q_UNUSED(lock);
+        m_rootItems.insert(m_rootItems.end(), items.begin(), items.end());
+    }
+    emit itemsAdded(std::vector<DocumentItem*>(items.begin(), items.end()));
+}
+
 } // namespace Mayo
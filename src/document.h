@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include "span.h"
+
+#include <QtCore/QMetaType>
 #include <QtCore/QObject>
+#include <mutex>
 #include <vector>
 
 namespace Mayo {
@@ -30,11 +34,13 @@ public:
 
     bool eraseRootItem(DocumentItem* docItem);
 
-    const std::vector<DocumentItem*>& rootItems() const;
+    // Copy taken under lock, import tasks may add items concurrently
+    std::vector<DocumentItem*> rootItems() const;
     bool isEmpty() const;
 
 signals:
     void itemAdded(DocumentItem* docItem);
+    void itemsAdded(const std::vector<DocumentItem*>& docItems);
     void itemErased(const DocumentItem* docItem);
     void itemPropertyChanged(const DocumentItem* docItem, const Property* prop);
 
@@ -45,11 +51,16 @@ private:
     ~Document();
 
     void addRootItem(DocumentItem* item);
+    // Adds all items at once, emits a single itemsAdded() signal
+    void addRootItems(Span<DocumentItem* const> items);
 
     Application* m_app = nullptr;
     std::vector<DocumentItem*> m_rootItems;
+    mutable std::mutex m_mutexRootItems; // Import tasks may add items concurrently
     QString m_label;
     QString m_filePath;
 };
 
 } // namespace Mayo
+
+Q_DECLARE_METATYPE(std::vector<Mayo::DocumentItem*>)
@@ -71,6 +71,7 @@ void BaseRunner::execRunnableFunc()
 {
     m_signals.emitStarted(m_taskTitle);
     m_func();
+    m_progress.publishPendingValue();
     m_signals.emitEnded();
     m_signals.emitDestroyRequest();
 }
@@ -18,11 +18,14 @@
 #include "base_runner.h"
 #include "manager.h"
 
+#include <algorithm>
+
 namespace qttask {
 
 BaseRunnerSignals::BaseRunnerSignals(BaseRunner* runner, QObject *parent)
     : QObject(parent),
-      m_runner(runner)
+      m_runner(runner),
+      m_pendingProgressTimer(this)
 {
     QObject::connect(this, &BaseRunnerSignals::aboutToRun, runner->m_mgr, &Manager::onAboutToRun);
     QObject::connect(this, &BaseRunnerSignals::started, runner->m_mgr, &Manager::started);
@@ -31,6 +34,10 @@ BaseRunnerSignals::BaseRunnerSignals(BaseRunner* runner, QObject *parent)
     QObject::connect(this, &BaseRunnerSignals::message, runner->m_mgr, &Manager::message);
     QObject::connect(this, &BaseRunnerSignals::ended, runner->m_mgr, &Manager::ended);
     QObject::connect(this, &BaseRunnerSignals::destroyRequest, runner->m_mgr, &Manager::onDestroyRequest);
+    m_pendingProgressTimer.setSingleShot(true);
+    QObject::connect(&m_pendingProgressTimer, &QTimer::timeout, [=]{
+        m_runner->progress().publishPendingValue();
+    });
 }
 
 void BaseRunnerSignals::emitAboutToRun()
@@ -68,4 +75,15 @@ void BaseRunnerSignals::emitDestroyRequest()
     emit destroyRequest(m_runner);
 }
 
+void BaseRunnerSignals::schedulePendingProgress(int delay)
+{
+    QMetaObject::invokeMethod(
+                this, "startPendingProgressTimer", Qt::QueuedConnection, Q_ARG(int, delay));
+}
+
+void BaseRunnerSignals::startPendingProgressTimer(int delay)
+{
+    m_pendingProgressTimer.start(std::max(delay, 0));
+}
+
 } // namespace qttask
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QTimer>
 
 namespace qttask {
 
@@ -42,6 +43,10 @@ public:
     void emitEnded();
     void emitDestroyRequest();
 
+    // Can be called from any thread, the pending value of Progress is
+    // published after 'delay' milliseconds by the thread of this object
+    void schedulePendingProgress(int delay);
+
 signals:
     void aboutToRun(BaseRunner* runner);
     void started(quint64 taskId, const QString& title);
@@ -52,7 +57,10 @@ signals:
     void destroyRequest(BaseRunner* runner);
 
 private:
+    Q_INVOKABLE void startPendingProgressTimer(int delay);
+
     BaseRunner* m_runner = nullptr;
+    QTimer m_pendingProgressTimer;
 };
 
 } // namespace qttask
@@ -20,7 +20,10 @@
 namespace qttask {
 
 Progress::Progress(BaseRunner *runner)
-    : m_runner(runner)
+    : m_runner(runner),
+      m_value(0),
+      m_publishedValue(0),
+      m_isPublishPending(false)
 { }
 
 Progress::~Progress()
@@ -33,8 +36,33 @@ int Progress::value() const
 
 void Progress::setValue(int pct)
 {
+    if (pct == m_value)
+        return;
+
     m_value = pct;
-    m_runner->qtSignals()->emitProgress(pct);
+    const bool isPublishForced =
+            pct < 0 || pct >= 100 || m_publishedValue < 0 || !m_publishTimer.isValid();
+    if (isPublishForced || m_publishTimer.elapsed() >= Progress::publishInterval()) {
+        m_isPublishPending = false;
+        m_publishedValue = pct;
+        m_publishTimer.start();
+        m_runner->qtSignals()->emitProgress(pct);
+    }
+    else if (!m_isPublishPending.exchange(true)) {
+        const qint64 remainingTime = Progress::publishInterval() - m_publishTimer.elapsed();
+        m_runner->qtSignals()->schedulePendingProgress(static_cast<int>(remainingTime));
+    }
+}
+
+void Progress::publishPendingValue()
+{
+    if (!m_isPublishPending.exchange(false))
+        return;
+
+    // Latest value, setValue() may have been called since scheduling
+    const int pct = m_value;
+    if (m_publishedValue.exchange(pct) != pct)
+        m_runner->qtSignals()->emitProgress(pct);
 }
 
 const QString& Progress::step() const
@@ -44,6 +72,9 @@ const QString& Progress::step() const
 
 void Progress::setStep(const QString &title)
 {
+    if (title == m_step)
+        return;
+
     m_step = title;
     m_runner->qtSignals()->emitProgressStep(title);
 }
@@ -80,4 +111,9 @@ bool Progress::isAbortRequested() const
     return m_runner->isAbortRequested();
 }
 
+int Progress::publishInterval()
+{
+    return 40; // 25 updates per second at most
+}
+
 } // namespace qttask
@@ -15,9 +15,11 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QVariant>
 #include <QtCore/QString>
 
+#include <atomic>
 #include <unordered_map>
 
 namespace qttask {
@@ -25,6 +27,14 @@ namespace qttask {
 class BaseRunner;
 
 /*! \brief Provides feedback on the progress of an executing operation
+ *
+ *  Updates are coalesced on the side of the executing thread : setValue()
+ *  and setStep() emit nothing when there is no change, and changes of the
+ *  value are published to the Manager at most once per publishInterval().
+ *  Only the first, the last(100%) and the "unbounded"(negative) values are
+ *  always published. A value held back by the interval is published once the
+ *  interval has elapsed(by a timer of the thread owning the task runner), or
+ *  when the task ends
  */
 class Progress
 {
@@ -44,15 +54,25 @@ public:
 
     bool isAbortRequested() const;
 
+    //! Minimum time(in milliseconds) between two publications of the value
+    static int publishInterval();
+
 private:
     friend class Manager;
     friend class BaseRunner;
+    friend class BaseRunnerSignals;
 
     Progress(BaseRunner* runner);
 
+    // Can be called from any thread
+    void publishPendingValue();
+
     BaseRunner* m_runner = nullptr;
     std::unordered_map<int, QVariant> m_dataHash;
-    int m_value = 0;
+    std::atomic<int> m_value;
+    std::atomic<int> m_publishedValue;
+    std::atomic<bool> m_isPublishPending;
+    QElapsedTimer m_publishTimer; // Only used by the executing thread
     QString m_step;
 };
 
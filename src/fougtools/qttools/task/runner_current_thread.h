@@ -17,6 +17,8 @@
 
 #include "base_runner.h"
 
+#include <atomic>
+
 namespace qttask {
 
 struct CurrentThread { };
@@ -28,7 +30,8 @@ class Runner<CurrentThread> : public BaseRunner
 {
 public:
     Runner<CurrentThread>(const Manager *mgr)
-        : BaseRunner(mgr)
+        : BaseRunner(mgr),
+          m_isAbortRequested(false)
     { }
 
 protected:
@@ -42,7 +45,7 @@ protected:
     { this->execRunnableFunc(); }
 
 private:
-    bool m_isAbortRequested = false;
+    std::atomic<bool> m_isAbortRequested;
 };
 
 } // namespace qttask
@@ -20,6 +20,8 @@
 #include <QtCore/QRunnable>
 #include <QtCore/QThreadPool>
 
+#include <atomic>
+
 namespace qttask {
 
 /*! \brief Task runner using the global instance of QThreadPool
@@ -35,6 +37,7 @@ public:
      */
     Runner<QThreadPool>(const Manager* mgr, int priority = 0)
         : BaseRunner(mgr),
+          m_isAbortRequested(false),
           m_priority(priority)
     {
         this->setAutoDelete(false);
@@ -53,7 +56,7 @@ public:
     { QThreadPool::globalInstance()->start(this, m_priority); }
 
 private:
-    bool m_isAbortRequested = false;
+    std::atomic<bool> m_isAbortRequested;
     int m_priority = 0;
 };
 
@@ -17,6 +17,7 @@
 
 #include "base_runner.h"
 
+#include <atomic>
 #include <future>
 
 namespace qttask {
@@ -46,7 +47,7 @@ protected:
     }
 
 private:
-    bool m_isAbortRequested;
+    std::atomic<bool> m_isAbortRequested;
     std::launch m_policy;
     std::future<void> m_future;
 };
@@ -0,0 +1,66 @@
+/****************************************************************************
+**  FougTools
+**  Copyright Fougue (30 Mar. 2015)
+**  contact@fougue.pro
+**
+** This software is a computer program whose purpose is to provide utility
+** tools for the C++ language and the Qt toolkit.
+**
+** This software is governed by the CeCILL-C license under French law and
+** abiding by the rules of distribution of free software.  You can  use,
+** modify and/ or redistribute the software under the terms of the CeCILL-C
+** license as circulated by CEA, CNRS and INRIA at the following URL
+** "http://www.cecill.info".
+****************************************************************************/
+
+#pragma once
+
+#include "base_runner.h"
+#include "work_stealing_pool.h"
+
+#include <atomic>
+
+namespace qttask {
+
+/*! \brief Task runner using the global instance of WorkStealingPool
+ *
+ *  Unlike Runner<StdAsync>, the count of threads is bounded whatever the
+ *  count of tasks launched
+ */
+template<>
+class Runner<WorkStealingPool> : public BaseRunner
+{
+public:
+    /*! \param memoryCost Estimated peak memory(in bytes) required by the task,
+     *                    zero means the task is admitted without condition
+     */
+    Runner<WorkStealingPool>(
+            const Manager* mgr,
+            WorkStealingPool::Priority priority = WorkStealingPool::Priority::Batch,
+            std::size_t memoryCost = 0)
+        : BaseRunner(mgr),
+          m_isAbortRequested(false),
+          m_priority(priority),
+          m_memoryCost(memoryCost)
+    {}
+
+protected:
+    bool isAbortRequested() override
+    { return m_isAbortRequested; }
+
+    void requestAbort() override
+    { m_isAbortRequested = true; }
+
+    void launch() override
+    {
+        WorkStealingPool::globalInstance()->submit(
+                    [=]{ this->execRunnableFunc(); }, m_priority, m_memoryCost);
+    }
+
+private:
+    std::atomic<bool> m_isAbortRequested;
+    WorkStealingPool::Priority m_priority;
+    std::size_t m_memoryCost;
+};
+
+} // namespace qttask
@@ -0,0 +1,244 @@
+/****************************************************************************
+**  FougTools
+**  Copyright Fougue (30 Mar. 2015)
+**  contact@fougue.pro
+**
+** This software is a computer program whose purpose is to provide utility
+** tools for the C++ language and the Qt toolkit.
+**
+** This software is governed by the CeCILL-C license under French law and
+** abiding by the rules of distribution of free software.  You can  use,
+** modify and/ or redistribute the software under the terms of the CeCILL-C
+** license as circulated by CEA, CNRS and INRIA at the following URL
+** "http://www.cecill.info".
+****************************************************************************/
+
+#include "work_stealing_pool.h"
+
+#include <QtCore/QGlobalStatic>
+#include <QtCore/QtGlobal>
+
+#include <algorithm>
+#include <utility>
+
+#ifdef Q_OS_WIN
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace qttask {
+
+namespace internal {
+
+// Identifies the pool and the worker running in the current thread, used to
+// push jobs submitted by a worker in its own queues
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local int currentWorkerIndex = -1;
+
+} // namespace internal
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_submitSeq(0),
+      m_queuedCount(0),
+      m_isStopRequested(false),
+      m_memoryBudget(WorkStealingPool::physicalMemorySize() / 2)
+{
+    if (threadCount <= 0)
+        threadCount = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+    for (int i = 0; i < threadCount; ++i)
+        m_workers.emplace_back(new Worker);
+
+    for (int i = 0; i < threadCount; ++i)
+        m_workers.at(i)->thread = std::thread([=]{ this->workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_isStopRequested = true;
+    }
+
+    m_wakeCond.notify_all();
+    for (const std::unique_ptr<Worker>& worker : m_workers)
+        worker->thread.join();
+}
+
+int WorkStealingPool::threadCount() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+std::size_t WorkStealingPool::memoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_admissionMutex);
+    return m_memoryBudget;
+}
+
+void WorkStealingPool::setMemoryBudget(std::size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_admissionMutex);
+        m_memoryBudget = bytes;
+    }
+
+    // A larger budget may admit pending jobs
+    this->releaseMemory(0);
+}
+
+std::size_t WorkStealingPool::memoryInUse() const
+{
+    std::lock_guard<std::mutex> lock(m_admissionMutex);
+    return m_memoryInUse;
+}
+
+void WorkStealingPool::submit(
+        std::function<void()>&& job, Priority priority, std::size_t memoryCost)
+{
+    Job newJob = { std::move(job), memoryCost };
+    if (memoryCost > 0) {
+        std::lock_guard<std::mutex> lock(m_admissionMutex);
+        // Pending jobs keep their turn, Interactive ones first
+        const auto& pendingInteractive = m_pendingJobs[int(Priority::Interactive)];
+        auto& pending = m_pendingJobs[int(priority)];
+        if (!pendingInteractive.empty()
+                || !pending.empty()
+                || !this->isAdmissible(memoryCost))
+        {
+            pending.push_back(std::move(newJob));
+            return;
+        }
+
+        m_memoryInUse += memoryCost;
+    }
+
+    this->enqueue(std::move(newJob), priority);
+}
+
+Q_GLOBAL_STATIC(WorkStealingPool, poolGlobalInstance)
+
+WorkStealingPool* WorkStealingPool::globalInstance()
+{
+    return poolGlobalInstance();
+}
+
+std::size_t WorkStealingPool::physicalMemorySize()
+{
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        return static_cast<std::size_t>(status.ullTotalPhys);
+#elif defined(_SC_PHYS_PAGES) && defined(_SC_PAGE_SIZE)
+    const long pageCount = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pageCount > 0 && pageSize > 0)
+        return static_cast<std::size_t>(pageCount) * static_cast<std::size_t>(pageSize);
+#endif
+    return 0;
+}
+
+void WorkStealingPool::workerLoop(int workerIndex)
+{
+    internal::currentPool = this;
+    internal::currentWorkerIndex = workerIndex;
+    while (!m_isStopRequested) {
+        Job job;
+        if (this->tryTakeJob(workerIndex, &job)) {
+            job.func();
+            if (job.memoryCost > 0)
+                this->releaseMemory(job.memoryCost);
+        }
+        else {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCond.wait(lock, [=]{ return m_isStopRequested || m_queuedCount > 0; });
+        }
+    }
+}
+
+void WorkStealingPool::enqueue(Job&& job, Priority priority)
+{
+    const int workerIndex =
+            internal::currentPool == this ?
+                internal::currentWorkerIndex :
+                static_cast<int>(m_submitSeq.fetch_add(1) % m_workers.size());
+    Worker* worker = m_workers.at(workerIndex).get();
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[int(priority)].push_back(std::move(job));
+    }
+
+    {
+        // Incremented under the lock so a worker about to wait can't miss it
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        ++m_queuedCount;
+    }
+
+    m_wakeCond.notify_one();
+}
+
+bool WorkStealingPool::tryTakeJob(int workerIndex, Job* job)
+{
+    const int workerCount = static_cast<int>(m_workers.size());
+    for (const Priority priority : { Priority::Interactive, Priority::Batch }) {
+        const int queueIndex = int(priority);
+        // Own queue first (most recent job), then steal the oldest job of the
+        // other workers
+        for (int i = 0; i < workerCount; ++i) {
+            Worker* worker = m_workers.at((workerIndex + i) % workerCount).get();
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            std::deque<Job>& queue = worker->queues[queueIndex];
+            if (!queue.empty()) {
+                if (i == 0) {
+                    *job = std::move(queue.back());
+                    queue.pop_back();
+                }
+                else {
+                    *job = std::move(queue.front());
+                    queue.pop_front();
+                }
+
+                --m_queuedCount;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool WorkStealingPool::isAdmissible(std::size_t memoryCost) const
+{
+    return memoryCost == 0
+            || m_memoryBudget == 0
+            || m_memoryInUse == 0
+            || m_memoryInUse + memoryCost <= m_memoryBudget;
+}
+
+void WorkStealingPool::releaseMemory(std::size_t memoryCost)
+{
+    std::vector<std::pair<Job, Priority>> vecAdmittedJob;
+    {
+        std::lock_guard<std::mutex> lock(m_admissionMutex);
+        m_memoryInUse -= std::min(memoryCost, m_memoryInUse);
+        for (const Priority priority : { Priority::Interactive, Priority::Batch }) {
+            std::deque<Job>& pending = m_pendingJobs[int(priority)];
+            while (!pending.empty() && this->isAdmissible(pending.front().memoryCost)) {
+                m_memoryInUse += pending.front().memoryCost;
+                vecAdmittedJob.emplace_back(std::move(pending.front()), priority);
+                pending.pop_front();
+            }
+
+            // Batch jobs must not overtake pending Interactive jobs
+            if (!pending.empty())
+                break;
+        }
+    }
+
+    for (auto& admittedJob : vecAdmittedJob)
+        this->enqueue(std::move(admittedJob.first), admittedJob.second);
+}
+
+} // namespace qttask
@@ -0,0 +1,108 @@
+/****************************************************************************
+**  FougTools
+**  Copyright Fougue (30 Mar. 2015)
+**  contact@fougue.pro
+**
+** This software is a computer program whose purpose is to provide utility
+** tools for the C++ language and the Qt toolkit.
+**
+** This software is governed by the CeCILL-C license under French law and
+** abiding by the rules of distribution of free software.  You can  use,
+** modify and/ or redistribute the software under the terms of the CeCILL-C
+** license as circulated by CEA, CNRS and INRIA at the following URL
+** "http://www.cecill.info".
+****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qttask {
+
+/*! \brief Fixed-size pool of threads, each one owning its own queues of jobs
+ *
+ *  Jobs submitted from a worker thread are pushed in the queue of this
+ *  worker and popped back in LIFO order, jobs submitted from any other thread
+ *  are spread over the workers. An idle worker steals jobs from the front of
+ *  the queues of the other workers.
+ *
+ *  Jobs of priority Interactive are always taken before Batch jobs.
+ *
+ *  A job can declare an estimated memory cost : it is then admitted only if
+ *  the sum of the costs of admitted jobs fits within memoryBudget(). Jobs
+ *  not admitted wait in a FIFO queue until enough memory is released. A job
+ *  is always admitted when no other costly job is in flight, so a cost
+ *  greater than the budget can't block the pool.
+ */
+class WorkStealingPool
+{
+public:
+    enum class Priority {
+        Interactive,
+        Batch
+    };
+
+    //! Creates 'threadCount' workers, or one per core if 'threadCount' <= 0
+    WorkStealingPool(int threadCount = 0);
+    //! Waits for running jobs to finish, jobs still queued are discarded
+    ~WorkStealingPool();
+
+    int threadCount() const;
+
+    //! Memory budget in bytes, zero means unlimited
+    //! Default value is half of physicalMemorySize()
+    std::size_t memoryBudget() const;
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t memoryInUse() const;
+
+    void submit(
+            std::function<void()>&& job,
+            Priority priority = Priority::Batch,
+            std::size_t memoryCost = 0);
+
+    static WorkStealingPool* globalInstance();
+
+    //! Size in bytes of the physical memory, zero if unknown
+    static std::size_t physicalMemorySize();
+
+private:
+    struct Job {
+        std::function<void()> func;
+        std::size_t memoryCost;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> queues[2]; // Indexed with Priority
+        std::thread thread;
+    };
+
+    void workerLoop(int workerIndex);
+    void enqueue(Job&& job, Priority priority);
+    bool tryTakeJob(int workerIndex, Job* job);
+    bool isAdmissible(std::size_t memoryCost) const;
+    void releaseMemory(std::size_t memoryCost);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<unsigned> m_submitSeq;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCond;
+    std::atomic<int> m_queuedCount;
+    std::atomic<bool> m_isStopRequested;
+
+    mutable std::mutex m_admissionMutex;
+    std::deque<Job> m_pendingJobs[2]; // Jobs waiting for memory admission
+    std::size_t m_memoryBudget = 0;
+    std::size_t m_memoryInUse = 0;
+};
+
+} // namespace qttask
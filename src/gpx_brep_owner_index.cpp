@@ -0,0 +1,63 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "gpx_brep_owner_index.h"
+
+#include <StdSelect_BRepOwner.hxx>
+
+namespace Mayo {
+
+GpxBRepOwnerIndex::GpxBRepOwnerIndex(GpxBRepOwnerIndex&& other) noexcept
+{
+    m_mapShapeOwner.Exchange(other.m_mapShapeOwner);
+}
+
+GpxBRepOwnerIndex& GpxBRepOwnerIndex::operator=(GpxBRepOwnerIndex&& other) noexcept
+{
+    m_mapShapeOwner.Exchange(other.m_mapShapeOwner);
+    return *this;
+}
+
+void GpxBRepOwnerIndex::add(const Handle_SelectMgr_EntityOwner& owner)
+{
+    auto brepOwner = Handle_StdSelect_BRepOwner::DownCast(owner);
+    if (!brepOwner.IsNull() && brepOwner->HasShape())
+        m_mapShapeOwner.Bind(brepOwner->Shape(), owner);
+}
+
+void GpxBRepOwnerIndex::add(
+        const Handle_SelectMgr_EntityOwner& owner, const TopLoc_Location& loc)
+{
+    auto brepOwner = Handle_StdSelect_BRepOwner::DownCast(owner);
+    if (!brepOwner.IsNull() && brepOwner->HasShape())
+        m_mapShapeOwner.Bind(brepOwner->Shape().Moved(loc), owner);
+}
+
+void GpxBRepOwnerIndex::add(const SelectMgr_IndexedMapOfOwner& mapOwner)
+{
+    m_mapShapeOwner.ReSize(m_mapShapeOwner.Extent() + mapOwner.Extent());
+    for (auto it = mapOwner.cbegin(); it != mapOwner.cend(); ++it)
+        this->add(*it);
+}
+
+void GpxBRepOwnerIndex::clear()
+{
+    m_mapShapeOwner.Clear();
+}
+
+int GpxBRepOwnerIndex::size() const
+{
+    return m_mapShapeOwner.Extent();
+}
+
+Handle_SelectMgr_EntityOwner GpxBRepOwnerIndex::findOwner(
+        const TopoDS_Shape& shape) const
+{
+    const Handle_SelectMgr_EntityOwner* ptrOwner = m_mapShapeOwner.Seek(shape);
+    return ptrOwner != nullptr ? *ptrOwner : Handle_SelectMgr_EntityOwner();
+}
+
+} // namespace Mayo
@@ -0,0 +1,43 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <NCollection_DataMap.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_IndexedMapOfOwner.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <TopoDS_Shape.hxx>
+
+namespace Mayo {
+
+//! Hashed index of the B-Rep entity owners of a graphics object, keyed by
+//! owner shape
+//! Shapes are compared with TopoDS_Shape::IsSame() like StdSelect does when
+//! it creates one owner per sub-shape
+class GpxBRepOwnerIndex {
+public:
+    GpxBRepOwnerIndex() = default;
+    GpxBRepOwnerIndex(GpxBRepOwnerIndex&& other) noexcept;
+    GpxBRepOwnerIndex& operator=(GpxBRepOwnerIndex&& other) noexcept;
+
+    void add(const Handle_SelectMgr_EntityOwner& owner);
+    // Owner is keyed by its shape moved by 'loc', for owners of connected
+    // objects which share the shapes of their reference
+    void add(const Handle_SelectMgr_EntityOwner& owner, const TopLoc_Location& loc);
+    void add(const SelectMgr_IndexedMapOfOwner& mapOwner);
+    void clear();
+
+    int size() const;
+    Handle_SelectMgr_EntityOwner findOwner(const TopoDS_Shape& shape) const;
+
+private:
+    using MapShapeOwner = NCollection_DataMap<
+        TopoDS_Shape, Handle_SelectMgr_EntityOwner, TopTools_ShapeMapHasher>;
+    MapShapeOwner m_mapShapeOwner;
+};
+
+} // namespace Mayo
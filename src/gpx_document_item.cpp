@@ -30,6 +30,7 @@
 #include "gpx_document_item.h"
 
 #include "options.h"
+#include "view_redraw_scheduler.h"
 #include "fougtools/occtools/qt_utils.h"
 
 #include <AIS_InteractiveContext.hxx>
@@ -38,6 +39,27 @@
 
 namespace Mayo {
 
+void GpxPresentationUpdate::merge(const GpxPresentationUpdate& other)
+{
+    this->isRecomputeNeeded = this->isRecomputeNeeded || other.isRecomputeNeeded;
+    this->isRedrawNeeded = this->isRedrawNeeded || other.isRedrawNeeded;
+    if (other.displayMode != -1)
+        this->displayMode = other.displayMode;
+}
+
+void GpxPresentationUpdate::apply(const Handle_AIS_InteractiveObject& hndGpx) const
+{
+    Handle_AIS_InteractiveContext cxt = hndGpx->GetContext();
+    if (this->isRecomputeNeeded)
+        hndGpx->Redisplay(Standard_True); // All modes
+    // Presentation of a display mode not computed yet is computed with the
+    // final attributes
+    if (this->displayMode != -1)
+        cxt->SetDisplayMode(hndGpx, this->displayMode, Standard_False);
+    if (this->isRecomputeNeeded || this->isRedrawNeeded || this->displayMode != -1)
+        ViewRedrawScheduler::requestViewerRedraw(cxt);
+}
+
 GpxDocumentItem::GpxDocumentItem()
     : propertyIsVisible(this, tr("Visible")),
       propertyMaterial(this, tr("Material"), &enum_Graphic3dNameOfMaterial()),
@@ -52,9 +74,10 @@ void GpxDocumentItem::onPropertyChanged(Property *prop)
     if (prop == &this->propertyIsVisible) {
         Handle_AIS_InteractiveContext cxt = this->handleGpxObject()->GetContext();
         if (this->propertyIsVisible.value())
-            cxt->Display(this->handleGpxObject(), Standard_True);
+            cxt->Display(this->handleGpxObject(), Standard_False);
         else
-            cxt->Erase(this->handleGpxObject(), Standard_True);
+            cxt->Erase(this->handleGpxObject(), Standard_False);
+        ViewRedrawScheduler::requestViewerRedraw(cxt);
     }
 }
 
@@ -67,6 +90,10 @@ void GpxDocumentItem::initForGpxBRepShape(
     hndGpx->SetColor(occ::QtUtils::toOccColor(opts->brepShapeDefaultColor()));
     hndGpx->Attributes()->SetFaceBoundaryDraw(Standard_True);
     hndGpx->Attributes()->SetIsoOnTriangulation(Standard_True);
+    // Same deviation coefficient as the meshing stage of import, so AIS finds
+    // faces already tessellated
+    if (opts->importMeshingDeflection() > 0)
+        hndGpx->Attributes()->SetDeviationCoefficient(opts->importMeshingDeflection());
 
     Mayo_PropertyChangedBlocker(this);
     this->propertyMaterial.setValue(opts->brepShapeDefaultMaterial());
@@ -94,43 +121,42 @@ GpxBRepShapeCommonProperties::GpxBRepShapeCommonProperties(PropertyOwner* owner)
 {
 }
 
-void GpxBRepShapeCommonProperties::handleCommonPropertyChange(
+GpxPresentationUpdate GpxBRepShapeCommonProperties::handleCommonPropertyChange(
         Property *prop, const Handle_AIS_InteractiveObject &hndGpx)
 {
-    Handle_AIS_InteractiveContext cxt = hndGpx->GetContext();
+    GpxPresentationUpdate update;
     if (prop == &this->propertyTransparency) {
-        cxt->SetTransparency(
-                    hndGpx, this->propertyTransparency.value() / 100., Standard_True);
+        hndGpx->GetContext()->SetTransparency(
+                    hndGpx, this->propertyTransparency.value() / 100., Standard_False);
+        update.isRedrawNeeded = true;
     }
     else if (prop == &this->propertyDisplayMode) {
-        cxt->SetDisplayMode(
-                    hndGpx, this->propertyDisplayMode.value(), Standard_True);
+        update.displayMode = this->propertyDisplayMode.value();
     }
     else if (prop == &this->propertyShowFaceBoundary) {
         hndGpx->Attributes()->SetFaceBoundaryDraw(
                     this->propertyShowFaceBoundary.value());
-        hndGpx->Redisplay(Standard_True); // All modes
-        cxt->UpdateCurrentViewer();
+        update.isRecomputeNeeded = true;
     }
+    return update;
 }
 
-void GpxBRepShapeCommonProperties::handlePropertyMaterial(
+GpxPresentationUpdate GpxBRepShapeCommonProperties::handlePropertyMaterial(
         PropertyEnumeration *prop, const Handle_AIS_InteractiveObject &hndGpx)
 {
-    Handle_AIS_InteractiveContext cxt = hndGpx->GetContext();
+    GpxPresentationUpdate update;
     hndGpx->SetMaterial(prop->valueAs<Graphic3d_NameOfMaterial>());
-    cxt->UpdateCurrentViewer();
+    update.isRedrawNeeded = true;
+    return update;
 }
 
-void GpxBRepShapeCommonProperties::handlePropertyColor(
+GpxPresentationUpdate GpxBRepShapeCommonProperties::handlePropertyColor(
         PropertyOccColor *prop, const Handle_AIS_InteractiveObject &hndGpx)
 {
-    Handle_AIS_InteractiveContext cxt = hndGpx->GetContext();
+    GpxPresentationUpdate update;
     hndGpx->SetColor(prop->value());
-    if (this->propertyShowFaceBoundary.value()) {
-        hndGpx->Redisplay(Standard_True); // All modes
-        cxt->UpdateCurrentViewer();
-    }
+    update.isRecomputeNeeded = this->propertyShowFaceBoundary.value();
+    return update;
 }
 
 const Enumeration &GpxBRepShapeCommonProperties::enum_DisplayMode()
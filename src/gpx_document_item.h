@@ -17,6 +17,17 @@ namespace Mayo {
 
 class DocumentItem;
 
+// Presentation work required by property changes. Merged over the changes of
+// a property transaction, so each presentation is rebuilt at most once
+struct GpxPresentationUpdate {
+    bool isRecomputeNeeded = false; // All display modes
+    bool isRedrawNeeded = false;
+    int displayMode = -1; // New display mode, applied after recomputation
+
+    void merge(const GpxPresentationUpdate& other);
+    void apply(const Handle_AIS_InteractiveObject& hndGpx) const;
+};
+
 class GpxDocumentItem : public PropertyOwner {
     Q_DECLARE_TR_FUNCTIONS(Mayo::GpxDocumentItem)
 public:
@@ -66,11 +77,12 @@ protected:
 
     void initCommonProperties(
             PropertyOwner* owner, const Handle_AIS_InteractiveObject& hndGpx);
-    void handleCommonPropertyChange(
+    // Attributes of 'hndGpx' are changed, the presentation update is returned
+    GpxPresentationUpdate handleCommonPropertyChange(
             Property* prop, const Handle_AIS_InteractiveObject& hndGpx);
-    void handlePropertyMaterial(
+    GpxPresentationUpdate handlePropertyMaterial(
             PropertyEnumeration* prop, const Handle_AIS_InteractiveObject& hndGpx);
-    void handlePropertyColor(
+    GpxPresentationUpdate handlePropertyColor(
             PropertyOccColor* prop, const Handle_AIS_InteractiveObject& hndGpx);
 
 private:
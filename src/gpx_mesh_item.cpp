@@ -6,6 +6,7 @@
 
 #include "gpx_mesh_item.h"
 
+#include "ais_triangulation.h"
 #include "options.h"
 #include "fougtools/occtools/qt_utils.h"
 
@@ -20,21 +21,8 @@ namespace Mayo {
 
 namespace Internal {
 
-static void redisplayAndUpdateViewer(AIS_InteractiveObject* ptrGpx)
+static Handle_MeshVS_Mesh createMeshVS(const MeshItem* item)
 {
-    ptrGpx->Redisplay(Standard_True); // All modes
-    ptrGpx->GetContext()->UpdateCurrentViewer();
-}
-
-} // namespace Internal
-
-GpxMeshItem::GpxMeshItem(MeshItem *item)
-    : GpxCovariantDocumentItem(item),
-      propertyDisplayMode(this, tr("Display mode"), &enum_DisplayMode()),
-      propertyShowEdges(this, tr("Show edges")),
-      propertyShowNodes(this, tr("Show nodes"))
-{
-    // Create the MeshVS_Mesh object
     const Options* opts = Options::instance();
     Handle_XSDRAWSTLVRML_DataSource dataSource =
             new XSDRAWSTLVRML_DataSource(item->triangulation());
@@ -57,68 +45,118 @@ GpxMeshItem::GpxMeshItem(MeshItem *item)
     // -- Wireframe as default hilight mode
     meshVisu->SetHilightMode(MeshVS_DMF_WireFrame);
     meshVisu->SetMeshSelMethod(MeshVS_MSM_PRECISE);
+    return meshVisu;
+}
+
+static Handle_AisTriangulation createAisTriangulation(const MeshItem* item)
+{
+    const Options* opts = Options::instance();
+    Handle_AisTriangulation aisTriangulation =
+            new AisTriangulation(item->triangulation());
+    aisTriangulation->setEdgesShown(opts->meshDefaultShowEdges());
+    aisTriangulation->setNodesShown(opts->meshDefaultShowNodes());
+    aisTriangulation->SetMaterial(
+                Graphic3d_MaterialAspect(opts->meshDefaultMaterial()));
+    aisTriangulation->SetColor(
+                occ::QtUtils::toOccColor(opts->meshDefaultColor()));
+    aisTriangulation->SetDisplayMode(AisTriangulation::Shaded);
+    return aisTriangulation;
+}
 
-    m_hndGpxObject = meshVisu;
+} // namespace Internal
+
+GpxMeshItem::GpxMeshItem(MeshItem *item)
+    : GpxCovariantDocumentItem(item),
+      propertyDisplayMode(this, tr("Display mode"), &enum_DisplayMode()),
+      propertyShowEdges(this, tr("Show edges")),
+      propertyShowNodes(this, tr("Show nodes"))
+{
+    const Options* opts = Options::instance();
+    if (opts->meshPresentation() == Options::MeshPresentation::MeshVS)
+        m_hndGpxObject = Internal::createMeshVS(item);
+    else
+        m_hndGpxObject = Internal::createAisTriangulation(item);
 
     // Init properties
     Mayo_PropertyChangedBlocker(this);
-    // -- Material
-    Graphic3d_MaterialAspect materialAspect;
-    meshVisu->GetDrawer()->GetMaterial(
-                MeshVS_DA_FrontMaterial, materialAspect);
-    this->propertyMaterial.setValue(materialAspect.Name());
-    // -- Color
-    Quantity_Color color;
-    meshVisu->GetDrawer()->GetColor(MeshVS_DA_InteriorColor, color);
-    this->propertyColor.setValue(color);
-    // -- Display mode
-    this->propertyDisplayMode.setValue(meshVisu->DisplayMode());
-    // -- Show edges
-    Standard_Boolean boolVal;
-    meshVisu->GetDrawer()->GetBoolean(MeshVS_DA_ShowEdges, boolVal);
-    this->propertyShowEdges.setValue(boolVal == Standard_True);
-    // -- Show nodes
-    meshVisu->GetDrawer()->GetBoolean(MeshVS_DA_DisplayNodes, boolVal);
-    this->propertyShowNodes.setValue(boolVal == Standard_True);
+    this->propertyMaterial.setValue(opts->meshDefaultMaterial());
+    this->propertyColor.setValue(occ::QtUtils::toOccColor(opts->meshDefaultColor()));
+    this->propertyDisplayMode.setValue(m_hndGpxObject->DisplayMode());
+    this->propertyShowEdges.setValue(opts->meshDefaultShowEdges());
+    this->propertyShowNodes.setValue(opts->meshDefaultShowNodes());
 }
 
 void GpxMeshItem::onPropertyChanged(Property *prop)
 {
-    Handle_AIS_InteractiveContext cxt = this->gpxObject()->GetContext();
+    this->onPropertiesChanged({ prop });
+}
+
+// Attributes are changed for all properties, then presentations are
+// recomputed once
+void GpxMeshItem::onPropertiesChanged(const std::vector<Property*>& props)
+{
     Handle_AIS_InteractiveObject hndGpx = this->handleGpxObject();
-    MeshVS_Mesh* ptrGpx = this->gpxObject();
-    if (prop == &this->propertyMaterial) {
-        const Graphic3d_NameOfMaterial mat =
-                this->propertyMaterial.valueAs<Graphic3d_NameOfMaterial>();
-        ptrGpx->GetDrawer()->SetMaterial(
-                    MeshVS_DA_FrontMaterial, Graphic3d_MaterialAspect(mat));
-        Internal::redisplayAndUpdateViewer(ptrGpx);
-    }
-    else if (prop == &this->propertyColor) {
-        ptrGpx->GetDrawer()->SetColor(
-                    MeshVS_DA_InteriorColor, this->propertyColor.value());
-        Internal::redisplayAndUpdateViewer(ptrGpx);
+    auto meshVisu = Handle_MeshVS_Mesh::DownCast(hndGpx);
+    auto aisTriangulation = Handle_AisTriangulation::DownCast(hndGpx);
+    GpxPresentationUpdate update;
+    std::vector<Property*> vecOtherProp;
+    for (Property* prop : props) {
+        if (prop == &this->propertyMaterial) {
+            const Graphic3d_MaterialAspect mat(
+                        this->propertyMaterial.valueAs<Graphic3d_NameOfMaterial>());
+            if (!meshVisu.IsNull())
+                meshVisu->GetDrawer()->SetMaterial(MeshVS_DA_FrontMaterial, mat);
+            else
+                hndGpx->SetMaterial(mat);
+            update.isRecomputeNeeded = true;
+        }
+        else if (prop == &this->propertyColor) {
+            if (!meshVisu.IsNull()) {
+                meshVisu->GetDrawer()->SetColor(
+                            MeshVS_DA_InteriorColor, this->propertyColor.value());
+            }
+            else {
+                hndGpx->SetColor(this->propertyColor.value());
+            }
+            update.isRecomputeNeeded = true;
+        }
+        else if (prop == &this->propertyDisplayMode) {
+            update.displayMode = this->propertyDisplayMode.value();
+        }
+        else if (prop == &this->propertyShowEdges) {
+            if (!meshVisu.IsNull()) {
+                meshVisu->GetDrawer()->SetBoolean(
+                            MeshVS_DA_ShowEdges, this->propertyShowEdges.value());
+            }
+            else if (!aisTriangulation.IsNull()) {
+                aisTriangulation->setEdgesShown(this->propertyShowEdges.value());
+            }
+            update.isRecomputeNeeded = true;
+        }
+        else if (prop == &this->propertyShowNodes) {
+            if (!meshVisu.IsNull()) {
+                meshVisu->GetDrawer()->SetBoolean(
+                            MeshVS_DA_DisplayNodes, this->propertyShowNodes.value());
+            }
+            else if (!aisTriangulation.IsNull()) {
+                aisTriangulation->setNodesShown(this->propertyShowNodes.value());
+            }
+            update.isRecomputeNeeded = true;
+        }
+        else {
+            vecOtherProp.push_back(prop);
+        }
     }
-    else if (prop == &this->propertyDisplayMode) {
-        cxt->SetDisplayMode(
-                    hndGpx, this->propertyDisplayMode.value(), Standard_True);
-        //ptrGpx->SetDisplayMode(this->propertyDisplayMode.value());
-    }
-    else if (prop == &this->propertyShowEdges) {
-        ptrGpx->GetDrawer()->SetBoolean(
-                    MeshVS_DA_ShowEdges, this->propertyShowEdges.value());
-        Internal::redisplayAndUpdateViewer(ptrGpx);
-    }
-    else if (prop == &this->propertyShowNodes) {
-        ptrGpx->GetDrawer()->SetBoolean(
-                    MeshVS_DA_DisplayNodes, this->propertyShowNodes.value());
-        Internal::redisplayAndUpdateViewer(ptrGpx);
-    }
-    GpxDocumentItem::onPropertyChanged(prop);
+
+    update.apply(hndGpx);
+    // Display of the object(propertyIsVisible) comes with its final attributes
+    for (Property* prop : vecOtherProp)
+        GpxDocumentItem::onPropertyChanged(prop);
 }
 
 const Enumeration &GpxMeshItem::enum_DisplayMode()
 {
+    // AisTriangulation::DisplayMode values match MeshVS_DisplayModeFlags
     static Enumeration enumeration;
     if (enumeration.size() == 0) {
         enumeration.map(MeshVS_DMF_WireFrame, tr("Wireframe"));
@@ -8,12 +8,16 @@
 
 #include "gpx_document_item.h"
 #include "mesh_item.h"
-#include <MeshVS_Mesh.hxx>
+#include <AIS_InteractiveObject.hxx>
 
 namespace Mayo {
 
+//! Graphics of a MeshItem
+//! The underlying AIS object is either an AisTriangulation or a MeshVS_Mesh,
+//! depending on Options::meshPresentation() at creation time
 class GpxMeshItem :
-        public GpxCovariantDocumentItem<MeshItem, MeshVS_Mesh, Handle_MeshVS_Mesh>
+        public GpxCovariantDocumentItem<
+            MeshItem, AIS_InteractiveObject, Handle_AIS_InteractiveObject>
 {
     Q_DECLARE_TR_FUNCTIONS(Mayo::GpxMeshItem)
 
@@ -26,6 +30,7 @@ public:
 
 protected:
     void onPropertyChanged(Property* prop) override;
+    void onPropertiesChanged(const std::vector<Property*>& props) override;
 
 private:
     static const Enumeration& enum_DisplayMode();
@@ -6,39 +6,264 @@
 
 #include "gpx_xde_document_item.h"
 
+#include "options.h"
+#include "trace.h"
+#include "view_redraw_scheduler.h"
+#include "xde_part_index.h"
+
+#include <AIS_ConnectedInteractive.hxx>
+#include <AIS_InteractiveContext.hxx>
+#include <AIS_MultipleConnectedInteractive.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepTools.hxx>
+#include <NCollection_DataMap.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <TDF_LabelMapHasher.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
 #include <cassert>
 
 namespace Mayo {
 
+namespace Internal {
+
+// Shaded presentation arrays of 'shape' : position and normal per node, three
+// indices per triangle
+static size_t shapePresentationBytes(const TopoDS_Shape& shape)
+{
+    size_t bytes = 0;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& mesh =
+                BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc);
+        if (!mesh.IsNull()) {
+            bytes += mesh->NbNodes() * 2 * 3 * sizeof(float)
+                    + mesh->NbTriangles() * 3 * sizeof(int);
+        }
+    }
+    return bytes;
+}
+
+// Connected object and its presentation, which refers to the one of the
+// prototype
+static const size_t instanceOverheadBytes =
+        sizeof(AIS_ConnectedInteractive) + sizeof(Prs3d_Presentation);
+
+// Prototypes aren't in the interactive context by themselves, attributes are
+// changed directly and presentations are recomputed on next redisplay of the
+// connected objects
+static void setPrototypeAttribute(
+        const GpxXdeDocumentItem* gpxItem,
+        const Property* prop,
+        const Handle_XCAFPrs_AISObject& prototype)
+{
+    if (prop == &gpxItem->propertyMaterial)
+        prototype->SetMaterial(gpxItem->propertyMaterial.valueAs<Graphic3d_NameOfMaterial>());
+    else if (prop == &gpxItem->propertyColor)
+        prototype->SetColor(gpxItem->propertyColor.value());
+    else if (prop == &gpxItem->propertyTransparency)
+        prototype->SetTransparency(gpxItem->propertyTransparency.value() / 100.);
+    else if (prop == &gpxItem->propertyShowFaceBoundary)
+        prototype->Attributes()->SetFaceBoundaryDraw(gpxItem->propertyShowFaceBoundary.value());
+    else
+        return;
+
+    prototype->SetToUpdate();
+}
+
+// AIS would mesh again the shared parts, changing the triangulation seen by
+// the other items sharing them
+static bool canAutoTriangulate(const XdeDocumentItem* item, const TopoDS_Shape& shape)
+{
+    return !BRepTools::Triangulation(shape, Precision::Infinite())
+            && !XdePartIndex::instance()->hasParts(item);
+}
+
+} // namespace Internal
+
 GpxXdeDocumentItem::GpxXdeDocumentItem(XdeDocumentItem* item)
     : GpxCovariantDocumentItem(item),
       GpxBRepShapeCommonProperties(this)
 {
     const std::vector<TDF_Label> vecFreeShape = item->topLevelFreeShapes();
     assert(vecFreeShape.size() <= 1);
-    if (!vecFreeShape.empty()) {
+    if (!vecFreeShape.empty() && Options::instance()->isBrepShapeInstancedDisplayOn()) {
+        this->initInstancedDisplay(item);
+        GpxBRepShapeCommonProperties::initCommonProperties(this, m_hndGpxObject);
+    }
+    else if (!vecFreeShape.empty()) {
         m_hndGpxObject = new XCAFPrs_AISObject(vecFreeShape.front());
         GpxDocumentItem::initForGpxBRepShape(m_hndGpxObject);
         GpxBRepShapeCommonProperties::initCommonProperties(this, m_hndGpxObject);
+        // Faces were already triangulated by the import meshing stage, prevent
+        // AIS from meshing them again in the GUI thread
+        const TopoDS_Shape shape = item->shape(vecFreeShape.front());
+        if (!Internal::canAutoTriangulate(item, shape))
+            m_hndGpxObject->Attributes()->SetAutoTriangulation(Standard_False);
     }
     else { // Dummy
         m_hndGpxObject = new XCAFPrs_AISObject(item->cafDoc()->Main());
     }
 }
 
+bool GpxXdeDocumentItem::isInstanced() const
+{
+    return !m_vecPrototypeGpx.empty();
+}
+
+const std::vector<GpxXdeDocumentItem::ShapeInstance>& GpxXdeDocumentItem::instances() const
+{
+    return m_vecInstance;
+}
+
+const std::vector<Handle_AIS_InteractiveObject>& GpxXdeDocumentItem::instanceGpxObjects() const
+{
+    return m_vecInstanceGpx;
+}
+
+std::vector<GpxXdeDocumentItem::ShapeInstance>
+GpxXdeDocumentItem::findShapeInstances(const XdeDocumentItem* item)
+{
+    Mayo_TraceScope("GpxXdeDocumentItem::findShapeInstances");
+    struct PendingLabel {
+        TDF_Label label;
+        TopLoc_Location parentLoc; // Absolute location of the parent
+    };
+
+    // Labels are visited in pre-order, children are pushed in reverse order
+    std::vector<ShapeInstance> vecInstance;
+    std::vector<PendingLabel> vecPending;
+    const std::vector<TDF_Label> vecFreeShape = item->topLevelFreeShapes();
+    for (auto it = vecFreeShape.crbegin(); it != vecFreeShape.crend(); ++it)
+        vecPending.push_back({ *it, TopLoc_Location() });
+
+    while (!vecPending.empty()) {
+        const PendingLabel pending = vecPending.back();
+        vecPending.pop_back();
+        const TDF_Label& label = pending.label;
+        const TopLoc_Location absoluteLoc =
+                pending.parentLoc * item->shapeReferenceLocation(label);
+        if (item->isShapeReference(label) && item->hasShapeColor(label)) {
+            // Shape of the component is already located within its parent
+            vecInstance.push_back({ label, pending.parentLoc });
+        }
+        else if (item->isShapeAssembly(label)) {
+            const std::vector<TDF_Label> vecComponent = item->shapeComponents(label);
+            for (auto it = vecComponent.crbegin(); it != vecComponent.crend(); ++it)
+                vecPending.push_back({ *it, absoluteLoc });
+        }
+        else if (item->isShapeReference(label)) {
+            vecPending.push_back({ item->shapeReferred(label), absoluteLoc });
+        }
+        else if (item->isShape(label)) {
+            // Absolute location includes the own location of the shape
+            const TopLoc_Location shapeLoc = item->shape(label).Location();
+            vecInstance.push_back({ label, absoluteLoc * shapeLoc.Inverted() });
+        }
+    }
+
+    return vecInstance;
+}
+
+GpxXdeDocumentItem::MemoryReport GpxXdeDocumentItem::memoryReport(const XdeDocumentItem* item)
+{
+    MemoryReport report = {};
+    NCollection_DataMap<TDF_Label, size_t, TDF_LabelMapHasher> mapLabelBytes;
+    for (const ShapeInstance& instance : GpxXdeDocumentItem::findShapeInstances(item)) {
+        const size_t* ptrBytes = mapLabelBytes.Seek(instance.label);
+        const size_t bytes =
+                ptrBytes != nullptr ?
+                    *ptrBytes :
+                    Internal::shapePresentationBytes(item->shape(instance.label));
+        if (ptrBytes == nullptr) {
+            mapLabelBytes.Bind(instance.label, bytes);
+            report.instancedBytes += bytes;
+        }
+
+        report.expandedBytes += bytes;
+        report.instancedBytes += Internal::instanceOverheadBytes;
+        ++report.instanceCount;
+    }
+
+    report.prototypeCount = mapLabelBytes.Extent();
+    return report;
+}
+
 void GpxXdeDocumentItem::onPropertyChanged(Property* prop)
+{
+    this->onPropertiesChanged({ prop });
+}
+
+void GpxXdeDocumentItem::onPropertiesChanged(const std::vector<Property*>& props)
 {
     Handle_AIS_InteractiveObject hndGpx = this->handleGpxObject();
-    if (prop == &this->propertyMaterial) {
-        GpxBRepShapeCommonProperties::handlePropertyMaterial(
-                    &this->propertyMaterial, hndGpx);
+    GpxPresentationUpdate update;
+    bool isPrototypeChanged = false;
+    bool isVisibilityChanged = false;
+    for (Property* prop : props) {
+        if (prop == &this->propertyMaterial) {
+            update.merge(GpxBRepShapeCommonProperties::handlePropertyMaterial(
+                             &this->propertyMaterial, hndGpx));
+        }
+        else if (prop == &this->propertyColor) {
+            update.merge(GpxBRepShapeCommonProperties::handlePropertyColor(
+                             &this->propertyColor, hndGpx));
+        }
+        update.merge(GpxBRepShapeCommonProperties::handleCommonPropertyChange(prop, hndGpx));
+
+        if (this->isInstanced() && prop != &this->propertyIsVisible) {
+            for (const Handle_XCAFPrs_AISObject& prototype : m_vecPrototypeGpx)
+                Internal::setPrototypeAttribute(this, prop, prototype);
+            isPrototypeChanged = true;
+        }
+
+        if (prop == &this->propertyIsVisible)
+            isVisibilityChanged = true;
     }
-    else if (prop == &this->propertyColor) {
-        GpxBRepShapeCommonProperties::handlePropertyColor(
-                    &this->propertyColor, hndGpx);
+
+    // Connected objects are recomputed from the prototypes by the context
+    if (isPrototypeChanged) {
+        update.isRecomputeNeeded = false;
+        update.isRedrawNeeded = true;
+        hndGpx->GetContext()->Redisplay(hndGpx, Standard_False);
     }
-    GpxBRepShapeCommonProperties::handleCommonPropertyChange(prop, hndGpx);
-    GpxDocumentItem::onPropertyChanged(prop);
+
+    update.apply(hndGpx);
+    // Display of the object comes with its final attributes
+    if (isVisibilityChanged)
+        GpxDocumentItem::onPropertyChanged(&this->propertyIsVisible);
+}
+
+// Each distinct label of instances gets one XCAFPrs_AISObject, computed once
+// and connected at the location of every instance. Colors of the XDE document
+// are kept as they are collected by each prototype
+void GpxXdeDocumentItem::initInstancedDisplay(XdeDocumentItem* item)
+{
+    Mayo_TraceScope("GpxXdeDocumentItem::initInstancedDisplay");
+    m_vecInstance = GpxXdeDocumentItem::findShapeInstances(item);
+    Handle_AIS_MultipleConnectedInteractive gpxAssembly = new AIS_MultipleConnectedInteractive;
+    NCollection_DataMap<TDF_Label, Handle_XCAFPrs_AISObject, TDF_LabelMapHasher> mapPrototype;
+    m_vecInstanceGpx.reserve(m_vecInstance.size());
+    for (const ShapeInstance& instance : m_vecInstance) {
+        Handle_XCAFPrs_AISObject prototype;
+        if (!mapPrototype.Find(instance.label, prototype)) {
+            prototype = new XCAFPrs_AISObject(instance.label);
+            GpxDocumentItem::initForGpxBRepShape(prototype);
+            const TopoDS_Shape shape = item->shape(instance.label);
+            if (!Internal::canAutoTriangulate(item, shape))
+                prototype->Attributes()->SetAutoTriangulation(Standard_False);
+            mapPrototype.Bind(instance.label, prototype);
+            m_vecPrototypeGpx.push_back(prototype);
+        }
+
+        m_vecInstanceGpx.push_back(
+                    gpxAssembly->Connect(prototype, instance.location.Transformation()));
+    }
+
+    m_hndGpxObject = gpxAssembly;
+    GpxDocumentItem::initForGpxBRepShape(m_hndGpxObject);
 }
 
 } // namespace Mayo
@@ -10,19 +10,57 @@
 #include "gpx_document_item.h"
 #include <XCAFPrs_AISObject.hxx>
 
+#include <cstddef>
+#include <vector>
+
 namespace Mayo {
 
 class GpxXdeDocumentItem :
-        public GpxCovariantDocumentItem<XdeDocumentItem, XCAFPrs_AISObject, Handle_XCAFPrs_AISObject>,
+        public GpxCovariantDocumentItem<XdeDocumentItem, AIS_InteractiveObject, Handle_AIS_InteractiveObject>,
         public GpxBRepShapeCommonProperties
 {
     Q_DECLARE_TR_FUNCTIONS(Mayo::GpxXdeDocumentItem)
 
 public:
+    // Occurrence of a shape in the assembly. 'label' is a simple shape, or a
+    // component having its own color so it can't share the presentation of
+    // the referred shape
+    struct ShapeInstance {
+        TDF_Label label;
+        TopLoc_Location location; // To apply to the presentation of 'label'
+    };
+
+    // Estimated memory of the presentation arrays in expanded and in instanced
+    // display modes, computed from the triangulations of faces
+    struct MemoryReport {
+        int instanceCount;
+        int prototypeCount; // Distinct labels of instances
+        size_t expandedBytes;
+        size_t instancedBytes;
+    };
+
+    // Instanced display depends on Options::isBrepShapeInstancedDisplayOn()
     GpxXdeDocumentItem(XdeDocumentItem* item);
 
+    bool isInstanced() const;
+    // Connected objects of the instanced display, same order as instances()
+    const std::vector<ShapeInstance>& instances() const;
+    const std::vector<Handle_AIS_InteractiveObject>& instanceGpxObjects() const;
+
+    // Walks the labels of 'item', its assembly tree isn't fetched
+    static std::vector<ShapeInstance> findShapeInstances(const XdeDocumentItem* item);
+    static MemoryReport memoryReport(const XdeDocumentItem* item);
+
 protected:
     void onPropertyChanged(Property* prop) override;
+    void onPropertiesChanged(const std::vector<Property*>& props) override;
+
+private:
+    void initInstancedDisplay(XdeDocumentItem* item);
+
+    std::vector<ShapeInstance> m_vecInstance;
+    std::vector<Handle_AIS_InteractiveObject> m_vecInstanceGpx;
+    std::vector<Handle_XCAFPrs_AISObject> m_vecPrototypeGpx;
 };
 
 } // namespace Mayo
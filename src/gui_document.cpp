@@ -6,6 +6,7 @@
 
 #include "gui_document.h"
 
+#include "ais_triangulation.h"
 #include "application_item.h"
 #include "bnd_utils.h"
 #include "brep_utils.h"
@@ -16,17 +17,29 @@
 #include "gpx_utils.h"
 #include "gpx_xde_document_item.h"
 #include "mesh_item.h"
+#include "options.h"
+#include "trace.h"
+#include "view_redraw_scheduler.h"
 #include "xde_document_item.h"
+#include "fougtools/qttools/task/work_stealing_pool.h"
 
+#include <AIS_Selection.hxx>
+#include <BRepBndLib.hxx>
 #include <AIS_Trihedron.hxx>
 #include <Aspect_DisplayConnection.hxx>
 #include <Geom_Axis2Placement.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
 #include <OpenGl_GraphicDriver.hxx>
-#include <V3d_TypeOfOrientation.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <SelectMgr_SelectionManager.hxx>
 #include <StdSelect_BRepOwner.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <V3d_TypeOfOrientation.hxx>
 
 #include <cassert>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
 
 namespace Mayo {
 
@@ -93,13 +106,210 @@ static Handle_AIS_Trihedron createOriginTrihedron()
     return aisTrihedron;
 }
 
+// Toggles the selection state of owners and then highlights the whole selection
+// in one pass, AddOrRemoveSelected() would update highlighting per owner
+static void AisContext_toggleOwnersSelected(
+        const Handle_AIS_InteractiveContext& context,
+        const std::vector<Handle_SelectMgr_EntityOwner>& vecOwner)
+{
+    if (vecOwner.empty())
+        return;
+
+    context->UnhilightSelected(false);
+    const Handle_AIS_Selection& selection = context->Selection();
+    for (const Handle_SelectMgr_EntityOwner& owner : vecOwner) {
+        const AIS_SelectStatus status = selection->Select(owner);
+        owner->SetSelected(status == AIS_SS_Added);
+    }
+    context->HilightSelected(false);
+}
+
+static TopAbs_ShapeEnum toShapeType(GuiDocument::PickGranularity granularity)
+{
+    switch (granularity) {
+    case GuiDocument::PickGranularity::Face: return TopAbs_FACE;
+    case GuiDocument::PickGranularity::Edge: return TopAbs_EDGE;
+    case GuiDocument::PickGranularity::Vertex: return TopAbs_VERTEX;
+    }
+    return TopAbs_FACE;
+}
+
+// Bounding box computed from the item geometry, bounds of the presentation
+// are the fallback
+static Bnd_Box documentItemBoundingBox(
+        const DocumentItem* item, const GpxDocumentItem* gpxItem)
+{
+    Bnd_Box box;
+    if (sameType<XdeDocumentItem>(item)) {
+        auto xdeItem = static_cast<const XdeDocumentItem*>(item);
+        for (const TDF_Label& label : xdeItem->topLevelFreeShapes())
+            BRepBndLib::Add(xdeItem->shape(label), box);
+    }
+    else if (sameType<MeshItem>(item)) {
+        box = static_cast<const MeshItem*>(item)->massProperties().boundingBox;
+    }
+
+    if (box.IsVoid())
+        box = BndUtils::get(gpxItem->handleGpxObject());
+    return box;
+}
+
+using LodProxies = std::vector<Handle_AIS_InteractiveObject>;
+
+// Triangle ratio of each level of detail proxy, full detail is the item itself
+static const double lodRatios[] = { 0.01, 0.1 };
+static const int lodFullLevel = 2;
+// Items below this count of triangles are always displayed with full detail
+static const int lodMinTriangleCount = 200000;
+
+// Proxies are built by a job of the global WorkStealingPool, items below
+// lodMinTriangleCount get an empty list without any job
+static std::shared_future<LodProxies> asyncCreateLodProxies(
+        const DocumentItem* item, const GpxDocumentItem* gpxItem)
+{
+    Handle_Poly_Triangulation mesh;
+    // Handles to the face triangulations are taken here, so the job doesn't
+    // explore the shape. Faces may get new triangulations meanwhile, the job
+    // then works on the previous ones
+    std::vector<BRepUtils::FaceTriangulation> vecFaceMesh;
+    int triangleCount = 0;
+    if (sameType<XdeDocumentItem>(item)) {
+        auto xdeItem = static_cast<const XdeDocumentItem*>(item);
+        for (const TDF_Label& label : xdeItem->topLevelFreeShapes()) {
+            for (BRepUtils::FaceTriangulation& faceMesh :
+                     BRepUtils::faceTriangulations(xdeItem->shape(label)))
+            {
+                triangleCount += faceMesh.mesh->NbTriangles();
+                vecFaceMesh.push_back(std::move(faceMesh));
+            }
+        }
+    }
+    else if (sameType<MeshItem>(item)) {
+        mesh = static_cast<const MeshItem*>(item)->triangulation();
+        triangleCount = !mesh.IsNull() ? mesh->NbTriangles() : 0;
+    }
+
+    auto promise = std::make_shared<std::promise<LodProxies>>();
+    std::shared_future<LodProxies> future = promise->get_future().share();
+    if (triangleCount < lodMinTriangleCount) {
+        promise->set_value(LodProxies());
+        return future;
+    }
+
+    const Quantity_Color color = gpxItem->propertyColor.value();
+    const Graphic3d_MaterialAspect material(
+                gpxItem->propertyMaterial.valueAs<Graphic3d_NameOfMaterial>());
+    qttask::WorkStealingPool::globalInstance()->submit([=]{
+        Mayo_TraceScope("GuiDocument::createLodProxies");
+        const Handle_Poly_Triangulation fullMesh =
+                mesh.IsNull() ? BRepUtils::mergedTriangulation(vecFaceMesh) : mesh;
+        LodProxies vecProxy;
+        for (double ratio : lodRatios) {
+            const Handle_Poly_Triangulation lodMesh =
+                    occ::MeshUtils::simplifiedTriangulation(fullMesh, ratio);
+            if (lodMesh.IsNull()) {
+                vecProxy.clear();
+                break;
+            }
+
+            Handle_AisTriangulation proxy = new AisTriangulation(lodMesh);
+            proxy->SetColor(color);
+            proxy->SetMaterial(material);
+            proxy->computePrimitiveArrays();
+            vecProxy.push_back(proxy);
+        }
+
+        promise->set_value(std::move(vecProxy));
+    });
+    return future;
+}
+
+template<typename T>
+bool isFutureReady(const std::shared_future<T>& future)
+{
+    return future.valid()
+            && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+struct FaceOwners {
+    opencascade::handle<SelectMgr_IndexedMapOfOwner> mapOwner;
+    // Instanced display : owners of an instance have the shapes of its
+    // prototype, they are moved at the instance location so they match the
+    // shapes located from the assembly tree
+    std::unordered_map<const SelectMgr_SelectableObject*, TopLoc_Location> mapInstanceLoc;
+};
+
+// Computes face sensitive entities of 'gpxItem', without activation, if not
+// done yet
+static FaceOwners loadFaceOwners(
+        const Handle_AIS_InteractiveContext& aisContext,
+        const DocumentItem* docItem,
+        const GpxDocumentItem* gpxItem)
+{
+    const Handle_AIS_InteractiveObject aisObject = gpxItem->handleGpxObject();
+    const int faceMode = AIS_Shape::SelectionMode(TopAbs_FACE);
+    {
+        Mayo_TraceScope("GuiDocument::loadFaceSelection");
+        aisContext->SelectionManager()->Load(aisObject, faceMode);
+    }
+    FaceOwners faceOwners;
+    aisContext->EntityOwners(faceOwners.mapOwner, aisObject, faceMode);
+    if (sameType<XdeDocumentItem>(docItem)) {
+        auto gpxXdeItem = static_cast<const GpxXdeDocumentItem*>(gpxItem);
+        const std::vector<Handle_AIS_InteractiveObject>& vecInstanceGpx =
+                gpxXdeItem->instanceGpxObjects();
+        for (size_t i = 0; i < vecInstanceGpx.size(); ++i) {
+            faceOwners.mapInstanceLoc.emplace(
+                        vecInstanceGpx.at(i).get(), gpxXdeItem->instances().at(i).location);
+        }
+    }
+
+    return faceOwners;
+}
+
+// Owners of the faces of 'shape', linear search for when the owner index
+// isn't available yet
+static std::vector<Handle_SelectMgr_EntityOwner> findFaceOwners(
+        const FaceOwners& faceOwners, const TopoDS_Shape& shape)
+{
+    std::vector<Handle_SelectMgr_EntityOwner> vecOwner;
+    if (faceOwners.mapOwner.IsNull())
+        return vecOwner;
+
+    TopTools_MapOfShape mapFace;
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        mapFace.Add(face);
+    });
+    for (auto it = faceOwners.mapOwner->cbegin(); it != faceOwners.mapOwner->cend(); ++it) {
+        auto brepOwner = Handle_StdSelect_BRepOwner::DownCast(*it);
+        if (brepOwner.IsNull() || !brepOwner->HasShape())
+            continue;
+
+        TopoDS_Shape ownerShape = brepOwner->Shape();
+        if (!faceOwners.mapInstanceLoc.empty()) {
+            const auto itLoc = faceOwners.mapInstanceLoc.find((*it)->Selectable().get());
+            if (itLoc == faceOwners.mapInstanceLoc.cend())
+                continue;
+            ownerShape.Move(itLoc->second);
+        }
+
+        if (mapFace.Contains(ownerShape))
+            vecOwner.push_back(*it);
+    }
+
+    return vecOwner;
+}
+
 } // namespace Internal
 
 GuiDocument::GuiDocument(Document *doc)
     : m_document(doc),
       m_v3dViewer(Internal::createOccViewer()),
       m_aisContext(new AIS_InteractiveContext(m_v3dViewer)),
-      m_v3dView(m_v3dViewer->CreateView())
+      m_v3dView(m_v3dViewer->CreateView()),
+      m_redrawScheduler(new ViewRedrawScheduler(m_v3dView, this)),
+      m_lodLevel(Internal::lodFullLevel),
+      m_lodInteractionLevel(Internal::lodFullLevel)
 {
     assert(doc != nullptr);
 
@@ -121,6 +331,7 @@ GuiDocument::GuiDocument(Document *doc)
     m_aisContext->Display(Internal::createOriginTrihedron(), true);
 
     QObject::connect(doc, &Document::itemAdded, this, &GuiDocument::onItemAdded);
+    QObject::connect(doc, &Document::itemsAdded, this, &GuiDocument::onItemsAdded);
     QObject::connect(doc, &Document::itemErased, this, &GuiDocument::onItemErased);
 }
 
@@ -139,6 +350,11 @@ const Handle_AIS_InteractiveContext &GuiDocument::aisInteractiveContext() const
     return m_aisContext;
 }
 
+ViewRedrawScheduler* GuiDocument::redrawScheduler() const
+{
+    return m_redrawScheduler;
+}
+
 GpxDocumentItem *GuiDocument::findItemGpx(const DocumentItem *item) const
 {
     const GuiDocumentItem* guiDocItem = this->findGuiDocumentItem(item);
@@ -152,31 +368,39 @@ const Bnd_Box &GuiDocument::gpxBoundingBox() const
 
 void GuiDocument::toggleItemSelected(const ApplicationItem &appItem)
 {
+    Mayo_TraceScope("GuiDocument::toggleItemSelected");
     if (appItem.document() != this->document())
         return;
+    if (!m_isPickingActivated)
+        this->activatePicking();
     if (appItem.isXdeAssemblyNode()) {
         const XdeAssemblyNode& xdeAsmNode = appItem.xdeAssemblyNode();
         const XdeDocumentItem* xdeItem = xdeAsmNode.ownerDocItem;
-        const GuiDocumentItem* guiItem = this->findGuiDocumentItem(xdeItem);
+        GuiDocumentItem* guiItem = this->findGuiDocumentItem(xdeItem);
         if (guiItem != nullptr) {
+            this->loadBRepOwnerIndex(guiItem);
             const TopLoc_Location shapeLoc =
                     xdeItem->shapeAbsoluteLocation(xdeAsmNode.nodeId);
             const TopoDS_Shape shape =
                     xdeItem->shape(xdeAsmNode.label()).Located(shapeLoc);
-            std::vector<TopoDS_Face> vecFace;
-            if (BRepUtils::moreComplex(shape.ShapeType(), TopAbs_FACE)) {
+            std::vector<Handle_SelectMgr_EntityOwner> vecOwner;
+            if (Internal::isFutureReady(guiItem->futureBRepOwnerIndex)) {
+                const GpxBRepOwnerIndex& ownerIndex = guiItem->futureBRepOwnerIndex.get();
                 BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
-                    vecFace.push_back(face);
+                    auto brepOwner = ownerIndex.findOwner(face);
+                    if (!brepOwner.IsNull())
+                        vecOwner.push_back(std::move(brepOwner));
                 });
             }
-            else if (shape.ShapeType() == TopAbs_FACE) {
-                vecFace.push_back(TopoDS::Face(shape));
-            }
-            for (const TopoDS_Face& face : vecFace) {
-                auto brepOwner = guiItem->findBrepOwner(face);
-                if (!brepOwner.IsNull())
-                    m_aisContext->AddOrRemoveSelected(brepOwner, false);
+            else {
+                // Index still being built, the GUI thread doesn't wait for it
+                const Internal::FaceOwners faceOwners =
+                        Internal::loadFaceOwners(
+                            m_aisContext, guiItem->docItem, guiItem->gpxDocItem);
+                vecOwner = Internal::findFaceOwners(faceOwners, shape);
             }
+
+            Internal::AisContext_toggleOwnersSelected(m_aisContext, vecOwner);
         }
     }
     else if (appItem.isDocumentItem()) {
@@ -198,32 +422,119 @@ void GuiDocument::clearItemSelection()
     m_aisContext->ClearSelected(false);
 }
 
+GuiDocument::PickGranularity GuiDocument::pickGranularity() const
+{
+    return m_pickGranularity;
+}
+
+void GuiDocument::setPickGranularity(PickGranularity granularity)
+{
+    m_pickGranularity = granularity;
+    this->activatePicking();
+}
+
+void GuiDocument::activatePicking()
+{
+    m_isPickingActivated = true;
+    for (GuiDocumentItem& guiItem : m_vecGuiDocumentItem)
+        this->activateItemPicking(&guiItem);
+}
+
 void GuiDocument::updateV3dViewer()
 {
-    m_aisContext->UpdateCurrentViewer();
+    m_redrawScheduler->requestRedraw();
+}
+
+void GuiDocument::beginViewInteraction()
+{
+    if (m_isViewInteracting)
+        return;
+
+    m_isViewInteracting = true;
+    m_viewInteractionFrameCount = 0;
+    m_viewInteractionTime = 0.;
+    m_lodFrameTimeTarget = Options::instance()->viewLodFrameTimeTarget();
+    if (m_lodFrameTimeTarget > 0)
+        this->setLodLevel(m_lodInteractionLevel);
+}
+
+void GuiDocument::endViewInteraction()
+{
+    if (!m_isViewInteracting)
+        return;
+
+    m_isViewInteracting = false;
+    if (m_viewInteractionFrameCount > 0 && m_viewInteractionTime > 0.) {
+        emit viewInteractionFpsMeasured(
+                    1000. * m_viewInteractionFrameCount / m_viewInteractionTime);
+    }
+
+    m_lodInteractionLevel = m_lodLevel;
+    if (m_lodLevel != Internal::lodFullLevel) {
+        this->setLodLevel(Internal::lodFullLevel);
+        m_redrawScheduler->requestRedraw();
+    }
+}
+
+void GuiDocument::addViewInteractionFrame(double frameTime)
+{
+    if (!m_isViewInteracting)
+        return;
+
+    ++m_viewInteractionFrameCount;
+    m_viewInteractionTime += frameTime;
+    if (m_lodFrameTimeTarget <= 0)
+        return;
+
+    // First frame after a level change includes computation of presentations
+    if (m_isLodFrameSkipped) {
+        m_isLodFrameSkipped = false;
+        return;
+    }
+
+    // Each level has ten times the triangles of the previous one, a wide
+    // margin avoids oscillation between two levels
+    if (frameTime > m_lodFrameTimeTarget && m_lodLevel > 0)
+        this->setLodLevel(m_lodLevel - 1);
+    else if (frameTime < m_lodFrameTimeTarget / 4. && m_lodLevel < Internal::lodFullLevel)
+        this->setLodLevel(m_lodLevel + 1);
 }
 
 void GuiDocument::onItemAdded(DocumentItem *item)
 {
-    GuiDocumentItem guiItem(item, Internal::createGpxForItem(item));
-    const Handle_AIS_InteractiveObject aisObject = guiItem.gpxDocItem->handleGpxObject();
-    m_aisContext->Display(aisObject, true);
-    if (sameType<XdeDocumentItem>(item)) {
-        m_aisContext->Activate(aisObject, AIS_Shape::SelectionMode(TopAbs_VERTEX));
-        m_aisContext->Activate(aisObject, AIS_Shape::SelectionMode(TopAbs_EDGE));
-        m_aisContext->Activate(aisObject, AIS_Shape::SelectionMode(TopAbs_FACE));
-//        m_aisContext->Activate(aisObject, AIS_Shape::SelectionMode(TopAbs_SOLID));
-        opencascade::handle<SelectMgr_IndexedMapOfOwner> mapEntityOwner;
-        m_aisContext->EntityOwners(
-                    mapEntityOwner, aisObject, AIS_Shape::SelectionMode(TopAbs_FACE));
-        guiItem.vecGpxEntityOwner.reserve(mapEntityOwner->Extent());
-        for (auto it = mapEntityOwner->cbegin(); it != mapEntityOwner->cend(); ++it)
-            guiItem.vecGpxEntityOwner.push_back(std::move(*it));
+    this->onItemsAdded({ item });
+}
+
+void GuiDocument::onItemsAdded(const std::vector<DocumentItem*>& items)
+{
+    if (items.empty())
+        return;
+
+    Mayo_TraceScope("GuiDocument::displayItems");
+    for (DocumentItem* item : items) {
+        GuiDocumentItem guiItem(item, Internal::createGpxForItem(item));
+        const Handle_AIS_InteractiveObject aisObject =
+                guiItem.gpxDocItem->handleGpxObject();
+        if (sameType<XdeDocumentItem>(item)) {
+            // No selection mode activated, sensitive entities are computed on demand
+            m_aisContext->Display(aisObject, aisObject->DisplayMode(), -1, false);
+        }
+        else {
+            m_aisContext->Display(aisObject, false);
+        }
+        guiItem.bndBox = Internal::documentItemBoundingBox(item, guiItem.gpxDocItem);
+        m_gpxBndBoxAggregate.add(guiItem.bndBox);
+        guiItem.futureLodProxies =
+                Internal::asyncCreateLodProxies(item, guiItem.gpxDocItem);
+        m_vecGuiDocumentItem.emplace_back(std::move(guiItem));
+        if (m_isPickingActivated)
+            this->activateItemPicking(&m_vecGuiDocumentItem.back());
     }
-    m_vecGuiDocumentItem.emplace_back(std::move(guiItem));
+
+    // Single fit for the whole batch, V3d_View::FitAll() also redraws the view
+    Mayo_TraceScope("GuiDocument::fitAll");
     GpxUtils::V3dView_fitAll(m_v3dView);
-    BndUtils::add(&m_gpxBoundingBox, BndUtils::get(aisObject));
-    emit gpxBoundingBoxChanged(m_gpxBoundingBox);
+    this->updateGpxBoundingBox();
 }
 
 void GuiDocument::onItemErased(const DocumentItem *item)
@@ -233,18 +544,56 @@ void GuiDocument::onItemErased(const DocumentItem *item)
                 m_vecGuiDocumentItem.end(),
                 [=](const GuiDocumentItem& guiItem) { return guiItem.docItem == item; });
     if (itFound != m_vecGuiDocumentItem.end()) {
-        // Delete gpx item
+        // Delete gpx item, proxies are deleted along with the guiItem
         GpxDocumentItem* gpxDocItem = itFound->gpxDocItem;
         GpxUtils::AisContext_eraseObject(m_aisContext, gpxDocItem->handleGpxObject());
         delete gpxDocItem;
+        m_gpxBndBoxAggregate.remove(itFound->bndBox);
         m_vecGuiDocumentItem.erase(itFound);
+        this->updateGpxBoundingBox();
+    }
+}
 
-        // Recompute bounding box
-        m_gpxBoundingBox.SetVoid();
-        for (const GuiDocumentItem& guiItem : m_vecGuiDocumentItem) {
-            const Bnd_Box otherBox = BndUtils::get(guiItem.gpxDocItem->handleGpxObject());
-            BndUtils::add(&m_gpxBoundingBox, otherBox);
+void GuiDocument::setLodLevel(int level)
+{
+    if (level == m_lodLevel)
+        return;
+
+    // Presentations are switched directly in the presentation manager, so
+    // selection and AIS status of items are left untouched
+    const Handle_PrsMgr_PresentationManager3d& prsMgr = m_aisContext->MainPrsMgr();
+    auto fnSetShown = [&](const Handle_AIS_InteractiveObject& object, bool on) {
+        const int mode = object->DisplayMode();
+        if (on)
+            prsMgr->Display(object, mode);
+        else if (prsMgr->IsDisplayed(object, mode))
+            prsMgr->Erase(object, mode);
+    };
+    for (const GuiDocumentItem& guiItem : m_vecGuiDocumentItem) {
+        if (!Internal::isFutureReady(guiItem.futureLodProxies)
+                || !guiItem.gpxDocItem->propertyIsVisible.value())
+        {
+            continue;
         }
+
+        const Internal::LodProxies& vecProxy = guiItem.futureLodProxies.get();
+        if (vecProxy.empty())
+            continue;
+
+        for (size_t i = 0; i < vecProxy.size(); ++i)
+            fnSetShown(vecProxy.at(i), static_cast<int>(i) == level);
+        fnSetShown(guiItem.gpxDocItem->handleGpxObject(), level == Internal::lodFullLevel);
+    }
+
+    m_lodLevel = level;
+    m_isLodFrameSkipped = true;
+}
+
+void GuiDocument::updateGpxBoundingBox()
+{
+    const Bnd_Box box = m_gpxBndBoxAggregate.box();
+    if (!BndUtils::isEqual(box, m_gpxBoundingBox)) {
+        m_gpxBoundingBox = box;
         emit gpxBoundingBoxChanged(m_gpxBoundingBox);
     }
 }
@@ -259,22 +608,62 @@ GuiDocument::findGuiDocumentItem(const DocumentItem *item) const
     return itFound != m_vecGuiDocumentItem.cend() ? &(*itFound) : nullptr;
 }
 
-GuiDocument::GuiDocumentItem::GuiDocumentItem(DocumentItem *item, GpxDocumentItem *gpx)
-    : docItem(item), gpxDocItem(gpx)
+GuiDocument::GuiDocumentItem* GuiDocument::findGuiDocumentItem(const DocumentItem* item)
 {
+    const GuiDocument* constThis = this;
+    return const_cast<GuiDocumentItem*>(constThis->findGuiDocumentItem(item));
 }
 
-Handle_SelectMgr_EntityOwner GuiDocument::GuiDocumentItem::findBrepOwner(const TopoDS_Face& face) const
+void GuiDocument::activateItemPicking(GuiDocumentItem* guiItem)
+{
+    if (!sameType<XdeDocumentItem>(guiItem->docItem))
+        return;
+
+    const int mode = AIS_Shape::SelectionMode(Internal::toShapeType(m_pickGranularity));
+    if (guiItem->pickSelectionMode == mode)
+        return;
+
+    const Handle_AIS_InteractiveObject aisObject = guiItem->gpxDocItem->handleGpxObject();
+    if (guiItem->pickSelectionMode != -1)
+        m_aisContext->Deactivate(aisObject, guiItem->pickSelectionMode);
+    m_aisContext->Activate(aisObject, mode);
+    guiItem->pickSelectionMode = mode;
+    // Face owners now exist, index them ahead of any selection from the tree
+    if (m_pickGranularity == PickGranularity::Face)
+        this->loadBRepOwnerIndex(guiItem);
+}
+
+void GuiDocument::loadBRepOwnerIndex(GuiDocumentItem* guiItem)
+{
+    if (guiItem->futureBRepOwnerIndex.valid())
+        return;
+
+    const Internal::FaceOwners faceOwners =
+            Internal::loadFaceOwners(m_aisContext, guiItem->docItem, guiItem->gpxDocItem);
+    // Owners are only read by the worker thread, hashing their shapes is
+    // safe concurrently with the GUI thread
+    guiItem->futureBRepOwnerIndex = std::async(std::launch::async, [=]{
+        Mayo_TraceScope("GuiDocument::indexBRepOwners");
+        const opencascade::handle<SelectMgr_IndexedMapOfOwner>& mapEntityOwner =
+                faceOwners.mapOwner;
+        GpxBRepOwnerIndex ownerIndex;
+        if (!mapEntityOwner.IsNull() && faceOwners.mapInstanceLoc.empty()) {
+            ownerIndex.add(*mapEntityOwner);
+        }
+        else if (!mapEntityOwner.IsNull()) {
+            for (auto it = mapEntityOwner->cbegin(); it != mapEntityOwner->cend(); ++it) {
+                const auto itLoc = faceOwners.mapInstanceLoc.find((*it)->Selectable().get());
+                if (itLoc != faceOwners.mapInstanceLoc.cend())
+                    ownerIndex.add(*it, itLoc->second);
+            }
+        }
+        return ownerIndex;
+    }).share();
+}
+
+GuiDocument::GuiDocumentItem::GuiDocumentItem(DocumentItem *item, GpxDocumentItem *gpx)
+    : docItem(item), gpxDocItem(gpx)
 {
-    auto itFound = std::find_if(
-                vecGpxEntityOwner.cbegin(),
-                vecGpxEntityOwner.cend(),
-                [=](const Handle_SelectMgr_EntityOwner& owner) {
-        auto brepOwner = Handle_StdSelect_BRepOwner::DownCast(owner);
-        return !brepOwner.IsNull() ? brepOwner->Shape() == face : false;
-    });
-    return itFound != vecGpxEntityOwner.cend() ?
-                *itFound : Handle_SelectMgr_EntityOwner();
 }
 
 } // namespace Mayo
@@ -6,13 +6,16 @@
 
 #pragma once
 
+#include "bnd_utils.h"
+#include "gpx_brep_owner_index.h"
+
 #include <QtCore/QObject>
 #include <AIS_InteractiveContext.hxx>
 #include <Bnd_Box.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
+#include <future>
 #include <vector>
-class TopoDS_Face;
 
 namespace Mayo {
 
@@ -20,15 +23,23 @@ class ApplicationItem;
 class Document;
 class DocumentItem;
 class GpxDocumentItem;
+class ViewRedrawScheduler;
 
 class GuiDocument : public QObject {
     Q_OBJECT
 public:
+    enum class PickGranularity {
+        Face,
+        Edge,
+        Vertex
+    };
+
     GuiDocument(Document* doc);
 
     Document* document() const;
     const Handle_V3d_View& v3dView() const;
     const Handle_AIS_InteractiveContext& aisInteractiveContext() const;
+    ViewRedrawScheduler* redrawScheduler() const;
     GpxDocumentItem* findItemGpx(const DocumentItem* item) const;
 
     const Bnd_Box& gpxBoundingBox() const;
@@ -36,32 +47,69 @@ public:
     void toggleItemSelected(const ApplicationItem& appItem);
     void clearItemSelection();
 
+    // Selection modes of B-Rep items are activated on demand : at first click
+    // in the view, first selection of an item or when pick granularity is
+    // changed. Hovering the view doesn't activate them
+    PickGranularity pickGranularity() const;
+    void setPickGranularity(PickGranularity granularity);
+    void activatePicking();
+
+    // Redraw of the view is deferred to the next frame of redrawScheduler()
     void updateV3dViewer();
 
+    // Level of detail : while the view is rotated or panned, large items are
+    // replaced by decimated proxies built in background. The level is adapted
+    // to hold Options::viewLodFrameTimeTarget(), full detail is restored when
+    // the interaction ends
+    void beginViewInteraction();
+    void endViewInteraction();
+    void addViewInteractionFrame(double frameTime); // Milliseconds
+
 signals:
     void gpxBoundingBoxChanged(const Bnd_Box& bndBox);
+    // Average frame rate achieved by the last view interaction
+    void viewInteractionFpsMeasured(double fps);
 
 private:
     void onItemAdded(DocumentItem* item);
+    void onItemsAdded(const std::vector<DocumentItem*>& items);
     void onItemErased(const DocumentItem* item);
 
-    using ArrayGpxEntityOwner = std::vector<Handle_SelectMgr_EntityOwner>;
     struct GuiDocumentItem {
         GuiDocumentItem() = default;
         GuiDocumentItem(DocumentItem* item, GpxDocumentItem* gpx);
         DocumentItem* docItem;
         GpxDocumentItem* gpxDocItem;
-        ArrayGpxEntityOwner vecGpxEntityOwner;
-        Handle_SelectMgr_EntityOwner findBrepOwner(const TopoDS_Face& face) const;
+        Bnd_Box bndBox;
+        int pickSelectionMode = -1; // Active AIS selection mode, -1 if none
+        std::shared_future<GpxBRepOwnerIndex> futureBRepOwnerIndex; // Face owners
+        // Level of detail proxies, coarsest first. Empty for small items
+        std::shared_future<std::vector<Handle_AIS_InteractiveObject>> futureLodProxies;
     };
     const GuiDocumentItem* findGuiDocumentItem(const DocumentItem* item) const;
+    GuiDocumentItem* findGuiDocumentItem(const DocumentItem* item);
+    void activateItemPicking(GuiDocumentItem* guiItem);
+    void loadBRepOwnerIndex(GuiDocumentItem* guiItem);
+    void updateGpxBoundingBox();
+    void setLodLevel(int level);
 
     Document* m_document = nullptr;
     Handle_V3d_Viewer m_v3dViewer;
     Handle_V3d_View m_v3dView;
     Handle_AIS_InteractiveContext m_aisContext;
+    ViewRedrawScheduler* m_redrawScheduler = nullptr;
     std::vector<GuiDocumentItem> m_vecGuiDocumentItem;
+    BndBoxAggregate m_gpxBndBoxAggregate;
     Bnd_Box m_gpxBoundingBox;
+    PickGranularity m_pickGranularity = PickGranularity::Face;
+    bool m_isPickingActivated = false;
+    bool m_isViewInteracting = false;
+    int m_lodLevel;
+    int m_lodInteractionLevel; // Level to start the next interaction with
+    int m_lodFrameTimeTarget = 0;
+    bool m_isLodFrameSkipped = false;
+    int m_viewInteractionFrameCount = 0;
+    double m_viewInteractionTime = 0.; // Milliseconds
 };
 
 } // namespace Mayo
@@ -0,0 +1,523 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "import_cache.h"
+
+#include "caf_utils.h"
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TDF_LabelSequence.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryFile>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+static const char indexFileName[] = "index.ini";
+static const char entryFileSuffix[] = ".cbf";
+static const char triangulationFileSuffix[] = ".tri";
+static const quint32 triangulationFileMagic = 0x4952544d; // "MTRI"
+static const quint32 triangulationFileVersion = 1;
+static const int pendingLookupCountMax = 64;
+static const char keyEntries[] = "Entries";
+static const char keyStatsLookupCount[] = "Stats/lookupCount";
+static const char keyStatsHitCount[] = "Stats/hitCount";
+static const char keyStatsSavedTime[] = "Stats/savedTime";
+
+static QString indexFilePath(const QString& dirPath)
+{
+    return QDir(dirPath).filePath(indexFileName);
+}
+
+static QString entryFilePath(const QString& dirPath, const QString& key)
+{
+    return QDir(dirPath).filePath(key + entryFileSuffix);
+}
+
+static QString triangulationFilePath(const QString& dirPath, const QString& key)
+{
+    return QDir(dirPath).filePath(key + triangulationFileSuffix);
+}
+
+// Returns the path of a new empty file next to 'filepath', or an empty string
+static QString newTempFilePath(const QString& filepath)
+{
+    QTemporaryFile file(filepath + ".XXXXXX.tmp");
+    file.setAutoRemove(false);
+    return file.open() ? file.fileName() : QString();
+}
+
+// Moves 'tempFilepath' to 'filepath', replacing it. 'tempFilepath' is removed
+// on failure
+static bool renameTempFile(const QString& tempFilepath, const QString& filepath)
+{
+    QFile::remove(filepath);
+    if (QFile::rename(tempFilepath, filepath))
+        return true;
+
+    QFile::remove(tempFilepath);
+    return false;
+}
+
+static QString entryGroup(const QString& key)
+{
+    return QString("%1/%2").arg(keyEntries).arg(key);
+}
+
+static quint64 rotl64(quint64 v, int bits)
+{
+    return (v << bits) | (v >> (64 - bits));
+}
+
+// Non-cryptographic 64bit hash, consumes 8 bytes per step
+static quint64 hashBytes(const uchar* data, qint64 size)
+{
+    const quint64 k1 = 0x9e3779b97f4a7c15ULL;
+    const quint64 k2 = 0xc2b2ae3d27d4eb4fULL;
+    quint64 h = k1 ^ static_cast<quint64>(size);
+    const qint64 wordCount = size / 8;
+    for (qint64 i = 0; i < wordCount; ++i) {
+        quint64 word;
+        std::memcpy(&word, data + 8 * i, 8);
+        h = rotl64(h ^ (word * k2), 31) * k1;
+    }
+
+    if (size % 8 != 0) {
+        quint64 tail = 0;
+        std::memcpy(&tail, data + 8 * wordCount, static_cast<size_t>(size % 8));
+        h = rotl64(h ^ (tail * k2), 31) * k1;
+    }
+
+    // Finalizer of MurmurHash3
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Removes least recently used entries until total size is below 'maxSize'
+static void evictEntries(const QString& dirPath, QSettings* index, qint64 maxSize)
+{
+    using LruEntry = std::tuple<qint64, QString, qint64>; // {lastAccess, key, size}
+    std::vector<LruEntry> vecEntry;
+    qint64 totalSize = 0;
+    index->beginGroup(keyEntries);
+    for (const QString& key : index->childGroups()) {
+        const qint64 size = index->value(key + "/size").toLongLong();
+        const qint64 lastAccess = index->value(key + "/lastAccess").toLongLong();
+        vecEntry.emplace_back(lastAccess, key, size);
+        totalSize += size;
+    }
+
+    index->endGroup();
+    std::sort(vecEntry.begin(), vecEntry.end());
+    for (const LruEntry& entry : vecEntry) {
+        if (totalSize <= maxSize)
+            break;
+        QFile::remove(entryFilePath(dirPath, std::get<1>(entry)));
+        QFile::remove(triangulationFilePath(dirPath, std::get<1>(entry)));
+        index->remove(entryGroup(std::get<1>(entry)));
+        totalSize -= std::get<2>(entry);
+    }
+}
+
+// Faces of the free shapes of 'cafDoc', in traversal order. Faces sharing the
+// same TShape(hence the same triangulation) are listed once
+static std::vector<TopoDS_Face> xdeDocumentFaces(const Handle_TDocStd_Document& cafDoc)
+{
+    TDF_LabelSequence seqFreeShape;
+    XCAFDoc_DocumentTool::ShapeTool(cafDoc->Main())->GetFreeShapes(seqFreeShape);
+    std::vector<TopoDS_Face> vecFace;
+    std::unordered_set<const TopoDS_TShape*> setTShape;
+    for (int i = 1; i <= seqFreeShape.Length(); ++i) {
+        const TopoDS_Shape shape = XCAFDoc_ShapeTool::GetShape(seqFreeShape.Value(i));
+        for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+            const TopoDS_Face& face = TopoDS::Face(expl.Current());
+            if (setTShape.insert(face.TShape().get()).second)
+                vecFace.push_back(face);
+        }
+    }
+    return vecFace;
+}
+
+// Triangulations are written as raw arrays, the file is only read back on
+// the same machine
+static bool writeTriangulations(const QString& filepath, const Handle_TDocStd_Document& cafDoc)
+{
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const std::vector<TopoDS_Face> vecFace = xdeDocumentFaces(cafDoc);
+    QDataStream stream(&file);
+    stream << triangulationFileMagic
+           << triangulationFileVersion
+           << static_cast<quint32>(vecFace.size());
+    for (const TopoDS_Face& face : vecFace) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& mesh = BRep_Tool::Triangulation(face, loc);
+        if (mesh.IsNull()) {
+            stream << quint32(0) << quint32(0);
+            continue;
+        }
+
+        stream << static_cast<quint32>(mesh->NbNodes())
+               << static_cast<quint32>(mesh->NbTriangles())
+               << static_cast<quint8>(mesh->HasUVNodes())
+               << mesh->Deflection();
+        stream.writeRawData(
+                    reinterpret_cast<const char*>(&mesh->Nodes().First()),
+                    mesh->NbNodes() * sizeof(gp_Pnt));
+        if (mesh->HasUVNodes()) {
+            stream.writeRawData(
+                        reinterpret_cast<const char*>(&mesh->UVNodes().First()),
+                        mesh->NbNodes() * sizeof(gp_Pnt2d));
+        }
+
+        stream.writeRawData(
+                    reinterpret_cast<const char*>(&mesh->Triangles().First()),
+                    mesh->NbTriangles() * sizeof(Poly_Triangle));
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+// Restores triangulations written by writeTriangulations(), nothing is done
+// if the file doesn't match the faces of 'cafDoc'
+static bool readTriangulations(const QString& filepath, const Handle_TDocStd_Document& cafDoc)
+{
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const std::vector<TopoDS_Face> vecFace = xdeDocumentFaces(cafDoc);
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 faceCount = 0;
+    stream >> magic >> version >> faceCount;
+    if (magic != triangulationFileMagic
+            || version != triangulationFileVersion
+            || faceCount != vecFace.size())
+    {
+        return false;
+    }
+
+    std::vector<Handle_Poly_Triangulation> vecMesh(vecFace.size());
+    for (Handle_Poly_Triangulation& mesh : vecMesh) {
+        quint32 nodeCount = 0;
+        quint32 triangleCount = 0;
+        stream >> nodeCount >> triangleCount;
+        if (nodeCount == 0 || triangleCount == 0)
+            continue;
+
+        quint8 hasUvNodes = 0;
+        double deflection = 0.;
+        stream >> hasUvNodes >> deflection;
+        const qint64 dataSize =
+                nodeCount * qint64(sizeof(gp_Pnt))
+                + (hasUvNodes ? nodeCount * qint64(sizeof(gp_Pnt2d)) : 0)
+                + triangleCount * qint64(sizeof(Poly_Triangle));
+        if (stream.status() != QDataStream::Ok
+                || dataSize > file.size() - file.pos()
+                || nodeCount > quint32(std::numeric_limits<int>::max())
+                || triangleCount > quint32(std::numeric_limits<int>::max()))
+        {
+            return false;
+        }
+
+        mesh = new Poly_Triangulation(nodeCount, triangleCount, hasUvNodes != 0);
+        mesh->Deflection(deflection);
+        stream.readRawData(
+                    reinterpret_cast<char*>(&mesh->ChangeNodes().ChangeFirst()),
+                    nodeCount * sizeof(gp_Pnt));
+        if (hasUvNodes) {
+            stream.readRawData(
+                        reinterpret_cast<char*>(&mesh->ChangeUVNodes().ChangeFirst()),
+                        nodeCount * sizeof(gp_Pnt2d));
+        }
+
+        stream.readRawData(
+                    reinterpret_cast<char*>(&mesh->ChangeTriangles().ChangeFirst()),
+                    triangleCount * sizeof(Poly_Triangle));
+        // Node indices are checked, the file isn't trusted
+        const Poly_Array1OfTriangle& triangles = mesh->Triangles();
+        for (int i = triangles.Lower(); i <= triangles.Upper(); ++i) {
+            int n1, n2, n3;
+            triangles.Value(i).Get(n1, n2, n3);
+            if (std::min({ n1, n2, n3 }) < 1 || std::max({ n1, n2, n3 }) > int(nodeCount))
+                return false;
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    BRep_Builder builder;
+    for (size_t i = 0; i < vecFace.size(); ++i) {
+        if (!vecMesh.at(i).IsNull())
+            builder.UpdateFace(vecFace.at(i), vecMesh.at(i));
+    }
+
+    return true;
+}
+
+} // namespace Internal
+
+QString ImportCache::Key::toString() const
+{
+    return QString("%1-%2-%3")
+            .arg(this->contentHash, 16, 16, QChar('0'))
+            .arg(this->fileSize)
+            .arg(this->lastModified);
+}
+
+double ImportCache::Statistics::hitRate() const
+{
+    return this->lookupCount > 0 ?
+                this->hitCount / static_cast<double>(this->lookupCount) :
+                0.;
+}
+
+ImportCache* ImportCache::instance()
+{
+    static ImportCache cache;
+    return &cache;
+}
+
+ImportCache::~ImportCache()
+{
+    this->flush();
+}
+
+ImportCache::Key ImportCache::fileKey(const QString& filepath)
+{
+    Key key;
+    QFile file(filepath);
+    if (file.open(QIODevice::ReadOnly)) {
+        const qint64 fileSize = file.size();
+        const uchar* data = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+        if (data != nullptr || fileSize == 0) {
+            key.contentHash = Internal::hashBytes(data, fileSize);
+            key.fileSize = fileSize;
+            key.lastModified =
+                    QFileInfo(filepath).lastModified().toMSecsSinceEpoch();
+        }
+    }
+    return key;
+}
+
+// m_mutex is only locked to access the index and the pending updates, entry
+// files are read and written concurrently. They are written to temporary
+// files then renamed, so readers never see partial entries
+bool ImportCache::find(const QString& dirPath, const Key& key, Entry* entry)
+{
+    const QString keyStr = key.toString();
+    const QString group = Internal::entryGroup(keyStr);
+    qint64 importTime = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+        if (m_pending.dirPath != dirPath) {
+            this->writePendingIndexUpdates();
+            m_pending.dirPath = dirPath;
+        }
+
+        ++m_pending.lookupCount;
+        const QSettings index(Internal::indexFilePath(dirPath), QSettings::IniFormat);
+        if (!index.contains(group + "/size"))
+            return false;
+
+        entry->volume = index.value(group + "/volume").toDouble();
+        entry->area = index.value(group + "/area").toDouble();
+        importTime = index.value(group + "/importTime").toLongLong();
+    }
+
+    QElapsedTimer chrono;
+    chrono.start();
+    const QString filepath = Internal::entryFilePath(dirPath, keyStr);
+    const QString triFilepath = Internal::triangulationFilePath(dirPath, keyStr);
+    const Handle_TDocStd_Document cafDoc =
+            occ::CafUtils::openXdeDocumentBinary(filepath);
+    // Faces are meshed again by the import only if this fails
+    if (!cafDoc.IsNull())
+        Internal::readTriangulations(triFilepath, cafDoc);
+
+    std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+    if (cafDoc.IsNull()) { // Corrupted entry
+        QFile::remove(filepath);
+        QFile::remove(triFilepath);
+        m_pending.mapKeyLastAccess.remove(keyStr);
+        QSettings(Internal::indexFilePath(dirPath), QSettings::IniFormat).remove(group);
+        return false;
+    }
+
+    entry->cafDoc = cafDoc;
+    if (m_pending.dirPath == dirPath) { // Unless flushed for another directory meanwhile
+        ++m_pending.hitCount;
+        m_pending.savedTime += std::max(importTime - chrono.elapsed(), qint64(0));
+        m_pending.mapKeyLastAccess.insert(keyStr, QDateTime::currentMSecsSinceEpoch());
+        if (m_pending.lookupCount >= Internal::pendingLookupCountMax)
+            this->writePendingIndexUpdates();
+    }
+
+    return true;
+}
+
+void ImportCache::insert(
+        const QString& dirPath,
+        qint64 maxSize,
+        const Key& key,
+        const Entry& entry,
+        qint64 importTime)
+{
+    if (!QDir().mkpath(dirPath))
+        return;
+
+    const QString keyStr = key.toString();
+    const QString filepath = Internal::entryFilePath(dirPath, keyStr);
+    const QString tempFilepath = Internal::newTempFilePath(filepath);
+    if (tempFilepath.isEmpty()
+            || !occ::CafUtils::saveXdeDocumentBinary(entry.cafDoc, tempFilepath))
+    {
+        QFile::remove(tempFilepath);
+        return;
+    }
+
+    const QString triFilepath = Internal::triangulationFilePath(dirPath, keyStr);
+    QString triTempFilepath = Internal::newTempFilePath(triFilepath);
+    if (!Internal::writeTriangulations(triTempFilepath, entry.cafDoc)) {
+        QFile::remove(triTempFilepath);
+        triTempFilepath.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+    // Replaces the files of an entry inserted meanwhile by another import of
+    // the same file
+    QFile::remove(triFilepath);
+    if (!Internal::renameTempFile(tempFilepath, filepath)) {
+        QFile::remove(triTempFilepath);
+        return;
+    }
+
+    if (!triTempFilepath.isEmpty())
+        Internal::renameTempFile(triTempFilepath, triFilepath);
+
+    // Eviction relies on up to date access times
+    this->writePendingIndexUpdates();
+    QSettings index(Internal::indexFilePath(dirPath), QSettings::IniFormat);
+    index.beginGroup(Internal::entryGroup(keyStr));
+    index.setValue("size", QFileInfo(filepath).size() + QFileInfo(triFilepath).size());
+    index.setValue("lastAccess", QDateTime::currentMSecsSinceEpoch());
+    index.setValue("volume", entry.volume);
+    index.setValue("area", entry.area);
+    index.setValue("importTime", importTime);
+    index.endGroup();
+    Internal::evictEntries(dirPath, &index, maxSize);
+}
+
+qint64 ImportCache::size(const QString& dirPath) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+    QSettings index(Internal::indexFilePath(dirPath), QSettings::IniFormat);
+    qint64 totalSize = 0;
+    index.beginGroup(Internal::keyEntries);
+    for (const QString& key : index.childGroups())
+        totalSize += index.value(key + "/size").toLongLong();
+    index.endGroup();
+    return totalSize;
+}
+
+void ImportCache::clear(const QString& dirPath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+    if (m_pending.dirPath == dirPath)
+        m_pending = PendingIndexUpdates();
+
+    QSettings index(Internal::indexFilePath(dirPath), QSettings::IniFormat);
+    Internal::evictEntries(dirPath, &index, 0);
+    index.clear();
+}
+
+ImportCache::Statistics ImportCache::statistics(const QString& dirPath) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+    const QSettings index(Internal::indexFilePath(dirPath), QSettings::IniFormat);
+    Statistics stats;
+    stats.lookupCount = index.value(Internal::keyStatsLookupCount, 0).toInt();
+    stats.hitCount = index.value(Internal::keyStatsHitCount, 0).toInt();
+    stats.savedTime = index.value(Internal::keyStatsSavedTime, 0).toLongLong();
+    if (m_pending.dirPath == dirPath) {
+        stats.lookupCount += m_pending.lookupCount;
+        stats.hitCount += m_pending.hitCount;
+        stats.savedTime += m_pending.savedTime;
+    }
+
+    return stats;
+}
+
+void ImportCache::flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex); Q_UNUSED(lock);
+    this->writePendingIndexUpdates();
+}
+
+void ImportCache::writePendingIndexUpdates()
+{
+    if (m_pending.lookupCount == 0 || m_pending.dirPath.isEmpty())
+        return;
+
+    QSettings index(Internal::indexFilePath(m_pending.dirPath), QSettings::IniFormat);
+    for (auto it = m_pending.mapKeyLastAccess.cbegin();
+         it != m_pending.mapKeyLastAccess.cend();
+         ++it)
+    {
+        const QString group = Internal::entryGroup(it.key());
+        if (index.contains(group + "/size")) // Not evicted meanwhile
+            index.setValue(group + "/lastAccess", it.value());
+    }
+
+    index.setValue(
+                Internal::keyStatsLookupCount,
+                index.value(Internal::keyStatsLookupCount, 0).toInt()
+                + m_pending.lookupCount);
+    index.setValue(
+                Internal::keyStatsHitCount,
+                index.value(Internal::keyStatsHitCount, 0).toInt()
+                + m_pending.hitCount);
+    index.setValue(
+                Internal::keyStatsSavedTime,
+                index.value(Internal::keyStatsSavedTime, 0).toLongLong()
+                + m_pending.savedTime);
+    const QString dirPath = m_pending.dirPath;
+    m_pending = PendingIndexUpdates();
+    m_pending.dirPath = dirPath;
+}
+
+} // namespace Mayo
@@ -0,0 +1,94 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <TDocStd_Document.hxx>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <mutex>
+
+namespace Mayo {
+
+//! Persistent cache of imported CAD files
+//!
+//! Translated XDE documents are stored with the BinXCAF format in the
+//! directory 'dirPath'(see Options::importCacheDir()), along with the
+//! properties that are costly to compute and the triangulations of the faces
+//! (BinXCAF doesn't keep them). Entries are keyed by a hash of the file
+//! contents, its size and its modification time. When the total size of the
+//! cache exceeds 'maxSize' the least recently used entries are removed
+//!
+//! Lookups don't write the index file, access times and statistics are kept
+//! in memory and written by batches, see flush()
+//!
+//! Entry files are read and written without locking, so concurrent lookups
+//! and insertions only wait for each other while accessing the index
+//!
+//! ImportCache doesn't read Options itself, as it's used by import tasks
+class ImportCache {
+public:
+    struct Key {
+        quint64 contentHash = 0;
+        qint64 fileSize = -1;
+        qint64 lastModified = 0; // Milliseconds since epoch
+        bool isValid() const { return this->fileSize >= 0; }
+        QString toString() const;
+    };
+
+    struct Entry {
+        Handle_TDocStd_Document cafDoc;
+        double volume = 0.; // mm^3
+        double area = 0.; // mm^2
+    };
+
+    struct Statistics {
+        int lookupCount = 0;
+        int hitCount = 0;
+        qint64 savedTime = 0; // Milliseconds
+        double hitRate() const;
+    };
+
+    static ImportCache* instance();
+
+    static Key fileKey(const QString& filepath);
+
+    bool find(const QString& dirPath, const Key& key, Entry* entry);
+    void insert(
+            const QString& dirPath,
+            qint64 maxSize, // Bytes
+            const Key& key,
+            const Entry& entry,
+            qint64 importTime);
+
+    qint64 size(const QString& dirPath) const;
+    void clear(const QString& dirPath);
+
+    Statistics statistics(const QString& dirPath) const;
+
+    // Writes pending index updates, also done by insert() and at destruction
+    void flush();
+
+private:
+    ImportCache() = default;
+    ~ImportCache();
+
+    struct PendingIndexUpdates {
+        QString dirPath;
+        int lookupCount = 0;
+        int hitCount = 0;
+        qint64 savedTime = 0; // Milliseconds
+        QHash<QString, qint64> mapKeyLastAccess;
+    };
+
+    // Requires lock of m_mutex
+    void writePendingIndexUpdates();
+
+    mutable std::mutex m_mutex;
+    PendingIndexUpdates m_pending;
+};
+
+} // namespace Mayo
@@ -6,6 +6,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
 #include <vector>
 
 namespace Mayo {
@@ -16,6 +20,8 @@ template<typename T> class Tree {
 public:
     Tree();
 
+    // Roots are siblings of each other : nodeSiblingNext() of a root is the
+    // next root(in order of roots()), null for the last one
     TreeNodeId nodeSiblingPrevious(TreeNodeId id) const;
     TreeNodeId nodeSiblingNext(TreeNodeId id) const;
     TreeNodeId nodeChildFirst(TreeNodeId id) const;
@@ -24,9 +30,27 @@ public:
     const T& nodeData(TreeNodeId id) const;
     const std::vector<TreeNodeId>& roots() const;
 
+    // Children of a node can be materialized lazily : the owner appends them
+    // on demand and then flags the node as "fetched"
+    bool isNodeFetched(TreeNodeId id) const;
+    void setNodeFetched(TreeNodeId id);
+
     void clear();
     TreeNodeId appendChild(TreeNodeId parentId, const T& data);
 
+    // Appends in one pass the subtree of 'rootData' under 'parentId', the
+    // children of some data are given by 'fnChildren(data)' as a container of T
+    // Nodes are appended in pre-order, so each subtree is contiguous in memory
+    // and a full traversal scans nodes linearly
+    template<typename FUNC_CHILDREN>
+    TreeNodeId appendSubtree(
+            TreeNodeId parentId, const T& rootData, const FUNC_CHILDREN& fnChildren);
+
+    // Removes node 'id' and all its descendants
+    // Ids of removed nodes are not reused until clear(), accessors then return
+    // null values for them
+    void removeSubtree(TreeNodeId id);
+
 private:
     struct TreeNode {
         TreeNodeId siblingPrevious;
@@ -34,6 +58,8 @@ private:
         TreeNodeId childFirst;
         TreeNodeId childLast;
         TreeNodeId parent;
+        bool isFetched;
+        bool isRemoved;
         T data;
     };
 
@@ -45,12 +71,48 @@ private:
     std::vector<TreeNodeId> m_vecRoot;
 };
 
+// Iterative traversals of the subtree of a node, or of the whole tree if this
+// node is null. They only follow node links, so any depth is supported
+template<typename T> class TreeIteratorPreOrder {
+public:
+    TreeIteratorPreOrder(const Tree<T>* tree, TreeNodeId subtreeRootId = 0);
+    bool atEnd() const;
+    TreeNodeId current() const;
+    void next();
+
+private:
+    const Tree<T>* m_tree;
+    TreeNodeId m_subtreeRootId;
+    TreeNodeId m_current;
+};
+
+template<typename T> class TreeIteratorPostOrder {
+public:
+    TreeIteratorPostOrder(const Tree<T>* tree, TreeNodeId subtreeRootId = 0);
+    bool atEnd() const;
+    TreeNodeId current() const;
+    void next();
+
+private:
+    TreeNodeId deepestFirstChild(TreeNodeId id) const;
+
+    const Tree<T>* m_tree;
+    TreeNodeId m_subtreeRootId;
+    TreeNodeId m_current;
+};
+
 template<typename T, typename FUNC>
 void deepForeachTreeNode(const Tree<T>& tree, const FUNC& func);
 
 template<typename T, typename FUNC>
 void deepForeachTreeNode(TreeNodeId node, const Tree<T>& tree, const FUNC& func);
 
+// Calls 'func(nodeId)' for each node of the subtree of 'node'(the whole tree if
+// null) from several threads, in no particular order
+// 'func' must be safe to be called concurrently
+template<typename T, typename FUNC>
+void parallelForeachTreeNode(TreeNodeId node, const Tree<T>& tree, const FUNC& func);
+
 
 
 // --
@@ -93,6 +155,17 @@ template<typename T> const T& Tree<T>::nodeData(TreeNodeId id) const {
     return node != nullptr ? node->data : nullObject;
 }
 
+template<typename T> bool Tree<T>::isNodeFetched(TreeNodeId id) const {
+    const TreeNode* node = this->ptrNode(id);
+    return node != nullptr ? node->isFetched : false;
+}
+
+template<typename T> void Tree<T>::setNodeFetched(TreeNodeId id) {
+    TreeNode* node = this->ptrNode(id);
+    if (node != nullptr)
+        node->isFetched = true;
+}
+
 template<typename T>
 void Tree<T>::clear()
 {
@@ -108,8 +181,8 @@ TreeNodeId Tree<T>::appendChild(TreeNodeId parentId, const T &data)
     TreeNode* node = &m_vecNode.back();
     node->data = data;
     node->parent = parentId;
-    node->siblingPrevious = this->nodeChildLast(parentId);
     if (parentId != 0) {
+        node->siblingPrevious = this->nodeChildLast(parentId);
         TreeNode* parentNode = this->ptrNode(parentId);
         if (parentNode->childFirst == 0)
             parentNode->childFirst = nodeId;
@@ -118,11 +191,79 @@ TreeNodeId Tree<T>::appendChild(TreeNodeId parentId, const T &data)
         parentNode->childLast = nodeId;
     }
     else {
+        // Roots are linked as siblings, so traversals can go from one to another
+        if (!m_vecRoot.empty()) {
+            node->siblingPrevious = m_vecRoot.back();
+            this->ptrNode(m_vecRoot.back())->siblingNext = nodeId;
+        }
         m_vecRoot.push_back(nodeId);
     }
     return nodeId;
 }
 
+template<typename T>
+template<typename FUNC_CHILDREN>
+TreeNodeId Tree<T>::appendSubtree(
+        TreeNodeId parentId, const T& rootData, const FUNC_CHILDREN& fnChildren)
+{
+    struct PendingNode {
+        TreeNodeId parentId;
+        T data;
+    };
+
+    TreeNodeId rootId = 0;
+    std::vector<PendingNode> vecPending;
+    vecPending.push_back({ parentId, rootData });
+    while (!vecPending.empty()) {
+        const PendingNode pending = std::move(vecPending.back());
+        vecPending.pop_back();
+        const TreeNodeId nodeId = this->appendChild(pending.parentId, pending.data);
+        if (rootId == 0)
+            rootId = nodeId;
+
+        // Pushed in reverse order, so the first child is appended next
+        const auto children = fnChildren(pending.data);
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            vecPending.push_back({ nodeId, *it });
+    }
+
+    return rootId;
+}
+
+template<typename T>
+void Tree<T>::removeSubtree(TreeNodeId id)
+{
+    TreeNode* node = this->ptrNode(id);
+    if (node == nullptr)
+        return;
+
+    if (node->siblingPrevious != 0)
+        this->ptrNode(node->siblingPrevious)->siblingNext = node->siblingNext;
+    if (node->siblingNext != 0)
+        this->ptrNode(node->siblingNext)->siblingPrevious = node->siblingPrevious;
+    if (node->parent != 0) {
+        TreeNode* parentNode = this->ptrNode(node->parent);
+        if (parentNode->childFirst == id)
+            parentNode->childFirst = node->siblingNext;
+        if (parentNode->childLast == id)
+            parentNode->childLast = node->siblingPrevious;
+    }
+    else {
+        m_vecRoot.erase(std::find(m_vecRoot.begin(), m_vecRoot.end(), id));
+    }
+
+    // Traversal of the subtree doesn't use the links of its root to siblings
+    std::vector<TreeNodeId> vecRemovedId;
+    for (TreeIteratorPreOrder<T> it(this, id); !it.atEnd(); it.next())
+        vecRemovedId.push_back(it.current());
+
+    for (TreeNodeId removedId : vecRemovedId) {
+        TreeNode* removedNode = this->ptrNode(removedId);
+        removedNode->data = T(); // Release resources held by data
+        removedNode->isRemoved = true;
+    }
+}
+
 template<typename T>
 const std::vector<TreeNodeId>& Tree<T>::roots() const
 {
@@ -138,32 +279,174 @@ TreeNodeId Tree<T>::lastNodeId() const
 template<typename T>
 typename Tree<T>::TreeNode* Tree<T>::ptrNode(TreeNodeId id)
 {
-    return id != 0 && id <= m_vecNode.size() ? &m_vecNode.at(id - 1) : nullptr;
+    const Tree<T>* constThis = this;
+    return const_cast<TreeNode*>(constThis->ptrNode(id));
 }
 
 template<typename T>
 const typename Tree<T>::TreeNode* Tree<T>::ptrNode(TreeNodeId id) const
 {
-    return id != 0 && id <= m_vecNode.size() ? &m_vecNode.at(id - 1) : nullptr;
+    if (id == 0 || id > m_vecNode.size())
+        return nullptr;
+
+    const TreeNode* node = &m_vecNode[id - 1];
+    return !node->isRemoved ? node : nullptr;
 }
 
-template<typename T, typename FUNC>
-void deepForeachTreeNode(TreeNodeId node, const Tree<T>& tree, const FUNC& func)
+template<typename T>
+TreeIteratorPreOrder<T>::TreeIteratorPreOrder(const Tree<T>* tree, TreeNodeId subtreeRootId)
+    : m_tree(tree),
+      m_subtreeRootId(subtreeRootId),
+      m_current(subtreeRootId)
 {
-    func(node);
-    for (auto it = tree.nodeChildFirst(node);
-         it != 0;
-         it = tree.nodeSiblingNext(it))
+    if (subtreeRootId == 0 && !tree->roots().empty())
+        m_current = tree->roots().front();
+}
+
+template<typename T> bool TreeIteratorPreOrder<T>::atEnd() const {
+    return m_current == 0;
+}
+
+template<typename T> TreeNodeId TreeIteratorPreOrder<T>::current() const {
+    return m_current;
+}
+
+template<typename T>
+void TreeIteratorPreOrder<T>::next()
+{
+    const TreeNodeId childId = m_tree->nodeChildFirst(m_current);
+    if (childId != 0) {
+        m_current = childId;
+        return;
+    }
+
+    // Go up until a node has a next sibling, without leaving the subtree
+    TreeNodeId id = m_current;
+    while (id != 0 && id != m_subtreeRootId) {
+        const TreeNodeId siblingId = m_tree->nodeSiblingNext(id);
+        if (siblingId != 0) {
+            m_current = siblingId;
+            return;
+        }
+
+        id = m_tree->nodeParent(id);
+    }
+
+    m_current = 0;
+}
+
+template<typename T>
+TreeIteratorPostOrder<T>::TreeIteratorPostOrder(const Tree<T>* tree, TreeNodeId subtreeRootId)
+    : m_tree(tree),
+      m_subtreeRootId(subtreeRootId),
+      m_current(subtreeRootId)
+{
+    if (subtreeRootId == 0 && !tree->roots().empty())
+        m_current = tree->roots().front();
+    m_current = this->deepestFirstChild(m_current);
+}
+
+template<typename T> bool TreeIteratorPostOrder<T>::atEnd() const {
+    return m_current == 0;
+}
+
+template<typename T> TreeNodeId TreeIteratorPostOrder<T>::current() const {
+    return m_current;
+}
+
+template<typename T>
+void TreeIteratorPostOrder<T>::next()
+{
+    if (m_current == m_subtreeRootId) {
+        m_current = 0; // Root of the subtree is the last node
+        return;
+    }
+
+    const TreeNodeId siblingId = m_tree->nodeSiblingNext(m_current);
+    if (siblingId != 0)
+        m_current = this->deepestFirstChild(siblingId);
+    else
+        m_current = m_tree->nodeParent(m_current);
+}
+
+template<typename T>
+TreeNodeId TreeIteratorPostOrder<T>::deepestFirstChild(TreeNodeId id) const
+{
+    for (TreeNodeId childId = m_tree->nodeChildFirst(id);
+         childId != 0;
+         childId = m_tree->nodeChildFirst(id))
     {
-        deepForeachTreeNode(it, tree, func);
+        id = childId;
     }
+
+    return id;
+}
+
+template<typename T, typename FUNC>
+void deepForeachTreeNode(TreeNodeId node, const Tree<T>& tree, const FUNC& func)
+{
+    if (node == 0)
+        return;
+
+    for (TreeIteratorPreOrder<T> it(&tree, node); !it.atEnd(); it.next())
+        func(it.current());
 }
 
 template<typename T, typename FUNC>
 void deepForeachTreeNode(const Tree<T>& tree, const FUNC& func)
 {
-    for (TreeNodeId node : tree.roots())
-        deepForeachTreeNode(node, tree, func);
+    for (TreeIteratorPreOrder<T> it(&tree); !it.atEnd(); it.next())
+        func(it.current());
+}
+
+template<typename T, typename FUNC>
+void parallelForeachTreeNode(TreeNodeId node, const Tree<T>& tree, const FUNC& func)
+{
+    const unsigned threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    if (threadCount == 1) {
+        for (TreeIteratorPreOrder<T> it(&tree, node); !it.atEnd(); it.next())
+            func(it.current());
+        return;
+    }
+
+    // Top levels are visited here until there are enough subtrees to balance
+    // the load, these subtrees are then dispatched to the threads
+    std::vector<TreeNodeId> vecSubtreeId;
+    if (node != 0)
+        vecSubtreeId.push_back(node);
+    else
+        vecSubtreeId = tree.roots();
+
+    const size_t minSubtreeCount = 16 * threadCount;
+    while (!vecSubtreeId.empty() && vecSubtreeId.size() < minSubtreeCount) {
+        std::vector<TreeNodeId> vecChildId;
+        for (TreeNodeId id : vecSubtreeId) {
+            func(id);
+            for (TreeNodeId childId = tree.nodeChildFirst(id);
+                 childId != 0;
+                 childId = tree.nodeSiblingNext(childId))
+            {
+                vecChildId.push_back(childId);
+            }
+        }
+
+        vecSubtreeId = std::move(vecChildId);
+    }
+
+    std::atomic<size_t> nextSubtree(0);
+    auto fnVisitSubtrees = [&]{
+        for (size_t i = nextSubtree++; i < vecSubtreeId.size(); i = nextSubtree++) {
+            for (TreeIteratorPreOrder<T> it(&tree, vecSubtreeId[i]); !it.atEnd(); it.next())
+                func(it.current());
+        }
+    };
+    std::vector<std::thread> vecThread;
+    const size_t workerCount = std::min<size_t>(threadCount, vecSubtreeId.size());
+    for (size_t i = 1; i < workerCount; ++i)
+        vecThread.emplace_back(fnVisitSubtrees);
+    fnVisitSubtrees();
+    for (std::thread& thread : vecThread)
+        thread.join();
 }
 
 } // namespace Mayo
@@ -5,6 +5,7 @@
 ****************************************************************************/
 
 #include "mainwindow.h"
+#include "trace.h"
 #include <QtWidgets/QApplication>
 
 int main(int argc, char *argv[])
@@ -19,5 +20,14 @@ int main(int argc, char *argv[])
     Mayo::MainWindow mainWindow;
     mainWindow.show();
 
-    return app.exec();
+    const int exitCode = app.exec();
+#ifdef HAVE_MAYO_TRACE
+    // Trace of the whole session, file path can be set with MAYO_TRACE_FILE
+    const QString traceFilePath =
+            qEnvironmentVariableIsSet("MAYO_TRACE_FILE") ?
+                QString::fromLocal8Bit(qgetenv("MAYO_TRACE_FILE")) :
+                QStringLiteral("mayo_trace.json");
+    Mayo::Trace::writeChromeJson(traceFilePath);
+#endif
+    return exitCode;
 }
@@ -34,7 +34,7 @@
 #include "fougtools/qttools/gui/item_view_buttons.h"
 #include "fougtools/qttools/gui/qwidget_utils.h"
 #include "fougtools/qttools/task/manager.h"
-#include "fougtools/qttools/task/runner_stdasync.h"
+#include "fougtools/qttools/task/runner_work_stealing_pool.h"
 
 #include <QtCore/QMimeData>
 #include <QtCore/QTime>
@@ -139,7 +139,9 @@ struct OpenFileNames {
     }
 };
 
-static gp_Pnt pointUnderMouse(const GuiDocument* guiDoc, const QPoint& pos)
+// Only detects items whose picking was activated, otherwise the point is
+// projected on the view plane
+static gp_Pnt pointUnderMouse(GuiDocument* guiDoc, const QPoint& pos)
 {
     const Handle_AIS_InteractiveContext& ctx = guiDoc->aisInteractiveContext();
     ctx->MoveTo(pos.x(), pos.y(), guiDoc->v3dView(), true);
@@ -148,6 +150,29 @@ static gp_Pnt pointUnderMouse(const GuiDocument* guiDoc, const QPoint& pos)
     return GpxUtils::V3dView_to3dPosition(guiDoc->v3dView(), pos.x(), pos.y());
 }
 
+// Rough estimate of the peak memory needed to import a file, OCCT data models
+// are several times bigger than the source file
+static std::size_t importMemoryCost(
+        Application::PartFormat format, const QString& filepath)
+{
+    const auto fileSize = static_cast<std::size_t>(QFileInfo(filepath).size());
+    switch (format) {
+    case Application::PartFormat::Iges:
+    case Application::PartFormat::Step: return 10 * fileSize;
+    case Application::PartFormat::OccBrep: return 4 * fileSize;
+    case Application::PartFormat::Stl: return 2 * fileSize;
+    case Application::PartFormat::Unknown: break;
+    }
+    return fileSize;
+}
+
+static qttask::WorkStealingPool::Priority importPriority(int fileCount)
+{
+    return fileCount > 1 ?
+                qttask::WorkStealingPool::Priority::Batch :
+                qttask::WorkStealingPool::Priority::Interactive;
+}
+
 static void msgBoxErrorFileFormat(QWidget* parent, const QString& filepath)
 {
     qtgui::QWidgetUtils::asyncMsgBoxCritical(
@@ -398,8 +423,13 @@ void MainWindow::importInCurrentDoc()
             for (const QString& filepath : resFileNames.listFilepath) {
                 const Application::PartFormat fileFormat =
                         hasUserFormat ? userFormat : Application::findPartFormat(filepath);
-                if (fileFormat != Application::PartFormat::Unknown)
-                    this->runImportTask(doc, fileFormat, filepath);
+                if (fileFormat != Application::PartFormat::Unknown) {
+                    this->runImportTask(
+                                doc,
+                                fileFormat,
+                                filepath,
+                                Internal::importPriority(resFileNames.listFilepath.size()));
+                }
                 else
                     Internal::msgBoxErrorFileFormat(this, filepath);
             }
@@ -408,15 +438,21 @@ void MainWindow::importInCurrentDoc()
 }
 
 void MainWindow::runImportTask(
-        Document* doc, Application::PartFormat format, const QString& filepath)
+        Document* doc,
+        Application::PartFormat format,
+        const QString& filepath,
+        qttask::WorkStealingPool::Priority priority)
 {
-    auto task = qttask::Manager::globalInstance()->newTask<qttask::StdAsync>();
+    const Application::ImportOptions opts = Application::importOptionsFromSettings();
+    auto task =
+            qttask::Manager::globalInstance()->newTask<qttask::WorkStealingPool>(
+                priority, Internal::importMemoryCost(format, filepath));
     task->run([=]{
         QTime chrono;
         chrono.start();
         const Application::IoResult result =
                 Application::instance()->importInDocument(
-                    doc, format, filepath, &task->progress());
+                    doc, format, filepath, opts, &task->progress());
         QString msg;
         if (result.ok) {
             msg = tr("Import time '%1': %2ms")
@@ -436,7 +472,9 @@ void MainWindow::runExportTask(
         const Application::ExportOptions& opts,
         const QString& filepath)
 {
-    auto task = qttask::Manager::globalInstance()->newTask<qttask::StdAsync>();
+    auto task =
+            qttask::Manager::globalInstance()->newTask<qttask::WorkStealingPool>(
+                qttask::WorkStealingPool::Priority::Interactive);
     task->run([=]{
         QTime chrono;
         chrono.start();
@@ -633,6 +671,9 @@ void MainWindow::onGuiDocumentAdded(GuiDocument* guiDoc)
             m_ui->label_ValuePosZ->setText(QString::number(pos3d.Z(), 'f', 3));
         }
     });
+    QObject::connect(
+                ctrl, &BaseV3dViewController::mouseClicked,
+                guiDoc, &GuiDocument::activatePicking);
     m_ui->stack_GuiDocuments->addWidget(widget);
     this->updateControlsActivation();
     this->setCurrentDocumentIndex(Application::instance()->documentCount() - 1);
@@ -759,7 +800,11 @@ void MainWindow::openDocumentsFromList(const QStringList& listFilePath)
                 Document* doc = app->createDocument(loc.fileName());
                 doc->setFilePath(QDir::toNativeSeparators(locAbsoluteFilePath));
                 app->addDocument(doc);
-                this->runImportTask(doc, fileFormat, locAbsoluteFilePath);
+                this->runImportTask(
+                            doc,
+                            fileFormat,
+                            locAbsoluteFilePath,
+                            Internal::importPriority(listFilePath.size()));
             }
             else {
                 Internal::msgBoxErrorFileFormat(this, locAbsoluteFilePath);
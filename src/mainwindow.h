@@ -9,6 +9,7 @@
 #include "application.h"
 #include "application_item.h"
 #include "application_item_selection_model.h"
+#include "fougtools/qttools/task/work_stealing_pool.h"
 #include <QtWidgets/QMainWindow>
 class QFileInfo;
 
@@ -63,7 +64,8 @@ private:
     void runImportTask(
             Document* doc,
             Application::PartFormat format,
-            const QString& filepath);
+            const QString& filepath,
+            qttask::WorkStealingPool::Priority priority);
     void runExportTask(
             const std::vector<DocumentItem*>& docItems,
             Application::PartFormat format,
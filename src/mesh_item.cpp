@@ -7,6 +7,7 @@
 #include "mesh_item.h"
 
 #include <QtCore/QCoreApplication>
+#include <cmath>
 
 namespace Mayo {
 
@@ -14,10 +15,19 @@ MeshItem::MeshItem()
     : propertyNodeCount(
           this, QCoreApplication::translate("Mayo::MeshItem", "Node count")),
       propertyTriangleCount(
-          this, QCoreApplication::translate("Mayo::MeshItem", "Triangle count"))
+          this, QCoreApplication::translate("Mayo::MeshItem", "Triangle count")),
+      propertyCentroid(
+          this, QCoreApplication::translate("Mayo::MeshItem", "Centroid")),
+      propertyBoundingBoxMin(
+          this, QCoreApplication::translate("Mayo::MeshItem", "Bounding box min")),
+      propertyBoundingBoxMax(
+          this, QCoreApplication::translate("Mayo::MeshItem", "Bounding box max"))
 {
     this->propertyNodeCount.setUserReadOnly(true);
     this->propertyTriangleCount.setUserReadOnly(true);
+    this->propertyCentroid.setUserReadOnly(true);
+    this->propertyBoundingBoxMin.setUserReadOnly(true);
+    this->propertyBoundingBoxMax.setUserReadOnly(true);
 }
 
 const Handle_Poly_Triangulation& MeshItem::triangulation() const
@@ -30,6 +40,24 @@ void MeshItem::setTriangulation(const Handle_Poly_Triangulation& mesh)
     m_triangulation = mesh;
 }
 
+const occ::MeshUtils::MassProperties& MeshItem::massProperties() const
+{
+    return m_massProps;
+}
+
+void MeshItem::setMassProperties(const occ::MeshUtils::MassProperties& props)
+{
+    m_massProps = props;
+    this->propertyVolume.setQuantity(
+                std::abs(props.volume) * Quantity_CubicMillimeter);
+    this->propertyArea.setQuantity(props.area * Quantity_SquaredMillimeter);
+    this->propertyCentroid.setValue(props.centroid);
+    if (!props.boundingBox.IsVoid()) {
+        this->propertyBoundingBoxMin.setValue(props.boundingBox.CornerMin());
+        this->propertyBoundingBoxMax.setValue(props.boundingBox.CornerMax());
+    }
+}
+
 bool MeshItem::isNull() const
 {
     return m_triangulation.IsNull();
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "document_item.h"
+#include "mesh_utils.h"
 #include <Poly_Triangulation.hxx>
 
 namespace Mayo {
@@ -18,6 +19,9 @@ public:
     const Handle_Poly_Triangulation& triangulation() const;
     void setTriangulation(const Handle_Poly_Triangulation& mesh);
 
+    const occ::MeshUtils::MassProperties& massProperties() const;
+    void setMassProperties(const occ::MeshUtils::MassProperties& props);
+
     bool isNull() const override;
 
     static const char TypeName[];
@@ -25,9 +29,13 @@ public:
 
     PropertyInt propertyNodeCount; // Read-only
     PropertyInt propertyTriangleCount; // Read-only
+    PropertyOccPnt propertyCentroid; // Read-only
+    PropertyOccPnt propertyBoundingBoxMin; // Read-only
+    PropertyOccPnt propertyBoundingBoxMax; // Read-only
 
 private:
     Handle_Poly_Triangulation m_triangulation;
+    occ::MeshUtils::MassProperties m_massProps;
 };
 
 } // namespace Mayo
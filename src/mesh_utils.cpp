@@ -5,10 +5,131 @@
 ****************************************************************************/
 
 #include "mesh_utils.h"
+
+#include <OSD_Parallel.hxx>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 namespace occ {
 
+namespace Internal {
+
+// Integrals accumulated over the tetrahedra formed by the triangles and a
+// reference point
+struct MassIntegrals {
+    double area = 0.;
+    double volume = 0.;
+    double moment[3] = {}; // Integrals of x, y, z
+    double product[6] = {}; // Integrals of xx, yy, zz, xy, xz, yz
+
+    void add(const MassIntegrals& other) {
+        this->area += other.area;
+        this->volume += other.volume;
+        for (int i = 0; i < 3; ++i)
+            this->moment[i] += other.moment[i];
+        for (int i = 0; i < 6; ++i)
+            this->product[i] += other.product[i];
+    }
+};
+
+struct NodeBounds {
+    double min[3] = {
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::max() };
+    double max[3] = {
+        std::numeric_limits<double>::lowest(),
+        std::numeric_limits<double>::lowest(),
+        std::numeric_limits<double>::lowest() };
+
+    void add(const NodeBounds& other) {
+        for (int i = 0; i < 3; ++i) {
+            this->min[i] = std::min(this->min[i], other.min[i]);
+            this->max[i] = std::max(this->max[i], other.max[i]);
+        }
+    }
+};
+
+// Kernel over triangles [first, last), 'coords' is a strided view of the
+// nodes(3 doubles per node, relative to the reference point)
+static MassIntegrals integrateTriangles(
+        const double* coords,
+        const Poly_Triangle* triangles,
+        int first,
+        int last)
+{
+    double area = 0., volume = 0.;
+    double mx = 0., my = 0., mz = 0.;
+    double pxx = 0., pyy = 0., pzz = 0., pxy = 0., pxz = 0., pyz = 0.;
+    for (int i = first; i < last; ++i) {
+        int n1, n2, n3;
+        triangles[i].Get(n1, n2, n3);
+        const double* a = coords + 3 * (n1 - 1);
+        const double* b = coords + 3 * (n2 - 1);
+        const double* c = coords + 3 * (n3 - 1);
+        // Area
+        const double abx = b[0] - a[0], aby = b[1] - a[1], abz = b[2] - a[2];
+        const double acx = c[0] - a[0], acy = c[1] - a[1], acz = c[2] - a[2];
+        const double nx = aby * acz - abz * acy;
+        const double ny = abz * acx - abx * acz;
+        const double nz = abx * acy - aby * acx;
+        area += std::sqrt(nx * nx + ny * ny + nz * nz);
+        // Signed volume of tetrahedron(reference, a, b, c)
+        const double vol6 =
+                a[0] * (b[1] * c[2] - b[2] * c[1])
+                - a[1] * (b[0] * c[2] - b[2] * c[0])
+                + a[2] * (b[0] * c[1] - b[1] * c[0]);
+        volume += vol6;
+        // First moments : vol * (a + b + c) / 4
+        const double sx = a[0] + b[0] + c[0];
+        const double sy = a[1] + b[1] + c[1];
+        const double sz = a[2] + b[2] + c[2];
+        mx += vol6 * sx;
+        my += vol6 * sy;
+        mz += vol6 * sz;
+        // Second moments : vol/20 * (sum(p.p^T) + s.s^T)
+        pxx += vol6 * (a[0] * a[0] + b[0] * b[0] + c[0] * c[0] + sx * sx);
+        pyy += vol6 * (a[1] * a[1] + b[1] * b[1] + c[1] * c[1] + sy * sy);
+        pzz += vol6 * (a[2] * a[2] + b[2] * b[2] + c[2] * c[2] + sz * sz);
+        pxy += vol6 * (a[0] * a[1] + b[0] * b[1] + c[0] * c[1] + sx * sy);
+        pxz += vol6 * (a[0] * a[2] + b[0] * b[2] + c[0] * c[2] + sx * sz);
+        pyz += vol6 * (a[1] * a[2] + b[1] * b[2] + c[1] * c[2] + sy * sz);
+    }
+
+    MassIntegrals result;
+    result.area = area / 2.;
+    result.volume = volume / 6.;
+    result.moment[0] = mx / 24.;
+    result.moment[1] = my / 24.;
+    result.moment[2] = mz / 24.;
+    const double prodScale = 1. / 120.;
+    result.product[0] = pxx * prodScale;
+    result.product[1] = pyy * prodScale;
+    result.product[2] = pzz * prodScale;
+    result.product[3] = pxy * prodScale;
+    result.product[4] = pxz * prodScale;
+    result.product[5] = pyz * prodScale;
+    return result;
+}
+
+static NodeBounds boundNodes(const double* coords, int first, int last)
+{
+    NodeBounds bounds;
+    for (int i = first; i < last; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            bounds.min[j] = std::min(bounds.min[j], coords[3 * i + j]);
+            bounds.max[j] = std::max(bounds.max[j], coords[3 * i + j]);
+        }
+    }
+    return bounds;
+}
+
+} // namespace Internal
+
 double MeshUtils::triangleSignedVolume(
         const gp_XYZ &p1, const gp_XYZ &p2, const gp_XYZ &p3)
 {
@@ -36,8 +157,7 @@ double MeshUtils::triangulationVolume(
     double volume = 0;
     const TColgp_Array1OfPnt& vecNode = triangulation->Nodes();
     const Poly_Array1OfTriangle& vecTriangle = triangulation->Triangles();
-    // TODO Parallelize computation
-    for (int i = 1; i < vecTriangle.Size(); ++i) {
+    for (int i = vecTriangle.Lower(); i <= vecTriangle.Upper(); ++i) {
         const Poly_Triangle& tri = vecTriangle.Value(i);
         int v1, v2, v3;
         tri.Get(v1, v2, v3);
@@ -55,8 +175,7 @@ double MeshUtils::triangulationArea(
     double area = 0;
     const TColgp_Array1OfPnt& vecNode = triangulation->Nodes();
     const Poly_Array1OfTriangle& vecTriangle = triangulation->Triangles();
-    // TODO Parallelize computation
-    for (int i = 1; i < vecTriangle.Size(); ++i) {
+    for (int i = vecTriangle.Lower(); i <= vecTriangle.Upper(); ++i) {
         const Poly_Triangle& tri = vecTriangle.Value(i);
         int v1, v2, v3;
         tri.Get(v1, v2, v3);
@@ -68,4 +187,177 @@ double MeshUtils::triangulationArea(
     return area;
 }
 
+MeshUtils::MassProperties MeshUtils::triangulationMassProperties(
+        const Handle_Poly_Triangulation& triangulation)
+{
+    MassProperties props;
+    if (triangulation.IsNull() || triangulation->NbNodes() == 0)
+        return props;
+
+    // Nodes are made relative to the first one, this limits cancellation
+    // errors for meshes far from origin
+    const TColgp_Array1OfPnt& vecNode = triangulation->Nodes();
+    const Poly_Array1OfTriangle& vecTriangle = triangulation->Triangles();
+    const int nodeCount = vecNode.Size();
+    const int triangleCount = vecTriangle.Size();
+    const gp_XYZ ref = vecNode.First().XYZ();
+    std::vector<double> vecCoord(3 * size_t(nodeCount));
+    const int chunkSize = 1 << 14;
+    const int nodeChunkCount = (nodeCount + chunkSize - 1) / chunkSize;
+    std::vector<Internal::NodeBounds> vecChunkBounds(nodeChunkCount);
+    OSD_Parallel::For(0, nodeChunkCount, [&](int chunk) {
+        const int first = chunk * chunkSize;
+        const int last = std::min(first + chunkSize, nodeCount);
+        for (int i = first; i < last; ++i) {
+            const gp_XYZ& pnt = vecNode.Value(vecNode.Lower() + i).XYZ();
+            vecCoord[3 * i] = pnt.X() - ref.X();
+            vecCoord[3 * i + 1] = pnt.Y() - ref.Y();
+            vecCoord[3 * i + 2] = pnt.Z() - ref.Z();
+        }
+        vecChunkBounds.at(chunk) = Internal::boundNodes(vecCoord.data(), first, last);
+    });
+
+    const Poly_Triangle* triangles = triangleCount > 0 ? &vecTriangle.First() : nullptr;
+    const int triChunkCount = (triangleCount + chunkSize - 1) / chunkSize;
+    std::vector<Internal::MassIntegrals> vecChunkIntegrals(triChunkCount);
+    OSD_Parallel::For(0, triChunkCount, [&](int chunk) {
+        const int first = chunk * chunkSize;
+        const int last = std::min(first + chunkSize, triangleCount);
+        vecChunkIntegrals.at(chunk) =
+                Internal::integrateTriangles(vecCoord.data(), triangles, first, last);
+    });
+
+    // Reduce in chunk order, so the result doesn't depend on scheduling
+    Internal::NodeBounds bounds;
+    for (const Internal::NodeBounds& chunkBounds : vecChunkBounds)
+        bounds.add(chunkBounds);
+    Internal::MassIntegrals sum;
+    for (const Internal::MassIntegrals& chunkIntegrals : vecChunkIntegrals)
+        sum.add(chunkIntegrals);
+
+    props.area = sum.area;
+    props.volume = sum.volume;
+    props.boundingBox.Update(
+                bounds.min[0] + ref.X(), bounds.min[1] + ref.Y(), bounds.min[2] + ref.Z(),
+                bounds.max[0] + ref.X(), bounds.max[1] + ref.Y(), bounds.max[2] + ref.Z());
+    if (std::abs(sum.volume) <= std::numeric_limits<double>::min())
+        return props;
+
+    // Centroid relative to reference point
+    const double cx = sum.moment[0] / sum.volume;
+    const double cy = sum.moment[1] / sum.volume;
+    const double cz = sum.moment[2] / sum.volume;
+    props.centroid.SetCoord(cx + ref.X(), cy + ref.Y(), cz + ref.Z());
+    // Second moments at centroid, then inertia tensor
+    // Integrals are all negated for inward oriented triangles, unlike inertia
+    const double sign = sum.volume < 0 ? -1. : 1.;
+    const double sxx = sign * (sum.product[0] - sum.volume * cx * cx);
+    const double syy = sign * (sum.product[1] - sum.volume * cy * cy);
+    const double szz = sign * (sum.product[2] - sum.volume * cz * cz);
+    const double sxy = sign * (sum.product[3] - sum.volume * cx * cy);
+    const double sxz = sign * (sum.product[4] - sum.volume * cx * cz);
+    const double syz = sign * (sum.product[5] - sum.volume * cy * cz);
+    props.inertia.SetRows(
+                gp_XYZ(syy + szz, -sxy, -sxz),
+                gp_XYZ(-sxy, sxx + szz, -syz),
+                gp_XYZ(-sxz, -syz, sxx + syy));
+    return props;
+}
+
+Handle_Poly_Triangulation MeshUtils::simplifiedTriangulation(
+        const Handle_Poly_Triangulation& triangulation, double ratio)
+{
+    if (triangulation.IsNull() || triangulation->NbTriangles() == 0)
+        return Handle_Poly_Triangulation();
+
+    const TColgp_Array1OfPnt& vecNode = triangulation->Nodes();
+    const Poly_Array1OfTriangle& vecTriangle = triangulation->Triangles();
+    const int nodeCount = vecNode.Size();
+    gp_XYZ pntMin = vecNode.First().XYZ();
+    gp_XYZ pntMax = pntMin;
+    for (int i = vecNode.Lower(); i <= vecNode.Upper(); ++i) {
+        const gp_XYZ& pnt = vecNode.Value(i).XYZ();
+        pntMin.SetCoord(
+                    std::min(pntMin.X(), pnt.X()),
+                    std::min(pntMin.Y(), pnt.Y()),
+                    std::min(pntMin.Z(), pnt.Z()));
+        pntMax.SetCoord(
+                    std::max(pntMax.X(), pnt.X()),
+                    std::max(pntMax.Y(), pnt.Y()),
+                    std::max(pntMax.Z(), pnt.Z()));
+    }
+
+    // Triangle count of a surface grows as the square of the grid resolution,
+    // a closed surface crossing N^3 cells gives roughly 8*N^2 triangles
+    const double targetTriangleCount =
+            std::max(ratio * triangulation->NbTriangles(), 1.);
+    const int cellCountMax = (1 << 21) - 1; // Cell index coded on 21 bits
+    const int cellCount =
+            std::min(std::max(static_cast<int>(std::sqrt(targetTriangleCount / 8.)), 2),
+                     cellCountMax);
+    const gp_XYZ extent = pntMax - pntMin;
+    const double maxExtent = std::max(std::max(extent.X(), extent.Y()), extent.Z());
+    if (maxExtent <= 0.)
+        return Handle_Poly_Triangulation();
+
+    const double cellSize = maxExtent / cellCount;
+    auto fnCellIndex = [=](double coord, double coordMin) {
+        return std::min(static_cast<uint64_t>((coord - coordMin) / cellSize),
+                        static_cast<uint64_t>(cellCountMax));
+    };
+
+    // Map nodes to clusters, a cluster is located at the mean of its nodes
+    std::unordered_map<uint64_t, int> mapCellCluster;
+    std::vector<gp_XYZ> vecClusterSum;
+    std::vector<int> vecClusterNodeCount;
+    std::vector<int> vecNodeCluster(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        const gp_XYZ& pnt = vecNode.Value(vecNode.Lower() + i).XYZ();
+        const uint64_t cellKey =
+                fnCellIndex(pnt.X(), pntMin.X())
+                | (fnCellIndex(pnt.Y(), pntMin.Y()) << 21)
+                | (fnCellIndex(pnt.Z(), pntMin.Z()) << 42);
+        const auto itCluster = mapCellCluster.emplace(
+                    cellKey, static_cast<int>(vecClusterSum.size())).first;
+        const int cluster = itCluster->second;
+        if (cluster == static_cast<int>(vecClusterSum.size())) {
+            vecClusterSum.push_back(gp_XYZ());
+            vecClusterNodeCount.push_back(0);
+        }
+
+        vecClusterSum[cluster] += pnt;
+        ++vecClusterNodeCount[cluster];
+        vecNodeCluster[i] = cluster;
+    }
+
+    std::vector<Poly_Triangle> vecClusterTriangle;
+    for (int i = vecTriangle.Lower(); i <= vecTriangle.Upper(); ++i) {
+        int n1, n2, n3;
+        vecTriangle.Value(i).Get(n1, n2, n3);
+        const int c1 = vecNodeCluster[n1 - vecNode.Lower()];
+        const int c2 = vecNodeCluster[n2 - vecNode.Lower()];
+        const int c3 = vecNodeCluster[n3 - vecNode.Lower()];
+        if (c1 != c2 && c1 != c3 && c2 != c3)
+            vecClusterTriangle.emplace_back(c1 + 1, c2 + 1, c3 + 1);
+    }
+
+    if (vecClusterTriangle.empty())
+        return Handle_Poly_Triangulation();
+
+    const int clusterCount = static_cast<int>(vecClusterSum.size());
+    Handle_Poly_Triangulation mesh =
+            new Poly_Triangulation(
+                clusterCount,
+                static_cast<int>(vecClusterTriangle.size()),
+                Standard_False);
+    for (int i = 0; i < clusterCount; ++i) {
+        const gp_XYZ pnt = vecClusterSum[i] / vecClusterNodeCount[i];
+        mesh->ChangeNodes().SetValue(i + 1, gp_Pnt(pnt));
+    }
+
+    for (size_t i = 0; i < vecClusterTriangle.size(); ++i)
+        mesh->ChangeTriangles().SetValue(static_cast<int>(i + 1), vecClusterTriangle[i]);
+    return mesh;
+}
+
 } // namespace occ
@@ -6,12 +6,24 @@
 
 #pragma once
 
+#include <Bnd_Box.hxx>
+#include <gp_Mat.hxx>
+#include <gp_Pnt.hxx>
 #include <Poly_Triangulation.hxx>
 class gp_XYZ;
 
 namespace occ {
 
 struct MeshUtils {
+    //! Properties of the volume enclosed by a triangulation, with unit density
+    struct MassProperties {
+        double area = 0.;
+        double volume = 0.; // Signed, negative if triangles are oriented inward
+        gp_Pnt centroid;
+        gp_Mat inertia; // Tensor at centroid, in global axes
+        Bnd_Box boundingBox;
+    };
+
     static double triangleSignedVolume(
             const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3);
     static double triangleArea(
@@ -19,6 +31,17 @@ struct MeshUtils {
 
     static double triangulationVolume(const Handle_Poly_Triangulation& triangulation);
     static double triangulationArea(const Handle_Poly_Triangulation& triangulation);
+
+    //! Computes all mass properties in a single pass over the triangles,
+    //! split across all the available cores
+    static MassProperties triangulationMassProperties(
+            const Handle_Poly_Triangulation& triangulation);
+
+    //! Returns a coarser copy of a triangulation, with approximately
+    //! 'ratio' times its count of triangles. Nodes are clustered in the cells
+    //! of a uniform grid and degenerate triangles are dropped
+    static Handle_Poly_Triangulation simplifiedTriangulation(
+            const Handle_Poly_Triangulation& triangulation, double ratio);
 };
 
 } // namespace occ
@@ -6,15 +6,28 @@
 
 #include "options.h"
 
+#include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
+
 namespace Mayo {
 
 static const char keyStlIoLibrary[] = "Core/stlIoLibrary";
+static const char keyStlWeldTolerance[] = "Core/stlWeldTolerance";
+static const char keyConcurrentImportOn[] = "Core/concurrentImportOn";
+static const char keyImportCacheOn[] = "Core/importCacheOn";
+static const char keyImportCacheDir[] = "Core/importCacheDir";
+static const char keyImportCacheMaxSize[] = "Core/importCacheMaxSize";
+static const char keyImportMeshingDeflection[] = "Core/importMeshingDeflection";
+static const char keyImportPartSharingOn[] = "Core/importPartSharingOn";
 static const char keyBrepShapeDefaultColor[] = "BRepShapeGpx/defaultColor";
 static const char keyBrepShapeDefaultMaterial[] = "BRepShapeGpx/defaultMaterial";
+static const char keyBrepShapeInstancedDisplayOn[] = "BRepShapeGpx/instancedDisplayOn";
+static const char keyMeshPresentation[] = "MeshGpx/presentation";
 static const char keyMeshDefaultColor[] = "MeshGpx/defaultColor";
 static const char keyMeshDefaultMaterial[] = "MeshGpx/defaultMaterial";
 static const char keyMeshDefaultShowEdges[] = "MeshGpx/defaultShowEdges";
 static const char keyMeshDefaultShowNodes[] = "MeshGpx/defaultShowNodes";
+static const char keyViewLodFrameTimeTarget[] = "View/lodFrameTimeTarget";
 static const char keyClipPlaneCappingOn[] = "ClipPlane/CappingOn";
 static const char keyClipPlaneCappingHatch[] = "ClipPlane/CappingHatch";
 static const char keyUnitSystemSchema[] = "UnitSystem/Schema";
@@ -31,11 +44,16 @@ Options::StlIoLibrary Options::stlIoLibrary() const
 {
 #ifdef HAVE_GMIO
     static const int defaultVal = static_cast<int>(StlIoLibrary::Gmio);
-    const int stlIoLib = m_settings.value(keyStlIoLibrary, defaultVal).toInt();
-    return static_cast<StlIoLibrary>(stlIoLib);
 #else
-    return StlIoLibrary::OpenCascade;
+    static const int defaultVal = static_cast<int>(StlIoLibrary::OpenCascade);
+#endif
+    const int stlIoLib = m_settings.value(keyStlIoLibrary, defaultVal).toInt();
+    const auto lib = static_cast<StlIoLibrary>(stlIoLib);
+#ifndef HAVE_GMIO
+    if (lib == StlIoLibrary::Gmio)
+        return StlIoLibrary::OpenCascade;
 #endif
+    return lib;
 }
 
 void Options::setStlIoLibrary(Options::StlIoLibrary lib)
@@ -43,6 +61,80 @@ void Options::setStlIoLibrary(Options::StlIoLibrary lib)
     m_settings.setValue(keyStlIoLibrary, static_cast<int>(lib));
 }
 
+double Options::stlWeldTolerance() const
+{
+    return m_settings.value(keyStlWeldTolerance, 0.).toDouble();
+}
+
+void Options::setStlWeldTolerance(double tol)
+{
+    m_settings.setValue(keyStlWeldTolerance, tol);
+}
+
+bool Options::isConcurrentImportOn() const
+{
+    return m_settings.value(keyConcurrentImportOn, true).toBool();
+}
+
+void Options::setConcurrentImport(bool on)
+{
+    m_settings.setValue(keyConcurrentImportOn, on);
+}
+
+bool Options::isImportCacheOn() const
+{
+    return m_settings.value(keyImportCacheOn, true).toBool();
+}
+
+void Options::setImportCache(bool on)
+{
+    m_settings.setValue(keyImportCacheOn, on);
+}
+
+QString Options::importCacheDir() const
+{
+    static const QString defaultDir =
+            QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+            .filePath("import");
+    return m_settings.value(keyImportCacheDir, defaultDir).toString();
+}
+
+void Options::setImportCacheDir(const QString& dirPath)
+{
+    m_settings.setValue(keyImportCacheDir, dirPath);
+}
+
+int Options::importCacheMaxSize() const
+{
+    return m_settings.value(keyImportCacheMaxSize, 2048).toInt();
+}
+
+void Options::setImportCacheMaxSize(int sizeMB)
+{
+    m_settings.setValue(keyImportCacheMaxSize, sizeMB);
+}
+
+double Options::importMeshingDeflection() const
+{
+    // Same as default deviation coefficient of Prs3d_Drawer
+    return m_settings.value(keyImportMeshingDeflection, 0.001).toDouble();
+}
+
+void Options::setImportMeshingDeflection(double coeff)
+{
+    m_settings.setValue(keyImportMeshingDeflection, coeff);
+}
+
+bool Options::isImportPartSharingOn() const
+{
+    return m_settings.value(keyImportPartSharingOn, false).toBool();
+}
+
+void Options::setImportPartSharing(bool on)
+{
+    m_settings.setValue(keyImportPartSharingOn, on);
+}
+
 QColor Options::brepShapeDefaultColor() const
 {
     static const QColor defaultColor(Qt::gray);
@@ -68,6 +160,28 @@ void Options::setBrepShapeDefaultMaterial(Graphic3d_NameOfMaterial material)
     m_settings.setValue(keyBrepShapeDefaultMaterial, static_cast<int>(material));
 }
 
+bool Options::isBrepShapeInstancedDisplayOn() const
+{
+    return m_settings.value(keyBrepShapeInstancedDisplayOn, false).toBool();
+}
+
+void Options::setBrepShapeInstancedDisplay(bool on)
+{
+    m_settings.setValue(keyBrepShapeInstancedDisplayOn, on);
+}
+
+Options::MeshPresentation Options::meshPresentation() const
+{
+    static const int defaultVal = static_cast<int>(MeshPresentation::Triangulation);
+    const int prs = m_settings.value(keyMeshPresentation, defaultVal).toInt();
+    return static_cast<MeshPresentation>(prs);
+}
+
+void Options::setMeshPresentation(Options::MeshPresentation prs)
+{
+    m_settings.setValue(keyMeshPresentation, static_cast<int>(prs));
+}
+
 QColor Options::meshDefaultColor() const
 {
     static const QColor defaultColor(Qt::gray);
@@ -112,6 +226,17 @@ void Options::setMeshDefaultShowNodes(bool on)
     m_settings.setValue(keyMeshDefaultShowNodes, on);
 }
 
+int Options::viewLodFrameTimeTarget() const
+{
+    static const int defaultVal = 33; // ~30 FPS
+    return m_settings.value(keyViewLodFrameTimeTarget, defaultVal).toInt();
+}
+
+void Options::setViewLodFrameTimeTarget(int ms)
+{
+    m_settings.setValue(keyViewLodFrameTimeTarget, ms);
+}
+
 bool Options::isClipPlaneCappingOn() const
 {
     return m_settings.value(keyClipPlaneCappingOn, true).toBool();
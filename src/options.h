@@ -20,7 +20,8 @@ class Options : public QObject {
 public:
     enum class StlIoLibrary {
         Gmio,
-        OpenCascade
+        OpenCascade,
+        Native // STL import only, export falls back to OpenCascade
     };
 
     static Options* instance();
@@ -28,6 +29,39 @@ public:
     StlIoLibrary stlIoLibrary() const;
     void setStlIoLibrary(StlIoLibrary lib);
 
+    // Vertex coordinates are snapped to a grid of this size by the native STL
+    // reader, vertices snapped to the same grid point are merged. Close
+    // vertices on both sides of a grid cell boundary are kept apart. Zero
+    // means only bitwise equal vertices are merged
+    double stlWeldTolerance() const;
+    void setStlWeldTolerance(double tol);
+
+    // Import
+
+    bool isConcurrentImportOn() const;
+    void setConcurrentImport(bool on);
+
+    bool isImportCacheOn() const;
+    void setImportCache(bool on);
+
+    QString importCacheDir() const;
+    void setImportCacheDir(const QString& dirPath);
+
+    int importCacheMaxSize() const; // Megabytes
+    void setImportCacheMaxSize(int sizeMB);
+
+    // Deviation coefficient of the meshing stage for BRep shapes, also used by
+    // their presentations(see Prs3d_Drawer::DeviationCoefficient()). Zero
+    // disables the meshing stage
+    double importMeshingDeflection() const;
+    void setImportMeshingDeflection(double coeff);
+
+    // Identical parts of imported XDE documents share their topology, see
+    // XdePartIndex. Triangulations of shared parts are shared too, so they
+    // keep the meshing deflection of the document that first imported them
+    bool isImportPartSharingOn() const;
+    void setImportPartSharing(bool on);
+
     // BRep shape graphics
 
     QColor brepShapeDefaultColor() const;
@@ -36,8 +70,21 @@ public:
     Graphic3d_NameOfMaterial brepShapeDefaultMaterial() const;
     void setBrepShapeDefaultMaterial(Graphic3d_NameOfMaterial material);
 
+    // Repeated parts of assemblies are presented once, each occurrence being a
+    // located reference to this shared presentation
+    bool isBrepShapeInstancedDisplayOn() const;
+    void setBrepShapeInstancedDisplay(bool on);
+
     // Mesh graphics
 
+    enum class MeshPresentation {
+        Triangulation, // Primitive arrays built straight from Poly_Triangulation
+        MeshVS // Fallback, much more memory per triangle
+    };
+
+    MeshPresentation meshPresentation() const;
+    void setMeshPresentation(MeshPresentation prs);
+
     QColor meshDefaultColor() const;
     void setMeshDefaultColor(const QColor& color);
 
@@ -50,6 +97,13 @@ public:
     bool meshDefaultShowNodes() const;
     void setMeshDefaultShowNodes(bool on);
 
+    // View
+
+    // Frame time to hold while the view is rotated or panned, by displaying
+    // decimated proxies of large items. Zero disables level of detail
+    int viewLodFrameTimeTarget() const; // Milliseconds
+    void setViewLodFrameTimeTarget(int ms);
+
     // Clip planes
 
     bool isClipPlaneCappingOn() const;
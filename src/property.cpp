@@ -7,6 +7,7 @@
 #include "property.h"
 
 #include "property_enumeration.h"
+#include <algorithm>
 #include <cassert>
 
 namespace Mayo {
@@ -16,9 +17,38 @@ const std::vector<Property*>& PropertyOwner::properties() const
     return m_properties;
 }
 
+void PropertyOwner::beginPropertyTransaction()
+{
+    ++m_propertyTransactionDepth;
+}
+
+void PropertyOwner::commitPropertyTransaction()
+{
+    assert(m_propertyTransactionDepth > 0);
+    if (--m_propertyTransactionDepth > 0)
+        return;
+
+    // Swapped first, so changes made by the notification aren't recorded
+    std::vector<Property*> vecProp;
+    vecProp.swap(m_vecPropertyChangedInTransaction);
+    if (!vecProp.empty())
+        this->onPropertiesChanged(vecProp);
+}
+
+bool PropertyOwner::isPropertyTransactionActive() const
+{
+    return m_propertyTransactionDepth > 0;
+}
+
 void PropertyOwner::onPropertyChanged(Property* /*prop*/)
 { }
 
+void PropertyOwner::onPropertiesChanged(const std::vector<Property*>& props)
+{
+    for (Property* prop : props)
+        this->onPropertyChanged(prop);
+}
+
 void PropertyOwner::blockPropertyChanged(bool on)
 {
     m_propertyChangedBlocked = on;
@@ -34,6 +64,13 @@ void PropertyOwner::addProperty(Property* prop)
     m_properties.emplace_back(prop);
 }
 
+void PropertyOwner::recordPropertyChanged(Property* prop)
+{
+    std::vector<Property*>& vecProp = m_vecPropertyChangedInTransaction;
+    if (std::find(vecProp.cbegin(), vecProp.cend(), prop) == vecProp.cend())
+        vecProp.push_back(prop);
+}
+
 const QString &Property::label() const
 {
     return m_label;
@@ -59,7 +96,12 @@ Property::Property(PropertyOwner *owner, const QString &label)
 
 void Property::notifyChanged()
 {
-    if (m_owner != nullptr && !m_owner->isPropertyChangedBlocked())
+    if (m_owner == nullptr || m_owner->isPropertyChangedBlocked())
+        return;
+
+    if (m_owner->isPropertyTransactionActive())
+        m_owner->recordPropertyChanged(this);
+    else
         m_owner->onPropertyChanged(this);
 }
 
@@ -78,6 +120,19 @@ PropertyChangedBlocker::~PropertyChangedBlocker()
         m_owner->blockPropertyChanged(false);
 }
 
+PropertyTransaction::PropertyTransaction(PropertyOwner* owner)
+    : m_owner(owner)
+{
+    if (m_owner != nullptr)
+        m_owner->beginPropertyTransaction();
+}
+
+PropertyTransaction::~PropertyTransaction()
+{
+    if (m_owner != nullptr)
+        m_owner->commitPropertyTransaction();
+}
+
 HandleProperty::HandleProperty(HandleProperty &&other)
 {
     this->swap(std::move(other));
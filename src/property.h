@@ -18,8 +18,18 @@ public:
     // TODO change to computed properties, remove member m_properties
     const std::vector<Property*>& properties() const;
 
+    // Changes made within a transaction are recorded, then notified at once to
+    // onPropertiesChanged() on commit. Transactions can be nested, only the
+    // outermost commit notifies
+    void beginPropertyTransaction();
+    void commitPropertyTransaction();
+    bool isPropertyTransactionActive() const;
+
 protected:
     virtual void onPropertyChanged(Property* prop);
+    // Distinct properties changed by a transaction, in order of first change
+    // Default implementation calls onPropertyChanged() for each one
+    virtual void onPropertiesChanged(const std::vector<Property*>& props);
     void blockPropertyChanged(bool on);
     bool isPropertyChangedBlocked() const;
 
@@ -28,8 +38,12 @@ protected:
 private:
     friend class Property;
     friend struct PropertyChangedBlocker;
+    void recordPropertyChanged(Property* prop);
+
     std::vector<Property*> m_properties;
     bool m_propertyChangedBlocked = false;
+    int m_propertyTransactionDepth = 0;
+    std::vector<Property*> m_vecPropertyChangedInTransaction;
 };
 
 struct PropertyChangedBlocker {
@@ -42,6 +56,17 @@ struct PropertyChangedBlocker {
             PropertyChangedBlocker __Mayo_PropertyChangedBlocker(owner); \
             Q_UNUSED(__Mayo_PropertyChangedBlocker);
 
+// Transaction on the properties of 'owner', committed at destruction
+struct PropertyTransaction {
+    PropertyTransaction(PropertyOwner* owner);
+    ~PropertyTransaction();
+    PropertyOwner* const m_owner;
+};
+
+#define Mayo_PropertyTransaction(owner) \
+            PropertyTransaction __Mayo_PropertyTransaction(owner); \
+            Q_UNUSED(__Mayo_PropertyTransaction);
+
 class Property {
 public:
     Property(PropertyOwner* owner, const QString& label);
@@ -9,6 +9,7 @@
 #include "widget_occ_view.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtGui/QBitmap>
 #include <QtGui/QCursor>
 #include <QtGui/QMouseEvent>
@@ -79,6 +80,7 @@ bool QtOccViewController::eventFilter(QObject* watched, QEvent* event)
         auto mouseEvent = static_cast<const QMouseEvent*>(event);
         const QPoint currPos = m_widgetView->mapFromGlobal(mouseEvent->globalPos());
         m_prevPos = currPos;
+        m_pressPos = currPos;
         if (mouseEvent->button() == Qt::LeftButton) {
             this->setViewCursor(Internal::rotateCursor());
             this->setStateRotation(true);
@@ -100,17 +102,26 @@ bool QtOccViewController::eventFilter(QObject* watched, QEvent* event)
         emit mouseMoved(currPos);
 
         const Qt::MouseButtons mouseButtons = QApplication::mouseButtons();
+        // V3d_View::Rotation() and Pan() redraw the view immediately
+        QElapsedTimer chrono;
+        chrono.start();
         if (mouseButtons == Qt::LeftButton && this->isRotating()) {
             view->Rotation(currPos.x(), currPos.y());
+            emit viewInteractionFrameRendered(chrono.nsecsElapsed() / 1000000.);
             return true;
         }
         else if (mouseButtons == Qt::RightButton && this->isPanning()) {
             view->Pan(currPos.x() - prevPos.x(), prevPos.y() - currPos.y());
+            emit viewInteractionFrameRendered(chrono.nsecsElapsed() / 1000000.);
             return true;
         }
         break;
     }
     case QEvent::MouseButtonRelease: {
+        auto mouseEvent = static_cast<const QMouseEvent*>(event);
+        const QPoint currPos = m_widgetView->mapFromGlobal(mouseEvent->globalPos());
+        if (mouseEvent->button() == Qt::LeftButton && currPos == m_pressPos)
+            emit mouseClicked(currPos);
         this->setViewCursor(Qt::ArrowCursor);
         this->setStateRotation(false);
         this->setStatePanning(false);
@@ -28,6 +28,10 @@ signals:
     void viewPanningEnded();
     void viewScaled();
     void mouseMoved(const QPoint& posMouseInView);
+    // Left button pressed then released without moving the mouse
+    void mouseClicked(const QPoint& posMouseInView);
+    // Time spent to redraw the view for a single rotation or panning step
+    void viewInteractionFrameRendered(double frameTime); // Milliseconds
 
 protected:
     void setStateRotation(bool on);
@@ -53,6 +57,7 @@ private:
 
     WidgetOccView* m_widgetView = nullptr;
     QPoint m_prevPos;
+    QPoint m_pressPos;
 };
 
 } // namespace Mayo
@@ -0,0 +1,262 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "shape_fingerprint.h"
+
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepGProp.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <GProp_GProps.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Lengths are rounded to this absolute precision(millimeters)
+static const double lengthPrecision = 1e-4;
+
+// Count of significant bits kept for areas and volumes
+static const int massMantissaBits = 24;
+
+// Tolerance on coefficients of matrices of inertia, relative to the greatest one
+static const double inertiaRelativePrecision = 1e-6;
+
+static int64_t roundLength(double value)
+{
+    return std::llround(value / lengthPrecision);
+}
+
+// Mantissa is rounded to 'massMantissaBits' bits, the exponent is kept apart
+static int64_t roundRelative(double value)
+{
+    if (std::abs(value) < Precision::Confusion())
+        return 0;
+
+    int exponent = 0;
+    const double mantissa = std::frexp(value, &exponent);
+    const int64_t roundedMantissa = std::llround(std::ldexp(mantissa, massMantissaBits));
+    return (static_cast<int64_t>(exponent) << 32) ^ roundedMantissa;
+}
+
+static void hashCombine(size_t* seed, int64_t value)
+{
+    *seed ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
+}
+
+static bool matchMatrices(const gp_Mat& lhs, const gp_Mat& rhs)
+{
+    double maxCoeff = 0.;
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 3; ++col)
+            maxCoeff = std::max({ maxCoeff, std::abs(lhs(row, col)), std::abs(rhs(row, col)) });
+    }
+
+    const double tolerance = inertiaRelativePrecision * maxCoeff;
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 3; ++col) {
+            if (std::abs(lhs(row, col) - rhs(row, col)) > tolerance)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static std::vector<gp_Pnt> vertexPoints(const TopoDS_Shape& shape)
+{
+    TopTools_IndexedMapOfShape mapVertex;
+    TopExp::MapShapes(shape, TopAbs_VERTEX, mapVertex);
+    std::vector<gp_Pnt> vecPnt;
+    vecPnt.reserve(mapVertex.Extent());
+    for (int i = 1; i <= mapVertex.Extent(); ++i)
+        vecPnt.push_back(BRep_Tool::Pnt(TopoDS::Vertex(mapVertex(i))));
+    return vecPnt;
+}
+
+// Each point of 'vecLhs' matches a distinct point of 'vecRhs' within
+// 'tolerance'. Points of 'vecRhs' are bucketed in a grid of cell size
+// 'tolerance', so a point is only searched in the 27 cells around it
+static bool matchPoints(
+        const std::vector<gp_Pnt>& vecLhs, const std::vector<gp_Pnt>& vecRhs, double tolerance)
+{
+    if (vecLhs.size() != vecRhs.size())
+        return false;
+
+    using Cell = std::array<int64_t, 3>;
+    struct CellHasher {
+        size_t operator()(const Cell& cell) const {
+            size_t seed = 0;
+            for (int64_t coord : cell)
+                hashCombine(&seed, coord);
+            return seed;
+        }
+    };
+    auto fnCell = [=](const gp_Pnt& pnt) {
+        return Cell{
+            static_cast<int64_t>(std::floor(pnt.X() / tolerance)),
+            static_cast<int64_t>(std::floor(pnt.Y() / tolerance)),
+            static_cast<int64_t>(std::floor(pnt.Z() / tolerance)) };
+    };
+
+    std::unordered_map<Cell, std::vector<size_t>, CellHasher> mapCellPoints;
+    for (size_t i = 0; i < vecRhs.size(); ++i)
+        mapCellPoints[fnCell(vecRhs.at(i))].push_back(i);
+
+    std::vector<bool> vecIsMatched(vecRhs.size(), false);
+    auto fnMatch = [&](const gp_Pnt& pnt, const Cell& cell) {
+        auto itCell = mapCellPoints.find(cell);
+        if (itCell == mapCellPoints.end())
+            return false;
+
+        for (size_t i : itCell->second) {
+            if (!vecIsMatched.at(i) && vecRhs.at(i).Distance(pnt) <= tolerance) {
+                vecIsMatched.at(i) = true;
+                return true;
+            }
+        }
+
+        return false;
+    };
+    for (const gp_Pnt& pnt : vecLhs) {
+        const Cell cell = fnCell(pnt);
+        bool isMatched = false;
+        for (int dx = -1; dx <= 1 && !isMatched; ++dx) {
+            for (int dy = -1; dy <= 1 && !isMatched; ++dy) {
+                for (int dz = -1; dz <= 1 && !isMatched; ++dz)
+                    isMatched = fnMatch(pnt, { cell[0] + dx, cell[1] + dy, cell[2] + dz });
+            }
+        }
+
+        if (!isMatched)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace Internal
+
+ShapeFingerprint ShapeFingerprint::compute(
+        const TopoDS_Shape& shape, MassProperties* massProps)
+{
+    ShapeFingerprint fp;
+    const TopoDS_Shape unlocatedShape = shape.Located(TopLoc_Location());
+    for (int type = TopAbs_COMPOUND; type < TopAbs_SHAPE; ++type) {
+        TopTools_IndexedMapOfShape mapSubShape;
+        TopExp::MapShapes(unlocatedShape, static_cast<TopAbs_ShapeEnum>(type), mapSubShape);
+        fp.subShapeCounts[type] = mapSubShape.Extent();
+        if (type == TopAbs_FACE) {
+            for (int i = 1; i <= mapSubShape.Extent(); ++i) {
+                const BRepAdaptor_Surface surface(TopoDS::Face(mapSubShape(i)), Standard_False);
+                ++fp.surfaceTypeCounts[surface.GetType()];
+            }
+        }
+    }
+
+    // Bounds of the geometry, triangulations are ignored as copies of a part
+    // may not be meshed the same way
+    Bnd_Box box;
+    BRepBndLib::AddOptimal(unlocatedShape, box, Standard_False, Standard_False);
+    if (!box.IsVoid()) {
+        double bounds[6];
+        box.Get(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+        for (int i = 0; i < 6; ++i)
+            fp.roundedBounds[i] = Internal::roundLength(bounds[i]);
+    }
+
+    MassProperties props;
+    GProp_GProps system;
+    BRepGProp::VolumeProperties(unlocatedShape, system);
+    props.volume = system.Mass();
+    const bool hasVolume = std::abs(props.volume) > Precision::Confusion();
+    if (hasVolume) {
+        props.volumeCentroid = system.CentreOfMass();
+        props.matrixOfInertia = system.MatrixOfInertia();
+    }
+
+    system = GProp_GProps();
+    BRepGProp::SurfaceProperties(unlocatedShape, system);
+    props.area = system.Mass();
+    if (std::abs(props.area) > Precision::Confusion()) {
+        props.areaCentroid = system.CentreOfMass();
+        if (!hasVolume)
+            props.matrixOfInertia = system.MatrixOfInertia();
+    }
+
+    const gp_Pnt& centroid = hasVolume ? props.volumeCentroid : props.areaCentroid;
+    fp.roundedCentroid = {
+        Internal::roundLength(centroid.X()),
+        Internal::roundLength(centroid.Y()),
+        Internal::roundLength(centroid.Z())
+    };
+    fp.roundedVolume = Internal::roundRelative(props.volume);
+    fp.roundedArea = Internal::roundRelative(props.area);
+    if (massProps != nullptr)
+        *massProps = props;
+
+    return fp;
+}
+
+bool ShapeFingerprint::isSameShape(
+        const TopoDS_Shape& lhs,
+        const MassProperties& lhsProps,
+        const TopoDS_Shape& rhs,
+        const MassProperties& rhsProps)
+{
+    // Mirror images have opposite products of inertia, unless they are null
+    if (!Internal::matchMatrices(lhsProps.matrixOfInertia, rhsProps.matrixOfInertia))
+        return false;
+
+    return Internal::matchPoints(
+                Internal::vertexPoints(lhs.Located(TopLoc_Location())),
+                Internal::vertexPoints(rhs.Located(TopLoc_Location())),
+                Internal::lengthPrecision);
+}
+
+bool ShapeFingerprint::operator==(const ShapeFingerprint& other) const
+{
+    return this->subShapeCounts == other.subShapeCounts
+            && this->surfaceTypeCounts == other.surfaceTypeCounts
+            && this->roundedBounds == other.roundedBounds
+            && this->roundedCentroid == other.roundedCentroid
+            && this->roundedVolume == other.roundedVolume
+            && this->roundedArea == other.roundedArea;
+}
+
+bool ShapeFingerprint::operator!=(const ShapeFingerprint& other) const
+{
+    return !this->operator==(other);
+}
+
+size_t ShapeFingerprint::hash() const
+{
+    size_t seed = 0;
+    for (int count : this->subShapeCounts)
+        Internal::hashCombine(&seed, count);
+    for (int count : this->surfaceTypeCounts)
+        Internal::hashCombine(&seed, count);
+    for (int64_t bound : this->roundedBounds)
+        Internal::hashCombine(&seed, bound);
+    for (int64_t coord : this->roundedCentroid)
+        Internal::hashCombine(&seed, coord);
+    Internal::hashCombine(&seed, this->roundedVolume);
+    Internal::hashCombine(&seed, this->roundedArea);
+    return seed;
+}
+
+} // namespace Mayo
@@ -0,0 +1,70 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <GeomAbs_SurfaceType.hxx>
+#include <TopAbs_ShapeEnum.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Mat.hxx>
+#include <gp_Pnt.hxx>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Mayo {
+
+//! Geometric fingerprint of a shape, used to find identical shapes that don't
+//! share their topology, ie copies of a part within a STEP file
+//!
+//! It is made of the counts of distinct sub-shapes, the counts of surface types
+//! of faces, the bounds and the mass properties. Real values are rounded so
+//! numerical noise is ignored. The own location of the shape is ignored too,
+//! copies placed differently have the same fingerprint
+//!
+//! Different shapes may have the same fingerprint(eg. a part and its mirror
+//! image), isSameShape() tells them apart
+struct ShapeFingerprint {
+    //! Exact mass properties computed along with the fingerprint, in the frame
+    //! of the shape without its own location
+    struct MassProperties {
+        double volume = 0.;
+        double area = 0.;
+        gp_Pnt volumeCentroid;
+        gp_Pnt areaCentroid;
+        gp_Mat matrixOfInertia; // At centroid, of the surface if no volume
+    };
+
+    static ShapeFingerprint compute(
+            const TopoDS_Shape& shape, MassProperties* massProps = nullptr);
+
+    //! Exact check of two shapes having the same fingerprint, in their frames
+    //! without own location : matrices of inertia and positions of vertices
+    //! must match within tolerance
+    static bool isSameShape(
+            const TopoDS_Shape& lhs,
+            const MassProperties& lhsProps,
+            const TopoDS_Shape& rhs,
+            const MassProperties& rhsProps);
+
+    bool operator==(const ShapeFingerprint& other) const;
+    bool operator!=(const ShapeFingerprint& other) const;
+
+    size_t hash() const;
+    struct Hasher {
+        size_t operator()(const ShapeFingerprint& fp) const { return fp.hash(); }
+    };
+
+    std::array<int, TopAbs_SHAPE> subShapeCounts = {};
+    std::array<int, GeomAbs_OtherSurface + 1> surfaceTypeCounts = {};
+    std::array<int64_t, 6> roundedBounds = {}; // xMin, yMin, zMin, xMax, yMax, zMax
+    std::array<int64_t, 3> roundedCentroid = {};
+    int64_t roundedVolume = 0;
+    int64_t roundedArea = 0;
+};
+
+} // namespace Mayo
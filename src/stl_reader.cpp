@@ -0,0 +1,694 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "stl_reader.h"
+
+#include "fougtools/qttools/task/progress.h"
+
+#include <OSD_Parallel.hxx>
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Mayo {
+
+namespace Internal {
+
+const size_t stlBinaryHeaderSize = 80 + sizeof(uint32_t);
+const size_t stlBinaryFacetSize = (12 * sizeof(float)) + sizeof(uint16_t);
+
+using StlVec3f = std::array<float, 3>;
+
+static uint32_t stlBinaryFacetCount(const uchar* data, qint64 dataSize)
+{
+    if (data == nullptr || dataSize < static_cast<qint64>(stlBinaryHeaderSize))
+        return 0;
+    return qFromLittleEndian<quint32>(data + 80);
+}
+
+static bool isStlBinaryContents(const uchar* data, qint64 dataSize)
+{
+    const uint64_t facetCount = stlBinaryFacetCount(data, dataSize);
+    return dataSize >= static_cast<qint64>(stlBinaryHeaderSize)
+            && (stlBinaryHeaderSize + facetCount * stlBinaryFacetSize)
+                == static_cast<uint64_t>(dataSize);
+}
+
+static float readFloatLE(const uchar* bytes)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(bytes);
+    float val;
+    std::memcpy(&val, &bits, sizeof(float));
+    return val;
+}
+
+// Maps progress of a sub-operation to the [pctBegin, pctEnd] range of the
+// overall progress
+struct ProgressRange {
+    qttask::Progress* progress;
+    int pctBegin;
+    int pctEnd;
+
+    bool setRatio(double ratio) const {
+        if (this->progress != nullptr) {
+            this->progress->setValue(
+                        this->pctBegin + qRound(ratio * (this->pctEnd - this->pctBegin)));
+            return !this->progress->isAbortRequested();
+        }
+        return true;
+    }
+
+    ProgressRange subRange(double ratioBegin, double ratioEnd) const {
+        const int pctWidth = this->pctEnd - this->pctBegin;
+        return { this->progress,
+                 this->pctBegin + qRound(ratioBegin * pctWidth),
+                 this->pctBegin + qRound(ratioEnd * pctWidth) };
+    }
+};
+
+struct VertexKey {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+
+    bool operator==(const VertexKey& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+// Finalizer of MurmurHash3
+static uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static uint64_t hashVertexKey(const VertexKey& key)
+{
+    return mixHash(((uint64_t(key.x) << 32) | key.y) ^ mixHash(key.z));
+}
+
+class VertexKeyMaker {
+public:
+    VertexKeyMaker(const StlReader::Parameters& params)
+        : m_isExact(params.vertexWeld == StlReader::VertexWeld::ExactBits),
+          m_invEpsilon(params.weldEpsilon > 0 ? 1. / params.weldEpsilon : 1.)
+    {}
+
+    VertexKey operator()(const StlVec3f& v) const {
+        if (m_isExact)
+            return { floatBits(v[0]), floatBits(v[1]), floatBits(v[2]) };
+        return { gridCell(v[0]), gridCell(v[1]), gridCell(v[2]) };
+    }
+
+private:
+    static uint32_t floatBits(float val) {
+        uint32_t bits;
+        std::memcpy(&bits, &val, sizeof(float));
+        return bits != 0x80000000 ? bits : 0; // -0.f and +0.f are the same vertex
+    }
+
+    uint32_t gridCell(float val) const {
+        const double cell = std::floor(val * m_invEpsilon);
+        const double cellMin = std::numeric_limits<int32_t>::min();
+        const double cellMax = std::numeric_limits<int32_t>::max();
+        return static_cast<uint32_t>(
+                    static_cast<int32_t>(std::max(cellMin, std::min(cell, cellMax))));
+    }
+
+    bool m_isExact;
+    double m_invEpsilon;
+};
+
+// Builds an indexed triangulation out of a "triangle soup" of 'facetCount'
+// facets, position of facet corner 'slot'(ie facet * 3 + corner) being
+// provided by 'funcVertex(slot)'
+//
+// Duplicate vertices are welded in parallel : corner slots are scattered into
+// partitions picked by the high bits of the vertex hash, then each partition
+// is deduplicated independently with its own open-addressing table. Node
+// indices of a partition are finally offset by the count of unique vertices
+// in the preceding partitions, so the result does not depend on scheduling.
+template<typename FUNC_VERTEX>
+Handle_Poly_Triangulation weldTriangleSoup(
+        uint32_t facetCount,
+        const FUNC_VERTEX& funcVertex,
+        const StlReader::Parameters& params,
+        const ProgressRange& progress)
+{
+    const VertexKeyMaker makeKey(params);
+    const uint32_t slotCount = 3 * facetCount;
+    const uint32_t threadCount =
+            std::max(OSD_Parallel::NbLogicalProcessors(), 1);
+    const int chunkCount =
+            static_cast<int>(std::min(4 * threadCount, std::max(slotCount, 1u)));
+    // Enough partitions to keep all threads busy, and small enough to keep
+    // each hash table in cache-friendly bounds
+    int partitionBits = 0;
+    while (partitionBits < 12
+           && ((1u << partitionBits) < 4 * threadCount
+               || (slotCount >> partitionBits) > (1u << 20)))
+    {
+        ++partitionBits;
+    }
+
+    const int partitionCount = 1 << partitionBits;
+    auto fnPartition = [=](const VertexKey& key) {
+        return partitionBits > 0 ?
+                    static_cast<int>(hashVertexKey(key) >> (64 - partitionBits)) :
+                    0;
+    };
+    auto fnChunkBegin = [=](int chunk) {
+        return static_cast<uint32_t>((uint64_t(slotCount) * chunk) / chunkCount);
+    };
+
+    // Count slots per chunk and partition
+    std::vector<uint32_t> vecChunkHistogram(chunkCount * partitionCount, 0);
+    OSD_Parallel::For(0, chunkCount, [&](int chunk) {
+        uint32_t* histogram = &vecChunkHistogram.at(chunk * partitionCount);
+        const uint32_t slotEnd = fnChunkBegin(chunk + 1);
+        for (uint32_t slot = fnChunkBegin(chunk); slot < slotEnd; ++slot)
+            ++histogram[fnPartition(makeKey(funcVertex(slot)))];
+    });
+    if (!progress.setRatio(0.2))
+        return Handle_Poly_Triangulation();
+
+    // Scatter slots into partitions, slots of a partition are kept in
+    // ascending order
+    std::vector<uint32_t> vecPartitionBegin(partitionCount + 1, 0);
+    std::vector<uint32_t>& vecChunkCursor = vecChunkHistogram;
+    uint32_t offset = 0;
+    for (int p = 0; p < partitionCount; ++p) {
+        vecPartitionBegin.at(p) = offset;
+        for (int c = 0; c < chunkCount; ++c) {
+            const uint32_t slotCountInChunk = vecChunkHistogram.at(c * partitionCount + p);
+            vecChunkCursor.at(c * partitionCount + p) = offset;
+            offset += slotCountInChunk;
+        }
+    }
+
+    vecPartitionBegin.at(partitionCount) = offset;
+    std::vector<uint32_t> vecPartitionSlot(slotCount);
+    OSD_Parallel::For(0, chunkCount, [&](int chunk) {
+        uint32_t* cursor = &vecChunkCursor.at(chunk * partitionCount);
+        const uint32_t slotEnd = fnChunkBegin(chunk + 1);
+        for (uint32_t slot = fnChunkBegin(chunk); slot < slotEnd; ++slot) {
+            const int p = fnPartition(makeKey(funcVertex(slot)));
+            vecPartitionSlot[cursor[p]++] = slot;
+        }
+    });
+    if (!progress.setRatio(0.4))
+        return Handle_Poly_Triangulation();
+
+    // Deduplicate vertices of each partition
+    const uint32_t nullId = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> vecSlotLocalId(slotCount);
+    std::vector<std::vector<uint32_t>> vecPartitionUniqueSlot(partitionCount);
+    OSD_Parallel::For(0, partitionCount, [&](int p) {
+        struct Entry {
+            VertexKey key;
+            uint32_t localId;
+        };
+        const uint32_t slotBegin = vecPartitionBegin.at(p);
+        const uint32_t slotEnd = vecPartitionBegin.at(p + 1);
+        size_t tableSize = 16;
+        while (tableSize < 2 * size_t(slotEnd - slotBegin))
+            tableSize *= 2;
+        const size_t tableMask = tableSize - 1;
+        std::vector<Entry> table(tableSize, Entry{ { 0, 0, 0 }, nullId });
+        std::vector<uint32_t>& vecUniqueSlot = vecPartitionUniqueSlot.at(p);
+        for (uint32_t i = slotBegin; i < slotEnd; ++i) {
+            const uint32_t slot = vecPartitionSlot[i];
+            const VertexKey key = makeKey(funcVertex(slot));
+            size_t pos = hashVertexKey(key) & tableMask;
+            while (table[pos].localId != nullId && !(table[pos].key == key))
+                pos = (pos + 1) & tableMask;
+            if (table[pos].localId == nullId) {
+                table[pos].key = key;
+                table[pos].localId = static_cast<uint32_t>(vecUniqueSlot.size());
+                vecUniqueSlot.push_back(slot);
+            }
+
+            vecSlotLocalId[slot] = table[pos].localId;
+        }
+    });
+    if (!progress.setRatio(0.7))
+        return Handle_Poly_Triangulation();
+
+    std::vector<uint32_t> vecPartitionNodeBase(partitionCount, 0);
+    uint64_t nodeCount = 0;
+    for (int p = 0; p < partitionCount; ++p) {
+        vecPartitionNodeBase.at(p) = static_cast<uint32_t>(nodeCount);
+        nodeCount += vecPartitionUniqueSlot.at(p).size();
+    }
+
+    if (nodeCount > static_cast<uint64_t>(std::numeric_limits<int>::max()))
+        return Handle_Poly_Triangulation();
+
+    // Fill the triangulation arrays
+    Handle_Poly_Triangulation mesh =
+            new Poly_Triangulation(
+                static_cast<int>(nodeCount),
+                static_cast<int>(facetCount),
+                Standard_False);
+    TColgp_Array1OfPnt& vecNode = mesh->ChangeNodes();
+    Poly_Array1OfTriangle& vecTriangle = mesh->ChangeTriangles();
+    OSD_Parallel::For(0, partitionCount, [&](int p) {
+        const uint32_t nodeBase = vecPartitionNodeBase.at(p);
+        const std::vector<uint32_t>& vecUniqueSlot = vecPartitionUniqueSlot.at(p);
+        for (size_t i = 0; i < vecUniqueSlot.size(); ++i) {
+            const StlVec3f v = funcVertex(vecUniqueSlot[i]);
+            vecNode.ChangeValue(static_cast<int>(nodeBase + i + 1)).SetCoord(v[0], v[1], v[2]);
+        }
+
+        const uint32_t slotEnd = vecPartitionBegin.at(p + 1);
+        for (uint32_t i = vecPartitionBegin.at(p); i < slotEnd; ++i) {
+            const uint32_t slot = vecPartitionSlot[i];
+            Poly_Triangle& triangle = vecTriangle.ChangeValue(slot / 3 + 1);
+            triangle.ChangeValue(slot % 3 + 1) = nodeBase + vecSlotLocalId[slot] + 1;
+        }
+    });
+    progress.setRatio(1.);
+    return mesh;
+}
+
+static bool isAsciiSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+static bool isAsciiDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool isToken(const char* first, const char* last, const char* keyword)
+{
+    const size_t keywordLen = std::strlen(keyword);
+    return static_cast<size_t>(last - first) == keywordLen
+            && std::memcmp(first, keyword, keywordLen) == 0;
+}
+
+// Locale-independent conversion of [first, last) into a float, in the manner of
+// C++17 std::from_chars()
+// Returns a pointer to the first character not matching the float pattern, or
+// nullptr if no conversion could be performed
+static const char* parseFloat(const char* first, const char* last, float* value)
+{
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char* it = first;
+    bool isNegative = false;
+    if (it != last && (*it == '-' || *it == '+')) {
+        isNegative = *it == '-';
+        ++it;
+    }
+
+    // Only the 19 first significant digits fit in the mantissa
+    uint64_t mantissa = 0;
+    int digitCount = 0;
+    int exp10 = 0;
+    bool hasDigits = false;
+    for (; it != last && isAsciiDigit(*it); ++it) {
+        hasDigits = true;
+        if (digitCount < 19) {
+            mantissa = mantissa * 10 + (*it - '0');
+            digitCount += mantissa != 0 ? 1 : 0;
+        }
+        else {
+            ++exp10;
+        }
+    }
+
+    if (it != last && *it == '.') {
+        for (++it; it != last && isAsciiDigit(*it); ++it) {
+            hasDigits = true;
+            if (digitCount < 19) {
+                mantissa = mantissa * 10 + (*it - '0');
+                digitCount += mantissa != 0 ? 1 : 0;
+                --exp10;
+            }
+        }
+    }
+
+    if (!hasDigits)
+        return nullptr;
+
+    if (it != last && (*it == 'e' || *it == 'E')) {
+        ++it;
+        bool isExpNegative = false;
+        if (it != last && (*it == '-' || *it == '+')) {
+            isExpNegative = *it == '-';
+            ++it;
+        }
+
+        if (it == last || !isAsciiDigit(*it))
+            return nullptr;
+
+        int exp = 0;
+        for (; it != last && isAsciiDigit(*it); ++it)
+            exp = std::min(exp * 10 + (*it - '0'), 9999);
+        exp10 += isExpNegative ? -exp : exp;
+    }
+
+    double val = static_cast<double>(mantissa);
+    if (mantissa == 0)
+        val = 0.;
+    else if (exp10 >= 0 && exp10 <= 22)
+        val *= pow10[exp10];
+    else if (exp10 < 0 && exp10 >= -22)
+        val /= pow10[-exp10];
+    else
+        val *= std::pow(10., exp10);
+
+    *value = static_cast<float>(isNegative ? -val : val);
+    return it;
+}
+
+struct StlAsciiSolidMark {
+    uint64_t vertexId; // Index of the first vertex of the solid
+    std::string name;
+};
+
+// Part of an ASCII STL file processed by a single thread, starts at a line
+// beginning with "facet normal" (or at start of file)
+struct StlAsciiChunk {
+    const char* begin;
+    const char* end;
+    uint64_t vertexCount;
+    uint64_t vertexBase; // Count of vertices in the preceding chunks
+    std::vector<StlAsciiSolidMark> vecSolidMark;
+    const char* errorPos;
+};
+
+// Tokenizes [chunk.begin, chunk.end), 'fnVertex(vertexId, it)' is called for
+// each "vertex" keyword with 'it' pointing just after the keyword
+// "solid" lines are registered into 'chunk.vecSolidMark' when 'registerSolids'
+// is on
+template<typename FUNC_VERTEX>
+static void scanStlAsciiChunk(
+        StlAsciiChunk* chunk, bool registerSolids, const FUNC_VERTEX& fnVertex)
+{
+    const char* it = chunk->begin;
+    const char* const end = chunk->end;
+    uint64_t vertexCount = 0;
+    while (true) {
+        while (it != end && isAsciiSpace(*it))
+            ++it;
+        if (it == end)
+            break;
+
+        const char* tokenEnd = it;
+        while (tokenEnd != end && !isAsciiSpace(*tokenEnd))
+            ++tokenEnd;
+
+        if (isToken(it, tokenEnd, "vertex")) {
+            it = tokenEnd;
+            if (!fnVertex(chunk->vertexBase + vertexCount, it)) {
+                chunk->errorPos = it;
+                return;
+            }
+
+            ++vertexCount;
+        }
+        else if (isToken(it, tokenEnd, "solid") || isToken(it, tokenEnd, "endsolid")) {
+            const bool isSolidBegin = *it == 's';
+            const char* lineEnd = std::find(tokenEnd, end, '\n');
+            if (isSolidBegin && registerSolids) {
+                const char* nameBegin = tokenEnd;
+                const char* nameEnd = lineEnd;
+                while (nameBegin != nameEnd && isAsciiSpace(*nameBegin))
+                    ++nameBegin;
+                while (nameEnd != nameBegin && isAsciiSpace(*(nameEnd - 1)))
+                    --nameEnd;
+                chunk->vecSolidMark.push_back(
+                            { chunk->vertexBase + vertexCount, std::string(nameBegin, nameEnd) });
+            }
+
+            it = lineEnd;
+        }
+        else {
+            it = tokenEnd;
+        }
+    }
+
+    chunk->vertexCount = vertexCount;
+}
+
+// Returns the start of the first line beginning with "facet" keyword found in
+// [pos, end), or 'end'
+static const char* findStlAsciiFacetLine(const char* pos, const char* end)
+{
+    while (pos != end) {
+        const char* lineBegin = std::find(pos, end, '\n');
+        if (lineBegin == end)
+            return end;
+
+        ++lineBegin;
+        const char* it = lineBegin;
+        while (it != end && (*it == ' ' || *it == '\t'))
+            ++it;
+        if (end - it >= 5 && std::memcmp(it, "facet", 5) == 0)
+            return lineBegin;
+
+        pos = lineBegin;
+    }
+
+    return end;
+}
+
+} // namespace Internal
+
+bool StlReader::isBinaryFile(const QString& filepath)
+{
+    QFile file(filepath);
+    if (file.open(QIODevice::ReadOnly)) {
+        const QByteArray header = file.read(Internal::stlBinaryHeaderSize);
+        const auto bytes = reinterpret_cast<const uchar*>(header.constData());
+        const uint64_t facetCount =
+                Internal::stlBinaryFacetCount(bytes, header.size());
+        return header.size() == static_cast<int>(Internal::stlBinaryHeaderSize)
+                && (Internal::stlBinaryHeaderSize
+                    + facetCount * Internal::stlBinaryFacetSize)
+                   == static_cast<uint64_t>(file.size());
+    }
+    return false;
+}
+
+StlReader::Result StlReader::readBinary(
+        const QString& filepath,
+        const Parameters& params,
+        qttask::Progress* progress)
+{
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly))
+        return { false, file.errorString(), {} };
+
+    const qint64 fileSize = file.size();
+    const uchar* data = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    if (data == nullptr)
+        return { false, tr("Failed to map file in memory: %1").arg(file.errorString()), {} };
+    if (!Internal::isStlBinaryContents(data, fileSize))
+        return { false, tr("Not a binary STL file"), {} };
+
+    const uint32_t facetCount = Internal::stlBinaryFacetCount(data, fileSize);
+    if (facetCount == 0)
+        return { false, tr("No facet found"), {} };
+    if (facetCount > static_cast<uint32_t>(std::numeric_limits<int>::max() / 3))
+        return { false, tr("Too many facets(%1)").arg(facetCount), {} };
+
+    const uchar* facets = data + Internal::stlBinaryHeaderSize;
+    auto fnVertex = [=](uint32_t slot) {
+        // Skip facet normal
+        const uchar* coords =
+                facets
+                + size_t(slot / 3) * Internal::stlBinaryFacetSize
+                + (1 + slot % 3) * 3 * sizeof(float);
+        return Internal::StlVec3f{{
+                Internal::readFloatLE(coords),
+                Internal::readFloatLE(coords + sizeof(float)),
+                Internal::readFloatLE(coords + 2 * sizeof(float)) }};
+    };
+
+    Solid solid;
+    solid.mesh = Internal::weldTriangleSoup(
+                facetCount, fnVertex, params, { progress, 0, 100 });
+    if (solid.mesh.IsNull()) {
+        if (progress != nullptr && progress->isAbortRequested())
+            return { false, tr("Aborted"), {} };
+        return { false, tr("Too many nodes"), {} };
+    }
+
+    Result result = { true, QString(), {} };
+    result.solids.push_back(std::move(solid));
+    return result;
+}
+
+StlReader::Result StlReader::readAscii(
+        const QString& filepath,
+        const Parameters& params,
+        qttask::Progress* progress)
+{
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly))
+        return { false, file.errorString(), {} };
+
+    const qint64 fileSize = file.size();
+    const uchar* data = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    if (data == nullptr)
+        return { false, tr("Failed to map file in memory: %1").arg(file.errorString()), {} };
+
+    // Split file contents at "facet normal" lines
+    const auto contents = reinterpret_cast<const char*>(data);
+    const char* const contentsEnd = contents + fileSize;
+    const size_t threadCount = std::max(OSD_Parallel::NbLogicalProcessors(), 1);
+    const size_t chunkCount =
+            std::max<size_t>(std::min<size_t>(4 * threadCount, fileSize >> 20), 1);
+    std::vector<Internal::StlAsciiChunk> vecChunk;
+    const char* chunkBegin = contents;
+    for (size_t i = 1; i <= chunkCount && chunkBegin != contentsEnd; ++i) {
+        const char* chunkEnd =
+                i < chunkCount ?
+                    Internal::findStlAsciiFacetLine(
+                        std::max(chunkBegin, contents + (fileSize * i) / chunkCount),
+                        contentsEnd) :
+                    contentsEnd;
+        vecChunk.push_back({ chunkBegin, chunkEnd, 0, 0, {}, nullptr });
+        chunkBegin = chunkEnd;
+    }
+
+    const int chunkCountInt = static_cast<int>(vecChunk.size());
+    const Internal::ProgressRange progressRange = { progress, 0, 100 };
+
+    // Count vertices and locate solids
+    OSD_Parallel::For(0, chunkCountInt, [&](int i) {
+        Internal::scanStlAsciiChunk(&vecChunk.at(i), true, [](uint64_t, const char*&) {
+            return true;
+        });
+    });
+    if (!progressRange.setRatio(0.2))
+        return { false, tr("Aborted"), {} };
+
+    uint64_t vertexCount = 0;
+    std::vector<Internal::StlAsciiSolidMark> vecSolidMark;
+    for (Internal::StlAsciiChunk& chunk : vecChunk) {
+        chunk.vertexBase = vertexCount;
+        for (Internal::StlAsciiSolidMark& mark : chunk.vecSolidMark) {
+            mark.vertexId += vertexCount;
+            vecSolidMark.push_back(std::move(mark));
+        }
+
+        vertexCount += chunk.vertexCount;
+    }
+
+    // Any text file would be parsed successfully into zero solids otherwise
+    if (vecSolidMark.empty() && vertexCount == 0)
+        return { false, tr("Not an ASCII STL file, no solid nor facet found"), {} };
+
+    if (vecSolidMark.empty() || vecSolidMark.front().vertexId != 0)
+        vecSolidMark.insert(vecSolidMark.begin(), { 0, std::string() });
+
+    // Parse vertex coordinates
+    std::vector<float> vecCoord(3 * vertexCount);
+    OSD_Parallel::For(0, chunkCountInt, [&](int i) {
+        const char* const chunkEnd = vecChunk.at(i).end;
+        Internal::scanStlAsciiChunk(&vecChunk.at(i), false, [&](uint64_t vertexId, const char*& it) {
+            float* coords = &vecCoord[3 * vertexId];
+            for (int c = 0; c < 3; ++c) {
+                while (it != chunkEnd && Internal::isAsciiSpace(*it))
+                    ++it;
+                const char* itNext = Internal::parseFloat(it, chunkEnd, coords + c);
+                if (itNext == nullptr
+                        || (itNext != chunkEnd && !Internal::isAsciiSpace(*itNext)))
+                {
+                    return false;
+                }
+
+                it = itNext;
+            }
+
+            return true;
+        });
+    });
+    for (const Internal::StlAsciiChunk& chunk : vecChunk) {
+        if (chunk.errorPos != nullptr) {
+            const qint64 errorOffset = chunk.errorPos - contents;
+            return { false, tr("Invalid vertex coordinates at offset %1").arg(errorOffset), {} };
+        }
+    }
+
+    if (!progressRange.setRatio(0.5))
+        return { false, tr("Aborted"), {} };
+
+    // Build a triangulation per solid
+    Result result = { true, QString(), {} };
+    for (size_t i = 0; i < vecSolidMark.size(); ++i) {
+        const uint64_t vertexBegin = vecSolidMark.at(i).vertexId;
+        const uint64_t vertexEnd =
+                i + 1 < vecSolidMark.size() ? vecSolidMark.at(i + 1).vertexId : vertexCount;
+        const uint64_t solidVertexCount = vertexEnd - vertexBegin;
+        if (solidVertexCount == 0)
+            continue;
+        if (solidVertexCount % 3 != 0) {
+            const QString solidName = QString::fromStdString(vecSolidMark.at(i).name);
+            return { false, tr("Facet with missing vertices in solid '%1'").arg(solidName), {} };
+        }
+        if (solidVertexCount / 3 > static_cast<uint64_t>(std::numeric_limits<int>::max() / 3))
+            return { false, tr("Too many facets(%1)").arg(solidVertexCount / 3), {} };
+
+        const float* solidCoords = vecCoord.data() + 3 * vertexBegin;
+        auto fnVertex = [=](uint32_t slot) {
+            const float* coords = solidCoords + 3 * size_t(slot);
+            return Internal::StlVec3f{{ coords[0], coords[1], coords[2] }};
+        };
+
+        Solid solid;
+        solid.name = std::move(vecSolidMark.at(i).name);
+        solid.mesh = Internal::weldTriangleSoup(
+                    static_cast<uint32_t>(solidVertexCount / 3),
+                    fnVertex,
+                    params,
+                    progressRange.subRange(
+                        0.5 + 0.5 * (double(vertexBegin) / vertexCount),
+                        0.5 + 0.5 * (double(vertexEnd) / vertexCount)));
+        if (solid.mesh.IsNull()) {
+            if (progress != nullptr && progress->isAbortRequested())
+                return { false, tr("Aborted"), {} };
+            return { false, tr("Too many nodes"), {} };
+        }
+
+        result.solids.push_back(std::move(solid));
+    }
+
+    // Solids were all empty
+    if (result.solids.empty())
+        return { false, tr("No facet found"), {} };
+
+    return result;
+}
+
+StlReader::Result StlReader::read(
+        const QString& filepath,
+        const Parameters& params,
+        qttask::Progress* progress)
+{
+    if (StlReader::isBinaryFile(filepath))
+        return StlReader::readBinary(filepath, params, progress);
+    return StlReader::readAscii(filepath, params, progress);
+}
+
+} // namespace Mayo
@@ -0,0 +1,67 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <Poly_Triangulation.hxx>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+#include <string>
+#include <vector>
+
+namespace qttask { class Progress; }
+
+namespace Mayo {
+
+//! Native STL reader : file contents are memory-mapped and processed by all
+//! the available cores, triangulation arrays are filled directly
+//! ASCII files may contain several solids, each one being read as a
+//! separate triangulation
+struct StlReader {
+    Q_DECLARE_TR_FUNCTIONS(Mayo::StlReader)
+public:
+    enum class VertexWeld {
+        ExactBits, // Vertices are merged when their coordinates are bitwise equal
+        Epsilon    // Vertices are merged when they fall in the same grid cell
+    };
+
+    struct Parameters {
+        VertexWeld vertexWeld = VertexWeld::ExactBits;
+        double weldEpsilon = 1e-6; // Size of grid cells with VertexWeld::Epsilon
+    };
+
+    struct Solid {
+        std::string name;
+        Handle_Poly_Triangulation mesh;
+    };
+
+    // Files without any facet are errors, so 'solids' isn't empty on success
+    struct Result {
+        bool ok;
+        QString errorText;
+        std::vector<Solid> solids;
+    };
+
+    static bool isBinaryFile(const QString& filepath);
+
+    // Reads binary or ASCII file, depending on isBinaryFile()
+    static Result read(
+            const QString& filepath,
+            const Parameters& params,
+            qttask::Progress* progress = nullptr);
+
+    static Result readBinary(
+            const QString& filepath,
+            const Parameters& params,
+            qttask::Progress* progress = nullptr);
+
+    static Result readAscii(
+            const QString& filepath,
+            const Parameters& params,
+            qttask::Progress* progress = nullptr);
+};
+
+} // namespace Mayo
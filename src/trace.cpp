@@ -0,0 +1,151 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "trace.h"
+
+#ifdef HAVE_MAYO_TRACE
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Mayo {
+
+namespace Internal {
+
+struct TraceEvent {
+    const char* name; // Null when 'dynName' is used
+    QByteArray dynName;
+    int64_t beginTime;
+    int64_t endTime;
+};
+
+struct TraceThreadBuffer {
+    int threadId;
+    QString threadName;
+    std::mutex mutex; // Only contended while the trace is written
+    std::vector<TraceEvent> vecEvent;
+};
+
+struct TraceRegistry {
+    const std::chrono::steady_clock::time_point startTime =
+            std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> vecThreadBuffer;
+};
+
+static TraceRegistry* traceRegistry()
+{
+    static TraceRegistry registry;
+    return &registry;
+}
+
+// Buffers are owned by the registry, so events of finished threads are kept
+static TraceThreadBuffer* currentThreadBuffer()
+{
+    static thread_local TraceThreadBuffer* threadBuffer = nullptr;
+    if (threadBuffer == nullptr) {
+        TraceRegistry* registry = traceRegistry();
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        threadBuffer = new TraceThreadBuffer;
+        threadBuffer->threadId = static_cast<int>(registry->vecThreadBuffer.size()) + 1;
+        const bool isMainThread =
+                QCoreApplication::instance() != nullptr
+                && QCoreApplication::instance()->thread() == QThread::currentThread();
+        threadBuffer->threadName =
+                isMainThread ?
+                    QStringLiteral("Main thread") :
+                    QString("Worker %1").arg(threadBuffer->threadId);
+        registry->vecThreadBuffer.emplace_back(threadBuffer);
+    }
+
+    return threadBuffer;
+}
+
+static void addTraceEvent(TraceEvent&& event)
+{
+    TraceThreadBuffer* threadBuffer = currentThreadBuffer();
+    std::lock_guard<std::mutex> lock(threadBuffer->mutex);
+    threadBuffer->vecEvent.push_back(std::move(event));
+}
+
+} // namespace Internal
+
+int64_t Trace::now()
+{
+    const auto elapsed =
+            std::chrono::steady_clock::now() - Internal::traceRegistry()->startTime;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void Trace::addEvent(const char* name, int64_t beginTime, int64_t endTime)
+{
+    Internal::addTraceEvent({ name, QByteArray(), beginTime, endTime });
+}
+
+void Trace::addEvent(const QString& name, int64_t beginTime, int64_t endTime)
+{
+    Internal::addTraceEvent({ nullptr, name.toUtf8(), beginTime, endTime });
+}
+
+bool Trace::writeChromeJson(const QString& filepath)
+{
+    Internal::TraceRegistry* registry = Internal::traceRegistry();
+    QJsonArray jsonEvents;
+    {
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        for (const auto& threadBuffer : registry->vecThreadBuffer) {
+            // Metadata event naming the thread in the viewer
+            QJsonObject jsonThreadName;
+            jsonThreadName.insert("name", "thread_name");
+            jsonThreadName.insert("ph", "M");
+            jsonThreadName.insert("pid", 1);
+            jsonThreadName.insert("tid", threadBuffer->threadId);
+            jsonThreadName.insert("args", QJsonObject{ { "name", threadBuffer->threadName } });
+            jsonEvents.append(jsonThreadName);
+
+            std::lock_guard<std::mutex> lockBuffer(threadBuffer->mutex);
+            for (const Internal::TraceEvent& event : threadBuffer->vecEvent) {
+                const QString name =
+                        event.name != nullptr ?
+                            QString::fromUtf8(event.name) :
+                            QString::fromUtf8(event.dynName);
+                QJsonObject jsonEvent;
+                jsonEvent.insert("name", name);
+                jsonEvent.insert("cat", "mayo");
+                jsonEvent.insert("ph", "X"); // Complete event
+                jsonEvent.insert("ts", static_cast<double>(event.beginTime));
+                jsonEvent.insert("dur", static_cast<double>(event.endTime - event.beginTime));
+                jsonEvent.insert("pid", 1);
+                jsonEvent.insert("tid", threadBuffer->threadId);
+                jsonEvents.append(jsonEvent);
+            }
+        }
+    }
+
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    const QJsonObject jsonRoot{
+        { "traceEvents", jsonEvents },
+        { "displayTimeUnit", "ms" }
+    };
+    return file.write(QJsonDocument(jsonRoot).toJson(QJsonDocument::Compact)) != -1;
+}
+
+} // namespace Mayo
+
+#endif // HAVE_MAYO_TRACE
@@ -0,0 +1,64 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+// Scoped tracing of the application, events are written in the Chrome
+// trace-event format, to be opened with chrome://tracing or any compatible
+// trace viewer.
+// Tracing is enabled at compile-time with qmake option "CONFIG+=mayo_trace",
+// otherwise all Mayo_Trace*() macros expand to nothing
+
+#ifdef HAVE_MAYO_TRACE
+
+#include <QtCore/QString>
+#include <cstdint>
+
+namespace Mayo {
+
+//! Collects trace events of all threads
+//!
+//! Each thread appends its events to its own buffer, buffers are merged only
+//! when the trace is written
+class Trace {
+public:
+    // Microseconds elapsed since the first use of Trace
+    static int64_t now();
+
+    // 'name' must stay valid until the trace is written, typically a literal
+    static void addEvent(const char* name, int64_t beginTime, int64_t endTime);
+    static void addEvent(const QString& name, int64_t beginTime, int64_t endTime);
+
+    static bool writeChromeJson(const QString& filepath);
+};
+
+//! Records the lifetime of a scope as one trace event
+class TraceScope {
+public:
+    TraceScope(const char* name)
+        : m_name(name), m_beginTime(Trace::now())
+    {}
+
+    ~TraceScope()
+    { Trace::addEvent(m_name, m_beginTime, Trace::now()); }
+
+private:
+    const char* m_name;
+    int64_t m_beginTime;
+};
+
+} // namespace Mayo
+
+#define Mayo_TraceConcat_(a, b) a##b
+#define Mayo_TraceConcat(a, b) Mayo_TraceConcat_(a, b)
+#define Mayo_TraceScope(name) \
+            Mayo::TraceScope Mayo_TraceConcat(__Mayo_TraceScope, __LINE__)(name)
+
+#else
+
+#define Mayo_TraceScope(name)
+
+#endif // HAVE_MAYO_TRACE
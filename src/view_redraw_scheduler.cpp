@@ -0,0 +1,138 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "view_redraw_scheduler.h"
+
+#include "trace.h"
+
+#include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
+#include <V3d_Viewer.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Schedulers are only used from the GUI thread
+static std::unordered_map<const V3d_Viewer*, ViewRedrawScheduler*>& mapViewerScheduler()
+{
+    static std::unordered_map<const V3d_Viewer*, ViewRedrawScheduler*> map;
+    return map;
+}
+
+static int displayRefreshInterval()
+{
+    const QScreen* screen = QGuiApplication::primaryScreen();
+    const double refreshRate =
+            screen != nullptr && screen->refreshRate() > 1. ? screen->refreshRate() : 60.;
+    return static_cast<int>(std::floor(1000. / refreshRate));
+}
+
+} // namespace Internal
+
+ViewRedrawScheduler::ViewRedrawScheduler(const Handle_V3d_View& view, QObject* parent)
+    : QObject(parent),
+      m_view(view),
+      m_frameInterval(Internal::displayRefreshInterval())
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_timer, &QTimer::timeout, this, &ViewRedrawScheduler::redraw);
+    Internal::mapViewerScheduler().emplace(m_view->Viewer().get(), this);
+}
+
+ViewRedrawScheduler::~ViewRedrawScheduler()
+{
+    auto& mapViewerScheduler = Internal::mapViewerScheduler();
+    auto itFound = mapViewerScheduler.find(m_view->Viewer().get());
+    if (itFound != mapViewerScheduler.end() && itFound->second == this)
+        mapViewerScheduler.erase(itFound);
+}
+
+const Handle_V3d_View& ViewRedrawScheduler::v3dView() const
+{
+    return m_view;
+}
+
+void ViewRedrawScheduler::requestRedraw()
+{
+    ++m_frameStats.requestCount;
+    if (m_isRedrawPending)
+        return;
+
+    // Zero delay still lets the event loop process the queued events, so
+    // requests they make are merged into this frame
+    m_isRedrawPending = true;
+    const qint64 sinceLastFrame =
+            m_chronoLastFrame.isValid() ? m_chronoLastFrame.elapsed() : m_frameInterval;
+    m_timer.start(static_cast<int>(std::max<qint64>(0, m_frameInterval - sinceLastFrame)));
+}
+
+bool ViewRedrawScheduler::isRedrawPending() const
+{
+    return m_isRedrawPending;
+}
+
+void ViewRedrawScheduler::flush()
+{
+    if (m_isRedrawPending) {
+        m_timer.stop();
+        this->redraw();
+    }
+}
+
+int ViewRedrawScheduler::frameInterval() const
+{
+    return m_frameInterval;
+}
+
+const ViewRedrawScheduler::FrameStatistics& ViewRedrawScheduler::frameStatistics() const
+{
+    return m_frameStats;
+}
+
+void ViewRedrawScheduler::resetFrameStatistics()
+{
+    m_frameStats = FrameStatistics();
+}
+
+void ViewRedrawScheduler::requestViewerRedraw(const Handle_AIS_InteractiveContext& context)
+{
+    const auto& mapViewerScheduler = Internal::mapViewerScheduler();
+    auto itFound = mapViewerScheduler.find(context->CurrentViewer().get());
+    if (itFound != mapViewerScheduler.cend())
+        itFound->second->requestRedraw();
+    else
+        context->UpdateCurrentViewer();
+}
+
+void ViewRedrawScheduler::redraw()
+{
+    if (!m_isRedrawPending)
+        return;
+
+    Mayo_TraceScope("ViewRedrawScheduler::redraw");
+    m_isRedrawPending = false;
+    m_chronoLastFrame.start();
+    m_view->Redraw();
+    const double frameTime = m_chronoLastFrame.nsecsElapsed() / 1000000.;
+    ++m_frameStats.frameCount;
+    m_frameStats.lastFrameTime = frameTime;
+    m_frameStats.maxFrameTime = std::max(m_frameStats.maxFrameTime, frameTime);
+    m_frameStats.totalFrameTime += frameTime;
+    emit frameRendered(frameTime);
+}
+
+double ViewRedrawScheduler::FrameStatistics::averageFrameTime() const
+{
+    return this->frameCount > 0 ? this->totalFrameTime / this->frameCount : 0.;
+}
+
+} // namespace Mayo
@@ -0,0 +1,68 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <AIS_InteractiveContext.hxx>
+#include <V3d_View.hxx>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+namespace Mayo {
+
+//! Coalesces redraw requests of a V3d_View into at most one frame per
+//! display refresh
+//!
+//! Callers only mark the view dirty with requestRedraw(), the view is redrawn
+//! by the event loop once pending events(ie slider moves) are processed, and
+//! no sooner than one refresh interval after the previous frame
+class ViewRedrawScheduler : public QObject {
+    Q_OBJECT
+public:
+    struct FrameStatistics {
+        int requestCount = 0;
+        int frameCount = 0;
+        double lastFrameTime = 0.; // Milliseconds
+        double maxFrameTime = 0.; // Milliseconds
+        double totalFrameTime = 0.; // Milliseconds
+        double averageFrameTime() const;
+    };
+
+    ViewRedrawScheduler(const Handle_V3d_View& view, QObject* parent = nullptr);
+    ~ViewRedrawScheduler();
+
+    const Handle_V3d_View& v3dView() const;
+
+    void requestRedraw();
+    bool isRedrawPending() const;
+    // Redraws now if a request is pending
+    void flush();
+
+    int frameInterval() const; // Milliseconds
+
+    const FrameStatistics& frameStatistics() const;
+    void resetFrameStatistics();
+
+    // Requests redraw of the scheduler of the viewer of 'context', the viewer
+    // is updated immediately when it has no scheduler
+    static void requestViewerRedraw(const Handle_AIS_InteractiveContext& context);
+
+signals:
+    void frameRendered(double frameTime); // Milliseconds
+
+private:
+    void redraw();
+
+    Handle_V3d_View m_view;
+    QTimer m_timer;
+    QElapsedTimer m_chronoLastFrame; // Started at beginning of the last frame
+    int m_frameInterval = 0;
+    bool m_isRedrawPending = false;
+    FrameStatistics m_frameStats;
+};
+
+} // namespace Mayo
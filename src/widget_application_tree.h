@@ -11,11 +11,13 @@
 #include "xde_document_item.h"
 
 #include <QtWidgets/QWidget>
+#include <vector>
 class QItemSelection;
-class QTreeWidgetItem;
 
 namespace Mayo {
 
+class ApplicationTreeModel;
+
 class WidgetApplicationTree : public QWidget {
     Q_OBJECT
 public:
@@ -31,30 +33,14 @@ public:
     void setReferenceItemTextTemplate(const QString& textTemplate);
 
 private:
-    void onDocumentAdded(Document* doc);
-    void onDocumentErased(const Document* doc);
     void onDocumentItemAdded(DocumentItem* docItem);
-    void onDocumentItemPropertyChanged(
-            const DocumentItem* docItem, const Property* prop);
+    void onDocumentItemsAdded(const std::vector<DocumentItem*>& docItems);
 
-    void onTreeWidgetDocumentSelectionChanged(
+    void onTreeViewDocumentSelectionChanged(
             const QItemSelection &selected, const QItemSelection &deselected);
 
-    QTreeWidgetItem* loadDocumentItem(DocumentItem* docItem);
-    void guiBuildXdeTree(
-            QTreeWidgetItem* treeDocItem, XdeDocumentItem* xdeDocItem);
-
-    QTreeWidgetItem* findTreeItemDocument(const Document* doc) const;
-    QTreeWidgetItem* findTreeItemDocumentItem(const DocumentItem* docItem) const;
-
-    QString referenceItemText(
-            const XdeDocumentItem* xdeDocItem,
-            const TDF_Label& refLabel,
-            const TDF_Label& referredLabel) const;
-
     class Ui_WidgetApplicationTree* m_ui = nullptr;
-    bool m_isMergeXdeReferredShapeOn = true;
-    QString m_refItemTextTemplate;
+    ApplicationTreeModel* m_model = nullptr;
 };
 
 } // namespace Mayo
@@ -11,6 +11,7 @@
 #include "gpx_utils.h"
 #include "math_utils.h"
 #include "options.h"
+#include "view_redraw_scheduler.h"
 
 #include <algorithm>
 #include <Bnd_Box.hxx>
@@ -18,10 +19,11 @@
 
 namespace Mayo {
 
-WidgetClipPlanes::WidgetClipPlanes(const Handle_V3d_View& view3d, QWidget* parent)
+WidgetClipPlanes::WidgetClipPlanes(ViewRedrawScheduler* redrawScheduler, QWidget* parent)
     : QWidget(parent),
       m_ui(new Ui_WidgetClipPlanes),
-      m_view(view3d)
+      m_view(redrawScheduler->v3dView()),
+      m_redrawScheduler(redrawScheduler)
 {
     m_ui->setupUi(this);
 
@@ -60,14 +62,14 @@ WidgetClipPlanes::WidgetClipPlanes(const Handle_V3d_View& view3d, QWidget* paren
     QObject::connect(opts, &Options::clipPlaneCappingToggled, [=](bool on) {
         for (ClipPlaneData& data : m_vecClipPlaneData)
             data.gpx->SetCapping(on);
-        m_view->Redraw();
+        m_redrawScheduler->requestRedraw();
     });
     QObject::connect(
                 opts, &Options::clipPlaneCappingHatchChanged,
                 [=](Aspect_HatchStyle hatch) {
         for (ClipPlaneData& data : m_vecClipPlaneData)
             GpxUtils::Gpx3dClipPlane_setCappingHatch(data.gpx, hatch);
-        m_view->Redraw();
+        m_redrawScheduler->requestRedraw();
     });
 
     m_ui->widget_CustomDir->setVisible(false);
@@ -90,14 +92,14 @@ void WidgetClipPlanes::setRanges(const Bnd_Box &bndBox)
         if (isBndBoxVoid)
             data.ui.check_On->setChecked(false);
     }
-    m_view->Redraw();
+    m_redrawScheduler->requestRedraw();
 }
 
 void WidgetClipPlanes::setClippingOn(bool on)
 {
     for (ClipPlaneData& data : m_vecClipPlaneData)
         data.gpx->SetOn(on ? data.ui.check_On->isChecked() : false);
-    m_view->Redraw();
+    m_redrawScheduler->requestRedraw();
 }
 
 void WidgetClipPlanes::connectUi(ClipPlaneData* data)
@@ -112,7 +114,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
     QObject::connect(ui.check_On, &QCheckBox::clicked, [=](bool on) {
         ui.widget_Control->setEnabled(on);
         this->setPlaneOn(gpx, on);
-        m_view->Redraw();
+        m_redrawScheduler->requestRedraw();
     });
 
     if (data->ui.customXDirSpin() != nullptr) {
@@ -137,7 +139,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
         const double dPct = ui.spinValueToSliderValue(pos);
         posSlider->setValue(qRound(dPct));
         GpxUtils::Gpx3dClipPlane_setPosition(gpx, pos);
-        m_view->Redraw();
+        m_redrawScheduler->requestRedraw();
     });
 
     QObject::connect(posSlider, &QSlider::valueChanged, [=](int pct) {
@@ -145,14 +147,14 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
         QSignalBlocker sigBlock(posSpin); Q_UNUSED(sigBlock);
         posSpin->setValue(pos);
         GpxUtils::Gpx3dClipPlane_setPosition(gpx, pos);
-        m_view->Redraw();
+        m_redrawScheduler->requestRedraw();
     });
 
     QObject::connect(ui.inverseBtn(), &QAbstractButton::clicked, [=]{
         const gp_Dir invNormal = gpx->ToPlane().Axis().Direction().Reversed();
         GpxUtils::Gpx3dClipPlane_setNormal(gpx, invNormal);
         GpxUtils::Gpx3dClipPlane_setPosition(gpx, data->ui.posSpin()->value());
-        m_view->Redraw();
+        m_redrawScheduler->requestRedraw();
     });
 
     // Custom plane normal
@@ -170,7 +172,7 @@ void WidgetClipPlanes::connectUi(ClipPlaneData* data)
                 const auto bbc = BndBoxCoords::get(m_bndBox);
                 this->setPlaneRange(data, MathUtils::planeRange(bbc, normal));
                 GpxUtils::Gpx3dClipPlane_setNormal(gpx, normal);
-                m_view->Redraw();
+                m_redrawScheduler->requestRedraw();
             }
         });
     };
@@ -18,10 +18,13 @@ class QAbstractButton;
 
 namespace Mayo {
 
+class ViewRedrawScheduler;
+
+// Changes of clip planes request redraws to the scheduler of the view
 class WidgetClipPlanes : public QWidget {
     Q_OBJECT
 public:
-    WidgetClipPlanes(const Handle_V3d_View& view3d, QWidget* parent = nullptr);
+    WidgetClipPlanes(ViewRedrawScheduler* redrawScheduler, QWidget* parent = nullptr);
     ~WidgetClipPlanes();
 
     void setRanges(const Bnd_Box& box);
@@ -57,6 +60,7 @@ private:
 
     class Ui_WidgetClipPlanes* m_ui;
     Handle_V3d_View m_view;
+    ViewRedrawScheduler* m_redrawScheduler = nullptr;
     std::vector<ClipPlaneData> m_vecClipPlaneData;
     Bnd_Box m_bndBox;
 };
@@ -16,10 +16,15 @@
 #include "fougtools/qttools/gui/qwidget_utils.h"
 
 #include <QtGui/QPainter>
+#include <QtWidgets/QActionGroup>
 #include <QtWidgets/QBoxLayout>
+#include <QtWidgets/QMenu>
 
 #include <V3d_TypeOfOrientation.hxx>
 
+#include <tuple>
+#include <vector>
+
 namespace Mayo {
 
 namespace Internal {
@@ -74,7 +79,23 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget *parent)
       m_guiDoc(guiDoc),
       m_qtOccView(new WidgetOccView(guiDoc->v3dView(), this))
 {
+    m_qtOccView->setRedrawScheduler(guiDoc->redrawScheduler());
     m_controller = new QtOccViewController(m_qtOccView);
+    QObject::connect(
+                m_controller, &BaseV3dViewController::viewRotationStarted,
+                guiDoc, &GuiDocument::beginViewInteraction);
+    QObject::connect(
+                m_controller, &BaseV3dViewController::viewPanningStarted,
+                guiDoc, &GuiDocument::beginViewInteraction);
+    QObject::connect(
+                m_controller, &BaseV3dViewController::viewRotationEnded,
+                guiDoc, &GuiDocument::endViewInteraction);
+    QObject::connect(
+                m_controller, &BaseV3dViewController::viewPanningEnded,
+                guiDoc, &GuiDocument::endViewInteraction);
+    QObject::connect(
+                m_controller, &BaseV3dViewController::viewInteractionFrameRendered,
+                guiDoc, &GuiDocument::addViewInteractionFrame);
     auto layout = new QVBoxLayout;
     layout->setContentsMargins(0, 0, 0, 0);
     layout->addWidget(m_qtOccView);
@@ -90,6 +111,8 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget *parent)
     auto btnViewBottom = Internal::createViewBtn(this, "view_bottom", tr("Bottom"));
     auto btnEditClipPlanes = Internal::createViewBtn(this, "clipping", tr("Edit clip planes"));
     btnEditClipPlanes->setCheckable(true);
+    auto btnPickGranularity =
+            Internal::createViewBtn(this, "xde_simple_shape_16", tr("Picking granularity"));
     const int margin = Internal::widgetMargin;
     btnFitAll->move(margin, margin);
     qtgui::QWidgetUtils::moveWidgetRightTo(btnViewIso, btnFitAll, margin);
@@ -100,6 +123,7 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget *parent)
     qtgui::QWidgetUtils::moveWidgetRightTo(btnViewTop, btnViewRight, margin);
     qtgui::QWidgetUtils::moveWidgetRightTo(btnViewBottom, btnViewTop, margin);
     qtgui::QWidgetUtils::moveWidgetRightTo(btnEditClipPlanes, btnViewBottom, margin);
+    qtgui::QWidgetUtils::moveWidgetRightTo(btnPickGranularity, btnEditClipPlanes, margin);
 
     const Handle_V3d_View view3d = guiDoc->v3dView();
     Internal::connectViewProjBtn(btnViewIso, view3d, V3d_XposYnegZpos);
@@ -115,6 +139,9 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget *parent)
     QObject::connect(
                 btnEditClipPlanes, &ButtonFlat::clicked,
                 this, &WidgetGuiDocument::toggleWidgetClipPlanes);
+    QObject::connect(
+                btnPickGranularity, &ButtonFlat::clicked,
+                this, &WidgetGuiDocument::execMenuPickGranularity);
 
     m_firstBtnFrameRect = btnFitAll->frameGeometry();
 }
@@ -129,11 +156,41 @@ BaseV3dViewController *WidgetGuiDocument::controller() const
     return m_controller;
 }
 
+void WidgetGuiDocument::execMenuPickGranularity()
+{
+    auto menu = new QMenu(this);
+    auto group = new QActionGroup(menu);
+    group->setExclusive(true);
+    using Granularity = GuiDocument::PickGranularity;
+    using MenuData = std::tuple<QAction*, Granularity>;
+    const std::vector<MenuData> arrayMenuData = {
+        { new QAction(tr("Face"), menu), Granularity::Face },
+        { new QAction(tr("Edge"), menu), Granularity::Edge },
+        { new QAction(tr("Vertex"), menu), Granularity::Vertex }
+    };
+    for (const MenuData& menuData : arrayMenuData) {
+        QAction* action = std::get<0>(menuData);
+        action->setCheckable(true);
+        action->setChecked(std::get<1>(menuData) == m_guiDoc->pickGranularity());
+        group->addAction(action);
+        menu->addAction(action);
+    }
+
+    QObject::connect(group, &QActionGroup::triggered, [=](QAction* action){
+        for (const MenuData& menuData : arrayMenuData) {
+            if (std::get<0>(menuData) == action)
+                m_guiDoc->setPickGranularity(std::get<1>(menuData));
+        }
+    });
+
+    qtgui::QWidgetUtils::asyncMenuExec(menu);
+}
+
 void WidgetGuiDocument::toggleWidgetClipPlanes()
 {
     if (m_widgetClipPlanes == nullptr) {
         auto panel = new Internal::PanelView3d(this);
-        auto widget = new WidgetClipPlanes(m_guiDoc->v3dView(), panel);
+        auto widget = new WidgetClipPlanes(m_guiDoc->redrawScheduler(), panel);
         qtgui::QWidgetUtils::addContentsWidget(panel, widget);
         panel->show();
         panel->adjustSize();
@@ -24,6 +24,7 @@ public:
     BaseV3dViewController* controller() const;
 
 private:
+    void execMenuPickGranularity();
     void toggleWidgetClipPlanes();
 
     GuiDocument* m_guiDoc = nullptr;
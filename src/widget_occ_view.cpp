@@ -6,6 +6,7 @@
 
 #include "widget_occ_view.h"
 #include "occt_window.h"
+#include "view_redraw_scheduler.h"
 
 namespace Mayo {
 
@@ -27,6 +28,11 @@ const Handle_V3d_View &WidgetOccView::v3dView() const
     return m_view;
 }
 
+void WidgetOccView::setRedrawScheduler(ViewRedrawScheduler* scheduler)
+{
+    m_redrawScheduler = scheduler;
+}
+
 QPaintEngine* WidgetOccView::paintEngine() const
 {
     return nullptr;
@@ -45,7 +51,10 @@ void WidgetOccView::showEvent(QShowEvent*)
 
 void WidgetOccView::paintEvent(QPaintEvent*)
 {
-    m_view->Redraw();
+    if (m_redrawScheduler != nullptr)
+        m_redrawScheduler->requestRedraw();
+    else
+        m_view->Redraw();
 }
 
 void WidgetOccView::resizeEvent(QResizeEvent*)
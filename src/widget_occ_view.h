@@ -11,6 +11,8 @@
 
 namespace Mayo {
 
+class ViewRedrawScheduler;
+
 //! Qt wrapper around the V3d_View class
 //!
 //! WidgetOccView does not handle input devices interaction like keyboard and
@@ -22,6 +24,9 @@ public:
 
     const Handle_V3d_View& v3dView() const;
 
+    // When set, paint events only request a redraw to 'scheduler'
+    void setRedrawScheduler(ViewRedrawScheduler* scheduler);
+
     QPaintEngine* paintEngine() const override;
 
 protected:
@@ -31,6 +36,7 @@ protected:
 
 private:
     Handle_V3d_View m_view;
+    ViewRedrawScheduler* m_redrawScheduler = nullptr;
 };
 
 } // namespace Mayo
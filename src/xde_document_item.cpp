@@ -8,6 +8,7 @@
 
 #include "caf_utils.h"
 #include "string_utils.h"
+#include "trace.h"
 
 #include <Standard_GUID.hxx>
 #include <TDF_AttributeIterator.hxx>
@@ -16,6 +17,8 @@
 #include <XCAFDoc_DocumentTool.hxx>
 #include <XCAFDoc_Volume.hxx>
 
+#include <atomic>
+
 namespace Mayo {
 
 namespace Internal {
@@ -47,16 +50,28 @@ static void addValidationProperties(
     }
 }
 
+static quint64 nextXdeDocumentItemId()
+{
+    static std::atomic<quint64> lastId(0);
+    return ++lastId;
+}
+
 } // namespace Internal
 
 XdeDocumentItem::XdeDocumentItem(const Handle_TDocStd_Document &doc)
-    : m_cafDoc(doc),
+    : m_id(Internal::nextXdeDocumentItemId()),
+      m_cafDoc(doc),
       m_shapeTool(XCAFDoc_DocumentTool::ShapeTool(doc->Main())),
       m_colorTool(XCAFDoc_DocumentTool::ColorTool(doc->Main()))
 {
     this->rebuildAssemblyTree();
 }
 
+quint64 XdeDocumentItem::id() const
+{
+    return m_id;
+}
+
 const Handle_TDocStd_Document &XdeDocumentItem::cafDoc() const
 {
     return m_cafDoc;
@@ -74,9 +89,11 @@ const Handle_XCAFDoc_ColorTool &XdeDocumentItem::colorTool() const
 
 void XdeDocumentItem::rebuildAssemblyTree()
 {
+    Mayo_TraceScope("XdeDocumentItem::rebuildAssemblyTree");
     m_asmTree.clear();
+    m_vecAsmNodeAbsoluteLoc.clear();
     for (const TDF_Label& rootLabel : this->topLevelFreeShapes())
-        this->deepBuildAssemblyTree(0, rootLabel);
+        this->appendAssemblyNode(0, rootLabel);
 }
 
 const Tree<TDF_Label> &XdeDocumentItem::assemblyTree() const
@@ -84,6 +101,53 @@ const Tree<TDF_Label> &XdeDocumentItem::assemblyTree() const
     return m_asmTree;
 }
 
+bool XdeDocumentItem::hasAssemblyNodeChildren(AssemblyNodeId nodeId) const
+{
+    if (m_asmTree.isNodeFetched(nodeId))
+        return m_asmTree.nodeChildFirst(nodeId) != 0;
+
+    const TDF_Label& label = m_asmTree.nodeData(nodeId);
+    if (this->isShapeReference(label))
+        return true;
+    const bool isAssembly = this->isShapeAssembly(label);
+    const bool isSimple = !isAssembly && this->isShapeSimple(label);
+    if (isAssembly || isSimple) {
+        for (TDF_ChildIterator it(label); it.More(); it.Next()) {
+            const TDF_Label child = it.Value();
+            if (isAssembly ? this->isShapeComponent(child) : this->isShapeSub(child))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool XdeDocumentItem::canFetchAssemblyNodeChildren(AssemblyNodeId nodeId) const
+{
+    return nodeId != 0 && !m_asmTree.isNodeFetched(nodeId);
+}
+
+void XdeDocumentItem::fetchAssemblyNodeChildren(AssemblyNodeId nodeId)
+{
+    if (!this->canFetchAssemblyNodeChildren(nodeId))
+        return;
+
+    Mayo_TraceScope("XdeDocumentItem::fetchAssemblyNodeChildren");
+
+    const TDF_Label label = m_asmTree.nodeData(nodeId);
+    if (this->isShapeAssembly(label)) {
+        for (const TDF_Label& child : this->shapeComponents(label))
+            this->appendAssemblyNode(nodeId, child);
+    }
+    else if (this->isShapeSimple(label)) {
+        for (const TDF_Label& child : this->shapeSubs(label))
+            this->appendAssemblyNode(nodeId, child);
+    }
+    else if (this->isShapeReference(label)) {
+        this->appendAssemblyNode(nodeId, this->shapeReferred(label));
+    }
+    m_asmTree.setNodeFetched(nodeId);
+}
+
 bool XdeDocumentItem::isShape(const TDF_Label &lbl) const
 {
     return m_shapeTool->IsShape(lbl);
@@ -193,15 +257,24 @@ TDF_Label XdeDocumentItem::shapeReferred(const TDF_Label &lbl) const
 
 TopLoc_Location XdeDocumentItem::shapeAbsoluteLocation(AssemblyNodeId nodeId) const
 {
-    TopLoc_Location absoluteLoc;
-    AssemblyNodeId it = nodeId;
-    while (it != 0) {
-        const TDF_Label& nodeLabel = m_asmTree.nodeData(it);
-        const TopLoc_Location nodeLoc = m_shapeTool->GetLocation(nodeLabel);
-        absoluteLoc = nodeLoc * absoluteLoc;
-        it = m_asmTree.nodeParent(it);
-    }
-    return absoluteLoc;
+    return nodeId != 0 && nodeId <= m_vecAsmNodeAbsoluteLoc.size() ?
+                m_vecAsmNodeAbsoluteLoc[nodeId - 1] :
+                TopLoc_Location();
+}
+
+XdeDocumentItem::AssemblyNodeId XdeDocumentItem::appendAssemblyNode(
+        AssemblyNodeId parentId, const TDF_Label& label)
+{
+    const AssemblyNodeId nodeId = m_asmTree.appendChild(parentId, label);
+    // Parent location is already known, as nodes are appended top-down
+    const TopLoc_Location nodeLoc = m_shapeTool->GetLocation(label);
+    // Node ids start at 1 and are consecutive
+    Q_ASSERT(nodeId == m_vecAsmNodeAbsoluteLoc.size() + 1);
+    if (parentId != 0)
+        m_vecAsmNodeAbsoluteLoc.push_back(this->shapeAbsoluteLocation(parentId) * nodeLoc);
+    else
+        m_vecAsmNodeAbsoluteLoc.push_back(nodeLoc);
+    return nodeId;
 }
 
 XdeDocumentItem::ValidationProperties XdeDocumentItem::validationProperties(
@@ -238,27 +311,10 @@ const char *XdeDocumentItem::dynTypeName() const
     return XdeDocumentItem::TypeName;
 }
 
-void XdeDocumentItem::deepBuildAssemblyTree(
-        AssemblyNodeId parentNode, const TDF_Label &label)
-{
-    const AssemblyNodeId node = m_asmTree.appendChild(parentNode, label);
-    if (this->isShapeAssembly(label)) {
-        for (const TDF_Label& child : this->shapeComponents(label))
-            this->deepBuildAssemblyTree(node, child);
-    }
-    else if (this->isShapeSimple(label)) {
-        for (const TDF_Label& child : this->shapeSubs(label))
-            this->deepBuildAssemblyTree(node, child);
-    }
-    else if (this->isShapeReference(label)) {
-        const TDF_Label referred = this->shapeReferred(label);
-        this->deepBuildAssemblyTree(node, referred);
-    }
-}
-
 std::vector<HandleProperty> XdeDocumentItem::shapeProperties(
         const TDF_Label& label, ShapePropertiesOption opt) const
 {
+    Mayo_TraceScope("XdeDocumentItem::shapeProperties");
     std::vector<HandleProperty> vecHndProp;
     const auto hndStorage = HandleProperty::Owner;
 
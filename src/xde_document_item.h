@@ -40,13 +40,22 @@ public:
 
     XdeDocumentItem(const Handle_TDocStd_Document& doc);
 
+    // Unique within the application, not reused once the item is destroyed
+    quint64 id() const;
+
     const Handle_TDocStd_Document& cafDoc() const;
     const Handle_XCAFDoc_ShapeTool& shapeTool() const;
     const Handle_XCAFDoc_ColorTool& colorTool() const;
 
+    // Only the top-level free shapes are added to the assembly tree, children
+    // of a node are appended on demand with fetchAssemblyNodeChildren()
     void rebuildAssemblyTree();
     const Tree<TDF_Label>& assemblyTree() const;
 
+    bool hasAssemblyNodeChildren(AssemblyNodeId nodeId) const;
+    bool canFetchAssemblyNodeChildren(AssemblyNodeId nodeId) const;
+    void fetchAssemblyNodeChildren(AssemblyNodeId nodeId);
+
     template<typename LABEL_CONTAINER = std::vector<TDF_Label>>
     LABEL_CONTAINER topLevelFreeShapes() const;
 
@@ -72,6 +81,9 @@ public:
     bool hasShapeColor(const TDF_Label& lbl) const;
     Quantity_Color shapeColor(const TDF_Label& lbl) const;
 
+    // Absolute locations are computed top-down when nodes are appended to the
+    // assembly tree, so this is a plain lookup whatever the node depth
+    // Returned by value, the lookup table grows as nodes are fetched
     TopLoc_Location shapeAbsoluteLocation(AssemblyNodeId nodeId) const;
     TopLoc_Location shapeReferenceLocation(const TDF_Label& lbl) const;
     TDF_Label shapeReferred(const TDF_Label& lbl) const;
@@ -96,13 +108,14 @@ private:
         }
     }
 
-    void deepBuildAssemblyTree(
-            AssemblyNodeId parentNode, const TDF_Label& label);
+    AssemblyNodeId appendAssemblyNode(AssemblyNodeId parentId, const TDF_Label& label);
 
+    quint64 m_id;
     Handle_TDocStd_Document m_cafDoc;
     Handle_XCAFDoc_ShapeTool m_shapeTool;
     Handle_XCAFDoc_ColorTool m_colorTool;
     Tree<TDF_Label> m_asmTree;
+    std::vector<TopLoc_Location> m_vecAsmNodeAbsoluteLoc; // Indexed by node id - 1
 };
 
 struct XdeAssemblyNode {
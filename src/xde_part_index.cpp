@@ -0,0 +1,377 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "xde_part_index.h"
+
+#include "caf_utils.h"
+#include "trace.h"
+#include "xde_document_item.h"
+
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TDF_LabelSequence.hxx>
+#include <TDataStd_TreeNode.hxx>
+#include <TNaming_Builder.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <XCAFDoc.hxx>
+
+#include <unordered_set>
+#include <utility>
+
+namespace Mayo {
+
+namespace Internal {
+
+// Collects the shapes referred by assemblies, each one only once
+static void deepCollectParts(
+        const XdeDocumentItem* item,
+        const TDF_Label& label,
+        std::vector<TDF_Label>* ptrVecPart,
+        std::unordered_set<TDF_Label>* ptrSetVisited)
+{
+    if (!ptrSetVisited->insert(label).second)
+        return;
+    if (item->isShapeAssembly(label)) {
+        for (const TDF_Label& component : item->shapeComponents(label)) {
+            deepCollectParts(
+                        item, item->shapeReferred(component), ptrVecPart, ptrSetVisited);
+        }
+    }
+    else {
+        ptrVecPart->push_back(label);
+    }
+}
+
+static qint64 triangulationBytes(const TopoDS_Shape& shape)
+{
+    qint64 bytes = 0;
+    TopTools_IndexedMapOfShape mapFace;
+    TopExp::MapShapes(shape, TopAbs_FACE, mapFace);
+    for (int i = 1; i <= mapFace.Extent(); ++i) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& mesh =
+                BRep_Tool::Triangulation(TopoDS::Face(mapFace(i)), loc);
+        if (!mesh.IsNull()) {
+            bytes += mesh->NbNodes() * sizeof(gp_Pnt)
+                    + mesh->NbTriangles() * sizeof(Poly_Triangle);
+            if (mesh->HasUVNodes())
+                bytes += mesh->NbNodes() * sizeof(gp_Pnt2d);
+        }
+    }
+    return bytes;
+}
+
+// Components referring to 'label' can refer to 'targetLabel' instead without
+// any change of their geometry or appearance
+static bool canRedirectComponents(
+        const XdeDocumentItem* item, const TDF_Label& label, const TDF_Label& targetLabel)
+{
+    if (item->isShapeFree(label))
+        return false;
+
+    // Components keep the orientation of the referred shape but replace its
+    // own location
+    if (item->shape(label).Orientation() != item->shape(targetLabel).Orientation())
+        return false;
+
+    if (item->hasShapeColor(label) != item->hasShapeColor(targetLabel))
+        return false;
+
+    return !item->hasShapeColor(label)
+            || item->shapeColor(label) == item->shapeColor(targetLabel);
+}
+
+// XCAFDoc_ShapeTool::SetComponent() isn't available, this does what
+// XCAFDoc_ShapeTool::AddComponent() does for existing components
+static void redirectComponents(
+        const TDF_Label& label, const TDF_Label& targetLabel, const TopoDS_Shape& targetShape)
+{
+    TDF_LabelSequence seqComponent;
+    XCAFDoc_ShapeTool::GetUsers(label, seqComponent, Standard_False);
+    const Handle_TDataStd_TreeNode targetNode =
+            TDataStd_TreeNode::Set(targetLabel, XCAFDoc::ShapeRefGUID());
+    for (int i = 1; i <= seqComponent.Length(); ++i) {
+        const TDF_Label& component = seqComponent.Value(i);
+        const TopLoc_Location loc = XCAFDoc_ShapeTool::GetLocation(component);
+        TNaming_Builder builder(component);
+        builder.Generated(targetShape.Located(loc));
+        Handle_TDataStd_TreeNode refNode;
+        if (component.FindAttribute(XCAFDoc::ShapeRefGUID(), refNode)) {
+            refNode->Remove();
+            targetNode->Prepend(refNode);
+        }
+    }
+}
+
+} // namespace Internal
+
+XdePartIndex* XdePartIndex::instance()
+{
+    static XdePartIndex index;
+    return &index;
+}
+
+std::vector<XdePartIndex::Part> XdePartIndex::addParts(XdeDocumentItem* item)
+{
+    Mayo_TraceScope("XdePartIndex::addParts");
+    std::vector<TDF_Label> vecLabel;
+    std::unordered_set<TDF_Label> setVisited;
+    for (const TDF_Label& label : item->topLevelFreeShapes())
+        Internal::deepCollectParts(item, label, &vecLabel, &setVisited);
+
+    // OCAF data is only read by the calling thread, workers deal with shapes
+    // Parts having sub-shape labels keep their topology, these labels refer to it
+    std::vector<Part> vecPart(vecLabel.size());
+    std::vector<TopoDS_Shape> vecShape;
+    std::vector<bool> vecCanShare;
+    vecShape.reserve(vecLabel.size());
+    vecCanShare.reserve(vecLabel.size());
+    for (const TDF_Label& label : vecLabel) {
+        vecShape.push_back(item->shape(label));
+        vecCanShare.push_back(item->shapeSubs(label).empty());
+    }
+
+    std::vector<ShapeFingerprint> vecFingerprint(vecLabel.size());
+    OSD_Parallel::For(0, static_cast<int>(vecLabel.size()), [&](int i) {
+        if (!vecShape.at(i).IsNull()) {
+            vecFingerprint.at(i) =
+                    ShapeFingerprint::compute(vecShape.at(i), &vecPart.at(i).massProps);
+        }
+    });
+
+    // Parts having the fingerprint of an indexed part(or of a previous part of
+    // 'item') are candidate copies, checked in parallel out of the lock
+    struct Candidate {
+        size_t partIndex;
+        TopoDS_Shape shape; // Without location
+        ShapeFingerprint::MassProperties massProps;
+        bool isSame;
+    };
+    std::vector<Candidate> vecCandidate;
+    std::vector<int> vecPartCandidate(vecLabel.size(), -1);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unordered_map<ShapeFingerprint, size_t, ShapeFingerprint::Hasher> mapFirstPart;
+        for (size_t i = 0; i < vecLabel.size(); ++i) {
+            const TopoDS_Shape& shape = vecShape.at(i);
+            if (shape.IsNull() || !vecCanShare.at(i))
+                continue;
+
+            const ShapeFingerprint& fp = vecFingerprint.at(i);
+            auto itEntry = m_mapEntry.find(fp);
+            if (itEntry != m_mapEntry.end()) {
+                const Entry& entry = itEntry->second;
+                const bool canShare = entry.isPublished || entry.ownerId == item->id();
+                if (canShare && !entry.shape.IsPartner(shape)) {
+                    vecPartCandidate.at(i) = static_cast<int>(vecCandidate.size());
+                    vecCandidate.push_back({ i, entry.shape, entry.massProps, false });
+                }
+
+                continue;
+            }
+
+            auto itFirstPart = mapFirstPart.find(fp);
+            if (itFirstPart == mapFirstPart.end()) {
+                mapFirstPart.emplace(fp, i);
+            }
+            else {
+                const size_t iFirst = itFirstPart->second;
+                const TopoDS_Shape& firstShape = vecShape.at(iFirst);
+                if (!firstShape.IsPartner(shape)) {
+                    vecPartCandidate.at(i) = static_cast<int>(vecCandidate.size());
+                    const Candidate candidate = {
+                        i,
+                        firstShape.Located(TopLoc_Location()),
+                        vecPart.at(iFirst).massProps,
+                        false };
+                    vecCandidate.push_back(candidate);
+                }
+            }
+        }
+    }
+
+    OSD_Parallel::For(0, static_cast<int>(vecCandidate.size()), [&](int i) {
+        Candidate& candidate = vecCandidate.at(i);
+        candidate.isSame = ShapeFingerprint::isSameShape(
+                    vecShape.at(candidate.partIndex),
+                    vecPart.at(candidate.partIndex).massProps,
+                    candidate.shape,
+                    candidate.massProps);
+    });
+
+    // Copies are either redirected to the label of the item referring to the
+    // shared topology, or have their own label rewritten
+    struct Sharing {
+        size_t partIndex;
+        TopoDS_Shape sharedShape; // Without location
+        TDF_Label targetLabel; // Null if the label is rewritten
+    };
+    std::vector<Sharing> vecSharing;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < vecLabel.size(); ++i) {
+            Part& part = vecPart.at(i);
+            part.label = vecLabel.at(i);
+            part.isShared = false;
+            part.isSharedWithOtherItem = false;
+            const TopoDS_Shape& shape = vecShape.at(i);
+            if (shape.IsNull() || !vecCanShare.at(i))
+                continue;
+
+            const int iCandidate = vecPartCandidate.at(i);
+            if (iCandidate >= 0 && !vecCandidate.at(iCandidate).isSame)
+                continue;
+
+            const ShapeFingerprint& fp = vecFingerprint.at(i);
+            auto itEntry = m_mapEntry.find(fp);
+            if (itEntry == m_mapEntry.end()) {
+                // Either the first part with this fingerprint, or the entry
+                // of the candidate was removed meanwhile
+                Entry entry;
+                entry.shape = shape.Located(TopLoc_Location());
+                entry.massProps = part.massProps;
+                entry.ownerId = item->id();
+                entry.isPublished = false;
+                entry.triangulationBytes = 0;
+                entry.mapItemPart.emplace(item->id(), ItemPart{ part.label, 1 });
+                m_mapEntry.emplace(fp, std::move(entry));
+                continue;
+            }
+
+            // Entry may have been replaced since the candidate was checked
+            Entry& entry = itEntry->second;
+            if (iCandidate < 0 || !entry.shape.IsSame(vecCandidate.at(iCandidate).shape))
+                continue;
+
+            part.massProps = entry.massProps;
+            part.isShared = true;
+            part.isSharedWithOtherItem = entry.ownerId != item->id();
+            auto itItemPart = entry.mapItemPart.find(item->id());
+            if (itItemPart != entry.mapItemPart.end()) {
+                ItemPart& itemPart = itItemPart->second;
+                ++itemPart.copyCount;
+                vecSharing.push_back({ i, entry.shape, itemPart.label });
+            }
+            else {
+                entry.mapItemPart.emplace(item->id(), ItemPart{ part.label, 1 });
+                vecSharing.push_back({ i, entry.shape, TDF_Label() });
+            }
+        }
+    }
+
+    // Components are located copies of the referred shapes, assemblies have
+    // to be updated once parts are rewritten
+    std::vector<bool> vecIsRedirected(vecLabel.size(), false);
+    if (!vecSharing.empty()) {
+        Mayo_TraceScope("XdePartIndex::shareParts");
+        const Handle_XCAFDoc_ShapeTool& shapeTool = item->shapeTool();
+        for (const Sharing& sharing : vecSharing) {
+            const TDF_Label& label = vecLabel.at(sharing.partIndex);
+            const TopoDS_Shape& shape = vecShape.at(sharing.partIndex);
+            if (!sharing.targetLabel.IsNull()
+                    && Internal::canRedirectComponents(item, label, sharing.targetLabel))
+            {
+                Internal::redirectComponents(
+                            label, sharing.targetLabel, item->shape(sharing.targetLabel));
+                shapeTool->RemoveShape(label, Standard_False);
+                vecIsRedirected.at(sharing.partIndex) = true;
+            }
+            else {
+                const TopoDS_Shape sharedShape =
+                        sharing.sharedShape.Located(shape.Location())
+                        .Oriented(shape.Orientation());
+                shapeTool->SetShape(label, sharedShape);
+            }
+        }
+
+        shapeTool->UpdateAssemblies();
+        item->rebuildAssemblyTree();
+    }
+
+    std::vector<Part> vecResultPart;
+    vecResultPart.reserve(vecPart.size());
+    for (size_t i = 0; i < vecPart.size(); ++i) {
+        if (!vecIsRedirected.at(i))
+            vecResultPart.push_back(vecPart.at(i));
+    }
+
+    return vecResultPart;
+}
+
+void XdePartIndex::publishParts(const XdeDocumentItem* item)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& fpEntry : m_mapEntry) {
+        Entry& entry = fpEntry.second;
+        if (entry.ownerId == item->id() && !entry.isPublished) {
+            entry.isPublished = true;
+            entry.triangulationBytes = Internal::triangulationBytes(entry.shape);
+        }
+    }
+}
+
+void XdePartIndex::removeParts(const XdeDocumentItem* item)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_mapEntry.begin(); it != m_mapEntry.end(); ) {
+        Entry& entry = it->second;
+        entry.mapItemPart.erase(item->id());
+        if (entry.mapItemPart.empty()) {
+            it = m_mapEntry.erase(it);
+            continue;
+        }
+
+        // Other items hold the topology, which is already meshed if published
+        if (entry.ownerId == item->id())
+            entry.ownerId = entry.mapItemPart.cbegin()->first;
+
+        ++it;
+    }
+}
+
+bool XdePartIndex::hasParts(const XdeDocumentItem* item) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& fpEntry : m_mapEntry) {
+        if (fpEntry.second.mapItemPart.count(item->id()) != 0)
+            return true;
+    }
+
+    return false;
+}
+
+void XdePartIndex::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapEntry.clear();
+}
+
+XdePartIndex::Statistics XdePartIndex::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics stats;
+    for (const auto& fpEntry : m_mapEntry) {
+        const Entry& entry = fpEntry.second;
+        if (!entry.isPublished)
+            continue;
+
+        int copyCount = 0;
+        for (const auto& idItemPart : entry.mapItemPart)
+            copyCount += idItemPart.second.copyCount;
+
+        const int duplicateCount = copyCount - 1;
+        ++stats.partCount;
+        stats.duplicateCount += duplicateCount;
+        stats.savedBytes += duplicateCount * entry.triangulationBytes;
+    }
+
+    return stats;
+}
+
+} // namespace Mayo
@@ -0,0 +1,97 @@
+/****************************************************************************
+** Copyright (c) 2018, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "shape_fingerprint.h"
+
+#include <TDF_Label.hxx>
+#include <TopoDS_Shape.hxx>
+#include <QtCore/QtGlobal>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+class XdeDocumentItem;
+
+//! Application-wide index of the parts(simple shapes referred by assemblies)
+//! of imported XDE documents, keyed by their ShapeFingerprint
+//!
+//! Parts having the fingerprint of an already indexed part are candidate
+//! copies, confirmed by ShapeFingerprint::isSameShape(). Copies within a
+//! document become components referring to a single label, the label of a
+//! copy from another document is rewritten to refer to the topology of the
+//! indexed part. So triangulations are computed and stored once. Parts of
+//! other documents are only shared once published, ie when their meshing is
+//! done
+//!
+//! Topology is shared across documents, so are the triangulations of the
+//! faces. The parts of an item are meshed once by the import, with the
+//! deflection of the item that added them first. They must not be meshed
+//! again afterwards, whatever the item, see hasParts()
+//!
+//! Items are identified by XdeDocumentItem::id(), removeParts() has to be
+//! called before an item is destroyed. This is done by Document::eraseRootItem()
+//! and Application::eraseDocument()
+class XdePartIndex {
+public:
+    struct Part {
+        TDF_Label label;
+        ShapeFingerprint::MassProperties massProps; // Without own location of the shape
+        bool isShared; // Topology of the label was replaced by the one of a copy
+        bool isSharedWithOtherItem; // Copy is owned by another XdeDocumentItem
+    };
+
+    struct Statistics {
+        int partCount = 0; // Distinct published parts
+        int duplicateCount = 0; // Copies found and shared
+        qint64 savedBytes = 0; // Triangulation data not duplicated by copies
+    };
+
+    static XdePartIndex* instance();
+
+    // Fingerprints the parts of 'item' in parallel and shares copies, must be
+    // called before meshing of 'item'. Copies referred by components of
+    // 'item' are removed and not returned
+    std::vector<Part> addParts(XdeDocumentItem* item);
+    // Parts added by 'item' can then be shared by other items, 'item' must be
+    // meshed
+    void publishParts(const XdeDocumentItem* item);
+    // Parts owned by 'item' are handed over to other items sharing them,
+    // otherwise they are dropped
+    void removeParts(const XdeDocumentItem* item);
+    // Whether 'item' added parts, which then may be shared at any time
+    bool hasParts(const XdeDocumentItem* item) const;
+
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    XdePartIndex() = default;
+
+    struct ItemPart {
+        TDF_Label label; // Referred by the copies within the item
+        int copyCount;
+    };
+
+    struct Entry {
+        TopoDS_Shape shape; // Without location
+        ShapeFingerprint::MassProperties massProps;
+        quint64 ownerId; // XdeDocumentItem::id()
+        bool isPublished;
+        qint64 triangulationBytes; // Computed when published
+        std::unordered_map<quint64, ItemPart> mapItemPart; // Key is XdeDocumentItem::id()
+    };
+
+    std::unordered_map<ShapeFingerprint, Entry, ShapeFingerprint::Hasher> m_mapEntry;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace Mayo
@@ -7,13 +7,60 @@ QT += testlib
 
 HEADERS += \
     test.h \
+    ../src/caf_utils.h \
+    ../src/document.h \
+    ../src/document_item.h \
+    ../src/import_cache.h \
+    ../src/mesh_utils.h \
+    ../src/options.h \
+    ../src/property.h \
+    ../src/property_builtins.h \
+    ../src/property_enumeration.h \
     ../src/quantity.h \
+    ../src/shape_fingerprint.h \
+    ../src/stl_reader.h \
+    ../src/string_utils.h \
+    ../src/trace.h \
     ../src/unit.h \
     ../src/unit_system.h \
+    ../src/xde_document_item.h \
+    ../src/xde_part_index.h \
+    ../src/fougtools/occtools/qt_utils.h
 
 SOURCES += \
     test.cpp \
     main.cpp \
+    ../src/caf_utils.cpp \
+    ../src/document.cpp \
+    ../src/document_item.cpp \
+    ../src/import_cache.cpp \
+    ../src/mesh_utils.cpp \
+    ../src/options.cpp \
+    ../src/property.cpp \
+    ../src/property_builtins.cpp \
+    ../src/property_enumeration.cpp \
     ../src/quantity.cpp \
+    ../src/shape_fingerprint.cpp \
+    ../src/stl_reader.cpp \
+    ../src/string_utils.cpp \
+    ../src/trace.cpp \
     ../src/unit.cpp \
     ../src/unit_system.cpp \
+    ../src/xde_document_item.cpp \
+    ../src/xde_part_index.cpp \
+    ../src/fougtools/occtools/qt_utils.cpp
+
+include(../src/fougtools/qttools/task/qttools_task.pri)
+
+# OpenCascade
+isEmpty(CASCADE_ROOT):error(Variable CASCADE_ROOT is empty)
+include(../occ.pri)
+LIBS += -lTKernel -lTKMath -lTKTopAlgo -lTKV3d -lTKService
+LIBS += -lTKG2d -lTKG3d -lTKGeomBase
+LIBS += -lTKBRep -lTKPrim
+LIBS += -lTKLCAF -lTKXCAF -lTKCAF -lTKCDF
+LIBS += -lTKBin -lTKBinL -lTKBinXCAF
+
+OCCT_DEFINES = $$(CSF_DEFINES)
+DEFINES += $$split(OCCT_DEFINES, ;)
+DEFINES += OCCT_HANDLE_NOCAST
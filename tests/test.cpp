@@ -1,13 +1,38 @@
 #include "test.h"
 
+#include "../src/caf_utils.h"
+#include "../src/document.h"
+#include "../src/import_cache.h"
 #include "../src/libtree.h"
+#include "../src/mesh_utils.h"
+#include "../src/property_builtins.h"
+#include "../src/stl_reader.h"
 #include "../src/unit.h"
 #include "../src/unit_system.h"
+#include "../src/xde_document_item.h"
+#include "../src/xde_part_index.h"
+#include "../src/fougtools/qttools/task/work_stealing_pool.h"
 
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <TDF_LabelSequence.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QtDebug>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace Mayo {
 
@@ -21,11 +46,269 @@ static bool operator==(
             && std::abs(lhs.factor - rhs.factor) < 1e-6;
 }
 
+using StlFacet = std::array<std::array<float, 3>, 3>;
+
+// Writes binary STL file made of 'vecFacet', normals are null
+static bool writeStlBinaryFile(const QString& filepath, const std::vector<StlFacet>& vecFacet)
+{
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream.writeRawData(QByteArray(80, ' ').constData(), 80);
+    stream << static_cast<quint32>(vecFacet.size());
+    for (const StlFacet& facet : vecFacet) {
+        stream << 0.f << 0.f << 0.f;
+        for (const std::array<float, 3>& vertex : facet)
+            stream << vertex[0] << vertex[1] << vertex[2];
+        stream << static_cast<quint16>(0);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+static bool writeFile(const QString& filepath, const QByteArray& contents)
+{
+    QFile file(filepath);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+// Returns ASCII STL text of a facet, 'v1', 'v2' and 'v3' are the vertex coordinates text
+static QByteArray stlAsciiFacet(const QByteArray& v1, const QByteArray& v2, const QByteArray& v3)
+{
+    return "  facet normal 0 0 0\n"
+           "    outer loop\n"
+           "      vertex " + v1 + "\n"
+           "      vertex " + v2 + "\n"
+           "      vertex " + v3 + "\n"
+           "    endloop\n"
+           "  endfacet\n";
+}
+
+// Returns the coordinates of the vertices of triangle 'index'(starting at 1)
+static std::array<gp_Pnt, 3> triangleVertices(const Handle_Poly_Triangulation& mesh, int index)
+{
+    int n1, n2, n3;
+    mesh->Triangles().Value(index).Get(n1, n2, n3);
+    return {{ mesh->Nodes().Value(n1), mesh->Nodes().Value(n2), mesh->Nodes().Value(n3) }};
+}
+
 void Test::CafUtils_test()
 {
     // TODO Add CafUtils::labelTag() test for multi-threaded safety
 }
 
+void Test::ImportCache_test()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString cacheDirPath = tempDir.filePath("cache");
+    ImportCache* cache = ImportCache::instance();
+    const int entryCount = 2;
+    ImportCache::Key keys[entryCount];
+    for (int i = 0; i < entryCount; ++i) {
+        keys[i].contentHash = 0xcafe + i;
+        keys[i].fileSize = 1000 + i;
+        keys[i].lastModified = 0;
+        ImportCache::Entry entry;
+        entry.cafDoc = occ::CafUtils::createXdeDocument();
+        const TopoDS_Shape box = BRepPrimAPI_MakeBox(1. + i, 2., 3.);
+        XCAFDoc_DocumentTool::ShapeTool(entry.cafDoc->Main())->AddShape(box);
+        entry.volume = (1. + i) * 6.;
+        cache->insert(cacheDirPath, qint64(1) << 30, keys[i], entry, 1000);
+    }
+
+    // Concurrent lookups of different keys
+    {
+        ImportCache::Entry entries[entryCount];
+        bool founds[entryCount] = {};
+        std::vector<std::thread> vecThread;
+        for (int i = 0; i < entryCount; ++i) {
+            vecThread.emplace_back([&, i]{
+                founds[i] = cache->find(cacheDirPath, keys[i], &entries[i]);
+            });
+        }
+
+        for (std::thread& thread : vecThread)
+            thread.join();
+
+        for (int i = 0; i < entryCount; ++i) {
+            QVERIFY(founds[i]);
+            QVERIFY(!entries[i].cafDoc.IsNull());
+            QCOMPARE(entries[i].volume, (1. + i) * 6.);
+            TDF_LabelSequence seqFreeShape;
+            XCAFDoc_DocumentTool::ShapeTool(entries[i].cafDoc->Main())->GetFreeShapes(seqFreeShape);
+            QCOMPARE(seqFreeShape.Length(), 1);
+        }
+
+        const ImportCache::Statistics stats = cache->statistics(cacheDirPath);
+        QCOMPARE(stats.lookupCount, entryCount);
+        QCOMPARE(stats.hitCount, entryCount);
+    }
+
+    cache->clear(cacheDirPath);
+    QCOMPARE(cache->size(cacheDirPath), qint64(0));
+}
+
+// Returns triangulation made of 'nodes' and 'triangles'(node indices starting at 1)
+static Handle_Poly_Triangulation makeTriangulation(
+        const std::vector<gp_Pnt>& nodes, const std::vector<std::array<int, 3>>& triangles)
+{
+    Handle_Poly_Triangulation mesh =
+            new Poly_Triangulation(int(nodes.size()), int(triangles.size()), Standard_False);
+    for (size_t i = 0; i < nodes.size(); ++i)
+        mesh->ChangeNodes().SetValue(int(i) + 1, nodes.at(i));
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const std::array<int, 3>& t = triangles.at(i);
+        mesh->ChangeTriangles().SetValue(int(i) + 1, Poly_Triangle(t[0], t[1], t[2]));
+    }
+    return mesh;
+}
+
+static bool isEqual(const gp_Mat& lhs, const gp_Mat& rhs, double tol)
+{
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 3; ++col) {
+            if (std::abs(lhs.Value(row, col) - rhs.Value(row, col)) > tol)
+                return false;
+        }
+    }
+    return true;
+}
+
+void Test::MeshUtils_test()
+{
+    const double tol = 1e-12;
+    // Unit cube far from origin, triangles oriented outward
+    {
+        const gp_XYZ origin(100., -50., 20.);
+        std::vector<gp_Pnt> nodes;
+        for (int i = 0; i < 8; ++i)
+            nodes.emplace_back(origin + gp_XYZ(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+        const std::vector<std::array<int, 3>> triangles = {
+            {{ 1, 3, 4 }}, {{ 1, 4, 2 }}, // z = 0
+            {{ 5, 6, 8 }}, {{ 5, 8, 7 }}, // z = 1
+            {{ 1, 2, 6 }}, {{ 1, 6, 5 }}, // y = 0
+            {{ 3, 7, 8 }}, {{ 3, 8, 4 }}, // y = 1
+            {{ 1, 5, 7 }}, {{ 1, 7, 3 }}, // x = 0
+            {{ 2, 4, 8 }}, {{ 2, 8, 6 }}  // x = 1
+        };
+        const occ::MeshUtils::MassProperties props =
+                occ::MeshUtils::triangulationMassProperties(makeTriangulation(nodes, triangles));
+        QVERIFY(std::abs(props.area - 6.) < tol);
+        QVERIFY(std::abs(props.volume - 1.) < tol);
+        QVERIFY(props.centroid.IsEqual(gp_Pnt(origin + gp_XYZ(0.5, 0.5, 0.5)), tol));
+        // Ixx = Iyy = Izz = (1 + 1) / 12, no products of inertia
+        gp_Mat inertia;
+        inertia.SetDiagonal(1 / 6., 1 / 6., 1 / 6.);
+        QVERIFY(isEqual(props.inertia, inertia, tol));
+        QVERIFY(std::abs(props.boundingBox.CornerMin().Distance(gp_Pnt(origin))) < tol);
+    }
+
+    // Tetrahedron of the unit trihedron, triangles oriented outward then inward
+    {
+        const std::vector<gp_Pnt> nodes = {
+            gp_Pnt(0, 0, 0), gp_Pnt(1, 0, 0), gp_Pnt(0, 1, 0), gp_Pnt(0, 0, 1)
+        };
+        const std::vector<std::array<int, 3>> trianglesOutward = {
+            {{ 1, 3, 2 }}, {{ 1, 2, 4 }}, {{ 1, 4, 3 }}, {{ 2, 3, 4 }}
+        };
+        std::vector<std::array<int, 3>> trianglesInward = trianglesOutward;
+        for (std::array<int, 3>& t : trianglesInward)
+            std::swap(t[1], t[2]);
+
+        // Second moments at centroid : x^2 -> 1/60 - 1/96 = 1/160, xy -> 1/120 - 1/96 = -1/480
+        gp_Mat inertia;
+        inertia.SetRows(
+                    gp_XYZ(1 / 80., 1 / 480., 1 / 480.),
+                    gp_XYZ(1 / 480., 1 / 80., 1 / 480.),
+                    gp_XYZ(1 / 480., 1 / 480., 1 / 80.));
+        const double area = 1.5 + std::sqrt(3.) / 2.;
+        for (const bool isOutward : { true, false }) {
+            const occ::MeshUtils::MassProperties props =
+                    occ::MeshUtils::triangulationMassProperties(
+                        makeTriangulation(nodes, isOutward ? trianglesOutward : trianglesInward));
+            const double volumeSign = isOutward ? 1. : -1.;
+            QVERIFY(std::abs(props.area - area) < tol);
+            QVERIFY(std::abs(props.volume - volumeSign / 6.) < tol);
+            QVERIFY(props.centroid.IsEqual(gp_Pnt(0.25, 0.25, 0.25), tol));
+            QVERIFY(isEqual(props.inertia, inertia, tol));
+        }
+    }
+}
+
+// Records notifications of property changes
+class TestPropertyOwner : public PropertyOwner {
+public:
+    TestPropertyOwner()
+        : propertyInt(this, "int"),
+          propertyBool(this, "bool")
+    {}
+
+    PropertyInt propertyInt;
+    PropertyBool propertyBool;
+    std::vector<std::vector<Property*>> vecNotification;
+
+protected:
+    void onPropertyChanged(Property* prop) override {
+        this->vecNotification.push_back({ prop });
+    }
+
+    void onPropertiesChanged(const std::vector<Property*>& props) override {
+        this->vecNotification.push_back(props);
+    }
+};
+
+void Test::PropertyTransaction_test()
+{
+    // Without transaction
+    {
+        TestPropertyOwner owner;
+        owner.propertyInt.setValue(1);
+        owner.propertyInt.setValue(2);
+        QCOMPARE(owner.vecNotification.size(), size_t(2));
+    }
+
+    // Nested transactions, only the outermost commit notifies distinct changes
+    {
+        TestPropertyOwner owner;
+        owner.beginPropertyTransaction();
+        owner.propertyInt.setValue(1);
+        owner.beginPropertyTransaction();
+        owner.propertyBool.setValue(true);
+        owner.propertyInt.setValue(2);
+        owner.commitPropertyTransaction();
+        QVERIFY(owner.vecNotification.empty());
+        QVERIFY(owner.isPropertyTransactionActive());
+        owner.propertyInt.setValue(3);
+        owner.commitPropertyTransaction();
+        QVERIFY(!owner.isPropertyTransactionActive());
+        QCOMPARE(owner.vecNotification.size(), size_t(1));
+        const std::vector<Property*> vecExpected = { &owner.propertyInt, &owner.propertyBool };
+        QVERIFY(owner.vecNotification.front() == vecExpected);
+        QCOMPARE(owner.propertyInt.value(), 3);
+    }
+
+    // Transaction guard, nothing notified without change
+    {
+        TestPropertyOwner owner;
+        {
+            Mayo_PropertyTransaction(&owner);
+        }
+        QVERIFY(owner.vecNotification.empty());
+        {
+            Mayo_PropertyTransaction(&owner);
+            owner.propertyBool.setValue(true);
+            owner.propertyBool.setValue(false);
+        }
+        QCOMPARE(owner.vecNotification.size(), size_t(1));
+        QVERIFY(owner.vecNotification.front() == std::vector<Property*>{ &owner.propertyBool });
+    }
+}
+
 void Test::Quantity_test()
 {
     const QuantityArea area = (10 * Quantity_Millimeter) * (5 * Quantity_Centimeter);
@@ -68,6 +351,403 @@ void Test::LibTree_test()
     QCOMPARE(tree.nodeSiblingNext(n0_1_1), n0_1_2);
     QCOMPARE(tree.nodeSiblingPrevious(n0_1_2), n0_1_1);
     QCOMPARE(tree.nodeSiblingNext(n0_1_2), nullptrId);
+
+    QVERIFY(!tree.isNodeFetched(n0_2));
+    tree.setNodeFetched(n0_2);
+    QVERIFY(tree.isNodeFetched(n0_2));
+    const TreeNodeId n0_2_1 = tree.appendChild(n0_2, "0-2-1");
+    QCOMPARE(tree.nodeChildFirst(n0_2), n0_2_1);
+    QVERIFY(!tree.isNodeFetched(n0_2_1));
+
+    // Roots are linked as siblings
+    const TreeNodeId n1 = tree.appendChild(0, "1");
+    QCOMPARE(tree.nodeSiblingNext(n0), n1);
+    QCOMPARE(tree.nodeSiblingPrevious(n1), n0);
+
+    // Pre-order and post-order traversals
+    auto fnPreOrder = [&](TreeNodeId subtreeRootId) {
+        std::vector<std::string> vecData;
+        for (TreeIteratorPreOrder<std::string> it(&tree, subtreeRootId); !it.atEnd(); it.next())
+            vecData.push_back(tree.nodeData(it.current()));
+        return vecData;
+    };
+    auto fnPostOrder = [&](TreeNodeId subtreeRootId) {
+        std::vector<std::string> vecData;
+        for (TreeIteratorPostOrder<std::string> it(&tree, subtreeRootId); !it.atEnd(); it.next())
+            vecData.push_back(tree.nodeData(it.current()));
+        return vecData;
+    };
+    QVERIFY((fnPreOrder(0) == std::vector<std::string>{
+                 "0", "0-1", "0-1-1", "0-1-2", "0-2", "0-2-1", "1" }));
+    QVERIFY((fnPostOrder(0) == std::vector<std::string>{
+                 "0-1-1", "0-1-2", "0-1", "0-2-1", "0-2", "0", "1" }));
+    QVERIFY((fnPreOrder(n0_1) == std::vector<std::string>{ "0-1", "0-1-1", "0-1-2" }));
+    QVERIFY((fnPostOrder(n0_1) == std::vector<std::string>{ "0-1-1", "0-1-2", "0-1" }));
+    QVERIFY((fnPostOrder(n0_1_2) == std::vector<std::string>{ "0-1-2" }));
+
+    // Removal of a subtree
+    tree.removeSubtree(n0_1);
+    QCOMPARE(tree.nodeChildFirst(n0), n0_2);
+    QCOMPARE(tree.nodeSiblingPrevious(n0_2), nullptrId);
+    QCOMPARE(tree.nodeParent(n0_1_1), nullptrId);
+    QVERIFY(tree.nodeData(n0_1_2).empty());
+    QVERIFY((fnPreOrder(0) == std::vector<std::string>{ "0", "0-2", "0-2-1", "1" }));
+    tree.removeSubtree(n0);
+    QCOMPARE(tree.roots().size(), size_t(1));
+    QCOMPARE(tree.nodeSiblingPrevious(n1), nullptrId);
+    QVERIFY((fnPostOrder(0) == std::vector<std::string>{ "1" }));
+
+    // Several roots : linked as siblings in order of roots(), without parent.
+    // Traversal of a root subtree stops at this root
+    Tree<std::string> treeRoots;
+    const TreeNodeId r0 = treeRoots.appendChild(0, "r0");
+    const TreeNodeId r1 = treeRoots.appendChild(0, "r1");
+    const TreeNodeId r1_1 = treeRoots.appendChild(r1, "r1-1");
+    const TreeNodeId r2 = treeRoots.appendSubtree(0, std::string("r2"), [](const std::string& data) {
+        return data == "r2" ? std::vector<std::string>{ "r2-1" } : std::vector<std::string>();
+    });
+    QVERIFY((treeRoots.roots() == std::vector<TreeNodeId>{ r0, r1, r2 }));
+    QCOMPARE(treeRoots.nodeSiblingPrevious(r0), nullptrId);
+    QCOMPARE(treeRoots.nodeSiblingNext(r0), r1);
+    QCOMPARE(treeRoots.nodeSiblingPrevious(r1), r0);
+    QCOMPARE(treeRoots.nodeSiblingNext(r1), r2);
+    QCOMPARE(treeRoots.nodeSiblingPrevious(r2), r1);
+    QCOMPARE(treeRoots.nodeSiblingNext(r2), nullptrId);
+    QCOMPARE(treeRoots.nodeParent(r1), nullptrId);
+    QCOMPARE(treeRoots.nodeSiblingNext(r1_1), nullptrId);
+    std::vector<std::string> vecRootData;
+    for (TreeIteratorPreOrder<std::string> it(&treeRoots, r1); !it.atEnd(); it.next())
+        vecRootData.push_back(treeRoots.nodeData(it.current()));
+    QVERIFY((vecRootData == std::vector<std::string>{ "r1", "r1-1" }));
+    vecRootData.clear();
+    for (TreeIteratorPostOrder<std::string> it(&treeRoots, r1); !it.atEnd(); it.next())
+        vecRootData.push_back(treeRoots.nodeData(it.current()));
+    QVERIFY((vecRootData == std::vector<std::string>{ "r1-1", "r1" }));
+    vecRootData.clear();
+    for (TreeIteratorPreOrder<std::string> it(&treeRoots); !it.atEnd(); it.next())
+        vecRootData.push_back(treeRoots.nodeData(it.current()));
+    QVERIFY((vecRootData == std::vector<std::string>{ "r0", "r1", "r1-1", "r2", "r2-1" }));
+    treeRoots.removeSubtree(r1);
+    QVERIFY((treeRoots.roots() == std::vector<TreeNodeId>{ r0, r2 }));
+    QCOMPARE(treeRoots.nodeSiblingNext(r0), r2);
+    QCOMPARE(treeRoots.nodeSiblingPrevious(r2), r0);
+    treeRoots.removeSubtree(r0);
+    QCOMPARE(treeRoots.nodeSiblingPrevious(r2), nullptrId);
+
+    // Deep tree must not exhaust the stack
+    Tree<int> treeDeep;
+    const int deepNodeCount = 1000000;
+    TreeNodeId deepNodeId = 0;
+    for (int i = 0; i < deepNodeCount; ++i)
+        deepNodeId = treeDeep.appendChild(deepNodeId, i);
+    int deepPreOrderCount = 0;
+    deepForeachTreeNode(treeDeep, [&](TreeNodeId) { ++deepPreOrderCount; });
+    QCOMPARE(deepPreOrderCount, deepNodeCount);
+    TreeIteratorPostOrder<int> itDeep(&treeDeep);
+    QCOMPARE(treeDeep.nodeData(itDeep.current()), deepNodeCount - 1);
+
+    // Bulk build : each subtree is contiguous
+    Tree<int> treeBulk;
+    const TreeNodeId bulkRootId = treeBulk.appendSubtree(0, 3, [](int depth) {
+        return depth > 0 ? std::vector<int>(4, depth - 1) : std::vector<int>();
+    });
+    std::vector<TreeNodeId> vecBulkId;
+    deepForeachTreeNode(treeBulk, [&](TreeNodeId id) { vecBulkId.push_back(id); });
+    QCOMPARE(vecBulkId.size(), size_t(1 + 4 + 16 + 64));
+    for (size_t i = 0; i < vecBulkId.size(); ++i)
+        QCOMPARE(vecBulkId.at(i), static_cast<TreeNodeId>(bulkRootId + i));
+
+    // Parallel visitor
+    std::atomic<int> parallelCount(0);
+    parallelForeachTreeNode(0, treeDeep, [&](TreeNodeId) { ++parallelCount; });
+    QCOMPARE(parallelCount.load(), deepNodeCount);
+}
+
+void Test::StlReaderBinary_test()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filepath = tempDir.filePath("test.stl");
+    StlReader::Parameters paramsExact;
+    paramsExact.vertexWeld = StlReader::VertexWeld::ExactBits;
+    StlReader::Parameters paramsEpsilon;
+    paramsEpsilon.vertexWeld = StlReader::VertexWeld::Epsilon;
+    paramsEpsilon.weldEpsilon = 1e-3;
+
+    // No facet
+    {
+        QVERIFY(writeStlBinaryFile(filepath, {}));
+        QVERIFY(StlReader::isBinaryFile(filepath));
+        const StlReader::Result result = StlReader::read(filepath, paramsExact);
+        QVERIFY(!result.ok);
+        QVERIFY(result.solids.empty());
+    }
+
+    // Two facets sharing an edge, -0.f and +0.f are the same coordinate
+    {
+        const std::vector<StlFacet> vecFacet = {
+            StlFacet{{ {{ 0.f, 0.f, 0.f }}, {{ 1.f, 0.f, 0.f }}, {{ 0.f, 1.f, 0.f }} }},
+            StlFacet{{ {{ 1.f, -0.f, 0.f }}, {{ 1.f, 1.f, 0.f }}, {{ 0.f, 1.f, 0.f }} }}
+        };
+        QVERIFY(writeStlBinaryFile(filepath, vecFacet));
+        for (const StlReader::Parameters& params : { paramsExact, paramsEpsilon }) {
+            const StlReader::Result result = StlReader::read(filepath, params);
+            QVERIFY(result.ok);
+            QCOMPARE(result.solids.size(), size_t(1));
+            QCOMPARE(result.solids.front().mesh->NbNodes(), 4);
+            QCOMPARE(result.solids.front().mesh->NbTriangles(), 2);
+        }
+    }
+
+    // Shared edge slightly apart, only welded in the same grid cells
+    {
+        const std::vector<StlFacet> vecFacet = {
+            StlFacet{{ {{ 0.f, 0.f, 0.f }}, {{ 1.f, 0.f, 0.f }}, {{ 0.f, 1.f, 0.f }} }},
+            StlFacet{{ {{ 1.0001f, 0.f, 0.f }}, {{ 1.f, 1.f, 0.f }}, {{ 0.f, 1.0001f, 0.f }} }},
+            StlFacet{{ {{ 5.f, 5.f, 5.f }}, {{ 5.5f, 5.f, 5.f }}, {{ 5.f, 5.5f, 5.f }} }}
+        };
+        QVERIFY(writeStlBinaryFile(filepath, vecFacet));
+        const StlReader::Result resultExact = StlReader::read(filepath, paramsExact);
+        QVERIFY(resultExact.ok);
+        QCOMPARE(resultExact.solids.front().mesh->NbNodes(), 9);
+        const StlReader::Result resultEpsilon = StlReader::read(filepath, paramsEpsilon);
+        QVERIFY(resultEpsilon.ok);
+        QCOMPARE(resultEpsilon.solids.front().mesh->NbNodes(), 7);
+        QCOMPARE(resultEpsilon.solids.front().mesh->NbTriangles(), 3);
+    }
+}
+
+void Test::StlReaderAscii_test()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filepath = tempDir.filePath("test.stl");
+    const StlReader::Parameters params;
+
+    // Signs and exponents
+    {
+        const QByteArray contents =
+                "solid\n"
+                + stlAsciiFacet("-1.5e+2 +2E-1 3", "0.125E1 -0 1e-3", ".5 5. -7e0")
+                + "endsolid\n";
+        QVERIFY(writeFile(filepath, contents));
+        const StlReader::Result result = StlReader::readAscii(filepath, params);
+        QVERIFY(result.ok);
+        QCOMPARE(result.solids.size(), size_t(1));
+        QCOMPARE(result.solids.front().mesh->NbTriangles(), 1);
+        const std::array<gp_Pnt, 3> vertices =
+                triangleVertices(result.solids.front().mesh, 1);
+        QCOMPARE(float(vertices[0].X()), -150.f);
+        QCOMPARE(float(vertices[0].Y()), 0.2f);
+        QCOMPARE(float(vertices[0].Z()), 3.f);
+        QCOMPARE(float(vertices[1].X()), 1.25f);
+        QCOMPARE(float(vertices[1].Y()), 0.f);
+        QCOMPARE(float(vertices[1].Z()), 0.001f);
+        QCOMPARE(float(vertices[2].X()), 0.5f);
+        QCOMPARE(float(vertices[2].Y()), 5.f);
+        QCOMPARE(float(vertices[2].Z()), -7.f);
+    }
+
+    // Malformed tokens
+    {
+        const char* badTokens[] = { "abc", "1e", "1e+", "-", ".", "1.0.0", "1,5", "2x" };
+        for (const char* badToken : badTokens) {
+            const QByteArray badVertex = QByteArray("0 0 ") + badToken;
+            const QByteArray contents =
+                    "solid\n"
+                    + stlAsciiFacet("0 0 0", "1 0 0", badVertex)
+                    + "endsolid\n";
+            QVERIFY(writeFile(filepath, contents));
+            const StlReader::Result result = StlReader::readAscii(filepath, params);
+            QVERIFY2(!result.ok, badToken);
+            QVERIFY(result.solids.empty());
+        }
+    }
+
+    // Large file split into several chunks, their raw limits are moved to
+    // the next facet line so tokens mustn't be cut
+    {
+        const int facetCount = 20000;
+        auto fnVertexText = [](int i, int v) {
+            return QByteArray::number(i + 0.25 * v, 'e', 6) + ' '
+                    + QByteArray::number(-0.5 * i, 'e', 6) + ' '
+                    + QByteArray::number(v, 'e', 6);
+        };
+        QByteArray contents = "solid big\n";
+        for (int i = 0; i < facetCount; ++i)
+            contents += stlAsciiFacet(fnVertexText(i, 0), fnVertexText(i, 1), fnVertexText(i, 2));
+        contents += "endsolid big\n";
+        QVERIFY(contents.size() > (2 << 20));
+        QVERIFY(writeFile(filepath, contents));
+        const StlReader::Result result = StlReader::readAscii(filepath, params);
+        QVERIFY(result.ok);
+        QCOMPARE(result.solids.size(), size_t(1));
+        const Handle_Poly_Triangulation& mesh = result.solids.front().mesh;
+        QCOMPARE(mesh->NbTriangles(), facetCount);
+        QCOMPARE(mesh->NbNodes(), 3 * facetCount);
+        for (int i = 0; i < facetCount; ++i) {
+            const std::array<gp_Pnt, 3> vertices = triangleVertices(mesh, i + 1);
+            for (int v = 0; v < 3; ++v) {
+                const gp_Pnt expected(float(i + 0.25 * v), float(-0.5 * i), float(v));
+                if (!vertices[v].IsEqual(expected, 0.))
+                    QFAIL(qPrintable(QString("Wrong vertex %1 of facet %2").arg(v).arg(i)));
+            }
+        }
+    }
+
+    // Two solids
+    {
+        const QByteArray contents =
+                "solid a\n"
+                + stlAsciiFacet("0 0 0", "1 0 0", "0 1 0")
+                + "endsolid a\n"
+                "solid b\n"
+                + stlAsciiFacet("0 0 1", "1 0 1", "0 1 1")
+                + stlAsciiFacet("1 0 1", "1 1 1", "0 1 1")
+                + "endsolid b\n";
+        QVERIFY(writeFile(filepath, contents));
+        const StlReader::Result result = StlReader::readAscii(filepath, params);
+        QVERIFY(result.ok);
+        QCOMPARE(result.solids.size(), size_t(2));
+        QCOMPARE(result.solids.at(0).name, std::string("a"));
+        QCOMPARE(result.solids.at(0).mesh->NbTriangles(), 1);
+        QCOMPARE(result.solids.at(0).mesh->NbNodes(), 3);
+        QCOMPARE(result.solids.at(1).name, std::string("b"));
+        QCOMPARE(result.solids.at(1).mesh->NbTriangles(), 2);
+        QCOMPARE(result.solids.at(1).mesh->NbNodes(), 4);
+    }
+}
+
+void Test::XdePartIndex_test()
+{
+    // Item of a document made of a single box
+    auto fnNewBoxItem = []{
+        const Handle_TDocStd_Document cafDoc = occ::CafUtils::createXdeDocument();
+        const TopoDS_Shape box = BRepPrimAPI_MakeBox(10., 20., 30.);
+        XCAFDoc_DocumentTool::ShapeTool(cafDoc->Main())->AddShape(box);
+        return new XdeDocumentItem(cafDoc);
+    };
+
+    XdePartIndex* partIndex = XdePartIndex::instance();
+    partIndex->clear();
+    Document doc(nullptr);
+    XdeDocumentItem* item1 = fnNewBoxItem();
+    doc.addRootItem(item1);
+    const std::vector<XdePartIndex::Part> vecPart1 = partIndex->addParts(item1);
+    QCOMPARE(vecPart1.size(), size_t(1));
+    QVERIFY(!vecPart1.front().isShared);
+    partIndex->publishParts(item1);
+    QVERIFY(partIndex->hasParts(item1));
+
+    // Copy of the part in another item shares its topology
+    XdeDocumentItem* item2 = fnNewBoxItem();
+    doc.addRootItem(item2);
+    const std::vector<XdePartIndex::Part> vecPart2 = partIndex->addParts(item2);
+    QCOMPARE(vecPart2.size(), size_t(1));
+    QVERIFY(vecPart2.front().isSharedWithOtherItem);
+    QVERIFY(item2->shape(vecPart2.front().label).IsPartner(item1->shape(vecPart1.front().label)));
+    QCOMPARE(partIndex->statistics().duplicateCount, 1);
+
+    // Erased item hands its part over to the item sharing it
+    QVERIFY(doc.eraseRootItem(item1));
+    QCOMPARE(partIndex->statistics().duplicateCount, 0);
+    XdeDocumentItem* item3 = fnNewBoxItem();
+    doc.addRootItem(item3);
+    const std::vector<XdePartIndex::Part> vecPart3 = partIndex->addParts(item3);
+    QCOMPARE(vecPart3.size(), size_t(1));
+    QVERIFY(vecPart3.front().isSharedWithOtherItem);
+    QVERIFY(item3->shape(vecPart3.front().label).IsPartner(item2->shape(vecPart2.front().label)));
+
+    // Part is dropped once no item refers to it, imported again it's new
+    QVERIFY(doc.eraseRootItem(item2));
+    QVERIFY(doc.eraseRootItem(item3));
+    QCOMPARE(partIndex->statistics().partCount, 0);
+    XdeDocumentItem* item4 = fnNewBoxItem();
+    doc.addRootItem(item4);
+    const std::vector<XdePartIndex::Part> vecPart4 = partIndex->addParts(item4);
+    QCOMPARE(vecPart4.size(), size_t(1));
+    QVERIFY(!vecPart4.front().isShared);
+    QVERIFY(partIndex->hasParts(item4));
+    partIndex->clear();
+}
+
+void Test::WorkStealingPool_test()
+{
+    using Priority = qttask::WorkStealingPool::Priority;
+    // Jobs are run by worker threads, waits for them with a timeout so a
+    // regression fails instead of hanging
+    auto fnWaitUntil = [](const std::function<bool()>& fnCondition) {
+        QElapsedTimer chrono;
+        chrono.start();
+        while (!fnCondition() && chrono.elapsed() < 30000)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return fnCondition();
+    };
+
+    // Admission : pending jobs are admitted in submission order, Interactive
+    // ones before Batch ones
+    {
+        qttask::WorkStealingPool pool(4);
+        pool.setMemoryBudget(100);
+        std::atomic<bool> isGateOpen(false);
+        std::atomic<int> finishedCount(0);
+        std::mutex mutexOrder;
+        std::vector<int> vecOrder;
+        // Holds the whole budget until the gate is open
+        pool.submit([&]{
+            while (!isGateOpen)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++finishedCount;
+        }, Priority::Batch, 100);
+        // Cost of 60 admits a single job at a time
+        auto fnSubmitOrdered = [&](int id, Priority priority) {
+            pool.submit([&, id]{
+                {
+                    std::lock_guard<std::mutex> lock(mutexOrder); Q_UNUSED(lock);
+                    vecOrder.push_back(id);
+                }
+                ++finishedCount;
+            }, priority, 60);
+        };
+        for (int i = 0; i < 8; ++i)
+            fnSubmitOrdered(i, Priority::Batch);
+        fnSubmitOrdered(100, Priority::Interactive);
+        fnSubmitOrdered(101, Priority::Interactive);
+        QCOMPARE(pool.memoryInUse(), std::size_t(100));
+        isGateOpen = true;
+        QVERIFY(fnWaitUntil([&]{ return finishedCount == 11; }));
+        QVERIFY((vecOrder == std::vector<int>{ 100, 101, 0, 1, 2, 3, 4, 5, 6, 7 }));
+        QVERIFY(fnWaitUntil([&]{ return pool.memoryInUse() == 0; }));
+    }
+
+    // Completion under contention : several threads submit jobs of mixed
+    // priorities and costs, some jobs submit other jobs from the workers
+    {
+        qttask::WorkStealingPool pool(4);
+        pool.setMemoryBudget(1000);
+        const int submitterCount = 4;
+        const int jobCountPerSubmitter = 5000;
+        std::atomic<int> finishedCount(0);
+        std::vector<std::thread> vecSubmitter;
+        for (int i = 0; i < submitterCount; ++i) {
+            vecSubmitter.emplace_back([&]{
+                for (int j = 0; j < jobCountPerSubmitter; ++j) {
+                    const Priority priority = j % 3 == 0 ? Priority::Interactive : Priority::Batch;
+                    const std::size_t cost = j % 2 == 0 ? 0 : (j % 7) * 100;
+                    pool.submit([&, j]{
+                        if (j % 5 == 0)
+                            pool.submit([&]{ ++finishedCount; }, Priority::Batch, 50);
+                        ++finishedCount;
+                    }, priority, cost);
+                }
+            });
+        }
+        for (std::thread& submitter : vecSubmitter)
+            submitter.join();
+        const int expectedCount = submitterCount * (jobCountPerSubmitter + jobCountPerSubmitter / 5);
+        QVERIFY(fnWaitUntil([&]{ return finishedCount == expectedCount; }));
+        QVERIFY(fnWaitUntil([&]{ return pool.memoryInUse() == 0; }));
+    }
 }
 
 } // namespace Mayo
@@ -10,10 +10,19 @@ class Test : public QObject {
 
 private slots:
     void CafUtils_test();
+    void ImportCache_test();
+    void MeshUtils_test();
+    void PropertyTransaction_test();
     void Quantity_test();
     void UnitSystem_test();
 
     void LibTree_test();
+
+    void StlReaderBinary_test();
+    void StlReaderAscii_test();
+    void XdePartIndex_test();
+
+    void WorkStealingPool_test();
 };
 
 } // namespace Mayo